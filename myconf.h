@@ -190,6 +190,24 @@
 #define TCUSEPTHREAD   1
 #endif
 
+#if defined(_SYS_LINUX_) && !defined(_MYNOURING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define TCUSEURING     1
+#endif
+#endif
+#if !defined(TCUSEURING)
+#define TCUSEURING     0
+#endif
+
+#if defined(_SYS_LINUX_) && !defined(_MYNOMPOL) && defined(__has_include)
+#if __has_include(<linux/mempolicy.h>)
+#define TCUSEMPOL      1
+#endif
+#endif
+#if !defined(TCUSEMPOL)
+#define TCUSEMPOL      0
+#endif
+
 #if defined(_MYMICROYIELD)
 #define TCMICROYIELD   1
 #else
@@ -241,6 +259,16 @@
 #include <regex.h>
 #include <glob.h>
 
+#if TCUSEURING
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+
+#if TCUSEMPOL
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
 #if TCUSEPTHREAD
 #include <pthread.h>
 #if defined(_POSIX_PRIORITY_SCHEDULING)
@@ -42,6 +42,9 @@ static int tcadbmapreccmpdecimal(const TCLISTDATUM *a, const TCLISTDATUM *b);
 static int tcadbmapreccmpint32(const TCLISTDATUM *a, const TCLISTDATUM *b);
 static int tcadbmapreccmpint64(const TCLISTDATUM *a, const TCLISTDATUM *b);
 static int tcadbtdbqrygetout(const void *pkbuf, int pksiz, TCMAP *cols, void *op);
+static void tcadbdsaparams(const TCLIST *args, int start, int64_t *rp, int *pmaxp,
+                           int64_t *dmaxp, int64_t *usecp);
+static void tcadbdsaknnout(TCDSADB *dsadb, const TCLIST *keys, TCLIST *rv);
 
 
 
@@ -108,9 +111,17 @@ bool tcadbopen(TCADB *adb, const char *name){
   bool tdmode = false;
   bool tbmode = false;
   bool ttmode = false;
+  bool thmode = false;
+  bool tfmode = false;
+  bool temode = false;
   int32_t rcnum = -1;
   int64_t xmsiz = -1;
+  int64_t xmmax = -1;
   int32_t dfunit = -1;
+  int64_t bmax = -1;
+  int64_t bloom = -1;
+  int32_t iodepth = -1;
+  int mopts = -1;
   int32_t lmemb = -1;
   int32_t nmemb = -1;
   int32_t lcnum = -1;
@@ -150,12 +161,28 @@ bool tcadbopen(TCADB *adb, const char *name){
       if(strchr(pv, 'd') || strchr(pv, 'D')) tdmode = true;
       if(strchr(pv, 'b') || strchr(pv, 'B')) tbmode = true;
       if(strchr(pv, 't') || strchr(pv, 'T')) ttmode = true;
+      if(strchr(pv, 'h') || strchr(pv, 'H')) thmode = true;
+      if(strchr(pv, 'f') || strchr(pv, 'F')) tfmode = true;
+      if(strchr(pv, 'e') || strchr(pv, 'E')) temode = true;
     } else if(!tcstricmp(elem, "rcnum")){
       rcnum = tcatoix(pv);
     } else if(!tcstricmp(elem, "xmsiz")){
       xmsiz = tcatoix(pv);
+    } else if(!tcstricmp(elem, "xmmax")){
+      xmmax = tcatoix(pv);
     } else if(!tcstricmp(elem, "dfunit")){
       dfunit = tcatoix(pv);
+    } else if(!tcstricmp(elem, "bmax")){
+      bmax = tcatoix(pv);
+    } else if(!tcstricmp(elem, "bloom")){
+      bloom = tcatoix(pv);
+    } else if(!tcstricmp(elem, "iodepth")){
+      iodepth = tcatoix(pv);
+    } else if(!tcstricmp(elem, "mopts")){
+      mopts = 0;
+      if(strchr(pv, 'h') || strchr(pv, 'H')) mopts |= HDBMHUGE;
+      if(strchr(pv, 'm') || strchr(pv, 'M')) mopts |= HDBMMIRROR;
+      if(strchr(pv, 'i') || strchr(pv, 'I')) mopts |= HDBMINTERLEAVE;
     } else if(!tcstricmp(elem, "lmemb")){
       lmemb = tcatoix(pv);
     } else if(!tcstricmp(elem, "nmemb")){
@@ -209,10 +236,18 @@ bool tcadbopen(TCADB *adb, const char *name){
     if(tdmode) opts |= HDBTDEFLATE;
     if(tbmode) opts |= HDBTBZIP;
     if(ttmode) opts |= HDBTTCBS;
+    if(tfmode) opts |= HDBTFAST;
+    if(thmode) opts |= HDBTXHASH;
+    if(temode) opts |= HDBTTTL;
     tchdbtune(hdb, bnum, apow, fpow, opts);
     tchdbsetcache(hdb, rcnum);
     if(xmsiz >= 0) tchdbsetxmsiz(hdb, xmsiz);
+    if(xmmax > 0) tchdbsetxmmax(hdb, xmmax);
     if(dfunit >= 0) tchdbsetdfunit(hdb, dfunit);
+    if(bmax >= 0) tchdbsetbmax(hdb, bmax);
+    if(bloom >= 0) tchdbsetbloom(hdb, bloom);
+    if(iodepth >= 0) tchdbsetiodepth(hdb, iodepth);
+    if(mopts >= 0) tchdbsetmemopts(hdb, mopts);
     int omode = owmode ? HDBOWRITER : HDBOREADER;
     if(ocmode) omode |= HDBOCREAT;
     if(otmode) omode |= HDBOTRUNC;
@@ -235,6 +270,7 @@ bool tcadbopen(TCADB *adb, const char *name){
     if(tdmode) opts |= BDBTDEFLATE;
     if(tbmode) opts |= BDBTBZIP;
     if(ttmode) opts |= BDBTTCBS;
+    if(tfmode) opts |= BDBTFAST;
     tcbdbtune(bdb, lmemb, nmemb, bnum, apow, fpow, opts);
     tcbdbsetcache(bdb, lcnum, ncnum);
     if(xmsiz >= 0) tcbdbsetxmsiz(bdb, xmsiz);
@@ -281,10 +317,12 @@ bool tcadbopen(TCADB *adb, const char *name){
     if(tdmode) opts |= TDBTDEFLATE;
     if(tbmode) opts |= TDBTBZIP;
     if(ttmode) opts |= TDBTTCBS;
+    if(tfmode) opts |= TDBTFAST;
     tctdbtune(tdb, bnum, apow, fpow, opts);
     tctdbsetcache(tdb, rcnum, lcnum, ncnum);
     if(xmsiz >= 0) tctdbsetxmsiz(tdb, xmsiz);
     if(dfunit >= 0) tctdbsetdfunit(tdb, dfunit);
+    if(bloom >= 0) tctdbsetbloom(tdb, bloom);
     int omode = owmode ? TDBOWRITER : TDBOREADER;
     if(ocmode) omode |= TDBOCREAT;
     if(otmode) omode |= TDBOTRUNC;
@@ -321,6 +359,7 @@ bool tcadbopen(TCADB *adb, const char *name){
       if(tdmode) opts |= BDBTDEFLATE;
       if(tbmode) opts |= BDBTBZIP;
       if(ttmode) opts |= BDBTTCBS;
+      if(tfmode) opts |= BDBTFAST;
 
       tcdsadbtune(dsadb, dimnum, bnum, apow, fpow, opts);
 
@@ -330,6 +369,7 @@ bool tcadbopen(TCADB *adb, const char *name){
       */
       if(xmsiz >= 0) tcdsadbsetxmsiz(dsadb, xmsiz);
       if(dfunit >= 0) tcdsadbsetdfunit(dsadb, dfunit);
+      if(bloom >= 0) tcdsadbsetbloom(dsadb, bloom);
 
       int omode = owmode ? DSADBOWRITER : DSADBOREADER;
       if(ocmode) omode |= DSADBOCREAT;
@@ -1146,6 +1186,9 @@ bool tcadboptimize(TCADB *adb, const char *params){
   bool tdmode = false;
   bool tbmode = false;
   bool ttmode = false;
+  bool thmode = false;
+  bool tfmode = false;
+  bool temode = false;
   int32_t lmemb = -1;
   int32_t nmemb = -1;
   int32_t width = -1;
@@ -1173,6 +1216,9 @@ bool tcadboptimize(TCADB *adb, const char *params){
       if(strchr(pv, 'd') || strchr(pv, 'D')) tdmode = true;
       if(strchr(pv, 'b') || strchr(pv, 'B')) tbmode = true;
       if(strchr(pv, 't') || strchr(pv, 'T')) ttmode = true;
+      if(strchr(pv, 'h') || strchr(pv, 'H')) thmode = true;
+      if(strchr(pv, 'f') || strchr(pv, 'F')) tfmode = true;
+      if(strchr(pv, 'e') || strchr(pv, 'E')) temode = true;
     } else if(!tcstricmp(elem, "lmemb")){
       lmemb = tcatoix(pv);
     } else if(!tcstricmp(elem, "nmemb")){
@@ -1207,6 +1253,9 @@ bool tcadboptimize(TCADB *adb, const char *params){
       if(tdmode) opts |= HDBTDEFLATE;
       if(tbmode) opts |= HDBTBZIP;
       if(ttmode) opts |= HDBTTCBS;
+      if(tfmode) opts |= HDBTFAST;
+      if(thmode) opts |= HDBTXHASH;
+      if(temode) opts |= HDBTTTL;
     }
     if(!tchdboptimize(adb->hdb, bnum, apow, fpow, opts)) err = true;
     break;
@@ -1219,6 +1268,7 @@ bool tcadboptimize(TCADB *adb, const char *params){
       if(tdmode) opts |= BDBTDEFLATE;
       if(tbmode) opts |= BDBTBZIP;
       if(ttmode) opts |= BDBTTCBS;
+      if(tfmode) opts |= BDBTFAST;
     }
     if(!tcbdboptimize(adb->bdb, lmemb, nmemb, bnum, apow, fpow, opts)) err = true;
     break;
@@ -1234,9 +1284,22 @@ bool tcadboptimize(TCADB *adb, const char *params){
       if(tdmode) opts |= TDBTDEFLATE;
       if(tbmode) opts |= TDBTBZIP;
       if(ttmode) opts |= TDBTTCBS;
+      if(tfmode) opts |= TDBTFAST;
     }
     if(!tctdboptimize(adb->tdb, bnum, apow, fpow, opts)) err = true;
     break;
+  case ADBODSADB:
+    opts = 0;
+    if(tdefault){
+      opts = UINT8_MAX;
+    } else {
+      if(tdmode) opts |= DSADBTDEFLATE;
+      if(tbmode) opts |= DSADBTBZIP;
+      if(ttmode) opts |= DSADBTTCBS;
+      if(tfmode) opts |= DSADBTFAST;
+    }
+    if(!tcdsadboptimize(adb->dsadb, bnum, apow, fpow, opts)) err = true;
+    break;
   case ADBOSKEL:
     skel = adb->skel;
     if(skel->optimize){
@@ -1912,6 +1975,23 @@ TCLIST *tcadbmisc(TCADB *adb, const char *name, const TCLIST *args){
       } else {
         rv = NULL;
       }
+    } else if(!strcmp(name, "putttl")){
+      if(argc > 2){
+        rv = tclistnew2(1);
+        const char *kbuf;
+        int ksiz;
+        TCLISTVAL(kbuf, args, 0, ksiz);
+        const char *vbuf;
+        int vsiz;
+        TCLISTVAL(vbuf, args, 1, vsiz);
+        int64_t ttl = tcatoi(TCLISTVALPTR(args, 2));
+        if(!tchdbputttl(adb->hdb, kbuf, ksiz, vbuf, vsiz, ttl)){
+          tclistdel(rv);
+          rv = NULL;
+        }
+      } else {
+        rv = NULL;
+      }
     } else if(!strcmp(name, "out")){
       if(argc > 0){
         rv = tclistnew2(1);
@@ -1980,25 +2060,24 @@ TCLIST *tcadbmisc(TCADB *adb, const char *name, const TCLIST *args){
       }
     } else if(!strcmp(name, "getlist")){
       rv = tclistnew2(argc * 2);
-      bool err = false;
-      for(int i = 0; i < argc; i++){
-        const char *kbuf;
-        int ksiz;
-        TCLISTVAL(kbuf, args, i, ksiz);
-        int vsiz;
-        char *vbuf = tchdbget(adb->hdb, kbuf, ksiz, &vsiz);
-        if(vbuf){
-          TCLISTPUSH(rv, kbuf, ksiz);
-          TCLISTPUSH(rv, vbuf, vsiz);
-          TCFREE(vbuf);
-        } else if(tchdbecode(adb->hdb) != TCENOREC){
-          err = true;
+      TCMAP *recs = tcmapnew2(argc + 1);
+      if(tchdbgetmulti(adb->hdb, args, recs)){
+        for(int i = 0; i < argc; i++){
+          const char *kbuf;
+          int ksiz;
+          TCLISTVAL(kbuf, args, i, ksiz);
+          int vsiz;
+          const char *vbuf = tcmapget(recs, kbuf, ksiz, &vsiz);
+          if(vbuf){
+            TCLISTPUSH(rv, kbuf, ksiz);
+            TCLISTPUSH(rv, vbuf, vsiz);
+          }
         }
-      }
-      if(err){
+      } else {
         tclistdel(rv);
         rv = NULL;
       }
+      tcmapdel(recs);
     } else if(!strcmp(name, "iterinit")){
       rv = tclistnew2(1);
       bool err = false;
@@ -2776,6 +2855,170 @@ TCLIST *tcadbmisc(TCADB *adb, const char *name, const TCLIST *args){
       rv = NULL;
     }
     break;
+  case ADBODSADB:
+    if(!strcmp(name, "put")){
+      if(argc > 1){
+        rv = tclistnew2(1);
+        const char *kbuf;
+        int ksiz;
+        TCLISTVAL(kbuf, args, 0, ksiz);
+        const char *vbuf;
+        int vsiz;
+        TCLISTVAL(vbuf, args, 1, vsiz);
+        if(!tcdsadbput(adb->dsadb, kbuf, ksiz, vbuf, vsiz)){
+          tclistdel(rv);
+          rv = NULL;
+        }
+      } else {
+        rv = NULL;
+      }
+    } else if(!strcmp(name, "get")){
+      if(argc > 0){
+        rv = tclistnew2(1);
+        const char *kbuf;
+        int ksiz;
+        TCLISTVAL(kbuf, args, 0, ksiz);
+        int vsiz;
+        char *vbuf = tcdsadbget(adb->dsadb, (DSADBCORD *)kbuf, ksiz, &vsiz);
+        if(vbuf){
+          TCLISTPUSH(rv, vbuf, vsiz);
+          TCFREE(vbuf);
+        } else {
+          tclistdel(rv);
+          rv = NULL;
+        }
+      } else {
+        rv = NULL;
+      }
+    } else if(!strcmp(name, "putlist")){
+      rv = tclistnew2(1);
+      bool err = false;
+      argc--;
+      for(int i = 0; i < argc; i += 2){
+        const char *kbuf;
+        int ksiz;
+        TCLISTVAL(kbuf, args, i, ksiz);
+        int vsiz;
+        const char *vbuf = tclistval(args, i + 1, &vsiz);
+        if(!tcdsadbput(adb->dsadb, kbuf, ksiz, vbuf, vsiz)){
+          err = true;
+          break;
+        }
+      }
+      if(err){
+        tclistdel(rv);
+        rv = NULL;
+      }
+    } else if(!strcmp(name, "getlist")){
+      rv = tclistnew2(argc * 2);
+      for(int i = 0; i < argc; i++){
+        const char *kbuf;
+        int ksiz;
+        TCLISTVAL(kbuf, args, i, ksiz);
+        int vsiz;
+        char *vbuf = tcdsadbget(adb->dsadb, (DSADBCORD *)kbuf, ksiz, &vsiz);
+        if(vbuf){
+          TCLISTPUSH(rv, kbuf, ksiz);
+          TCLISTPUSH(rv, vbuf, vsiz);
+          TCFREE(vbuf);
+        }
+      }
+    } else if(!strcmp(name, "search")){
+      if(argc > 0){
+        const char *kbuf;
+        int ksiz;
+        TCLISTVAL(kbuf, args, 0, ksiz);
+        int64_t r, dmax, usec;
+        int pmax;
+        tcadbdsaparams(args, 1, &r, &pmax, &dmax, &usec);
+        bool exact;
+        int vsiz;
+        char *vbuf = tcdsadbsearch3(adb->dsadb, kbuf, ksiz, r, pmax, dmax, usec, &exact, &vsiz);
+        if(vbuf){
+          rv = tclistnew2(2);
+          TCLISTPUSH(rv, vbuf, vsiz);
+          TCLISTPUSH(rv, exact ? "1" : "0", 1);
+          TCFREE(vbuf);
+        } else {
+          rv = NULL;
+        }
+      } else {
+        rv = NULL;
+      }
+    } else if(!strcmp(name, "knn")){
+      if(argc > 1){
+        const char *kbuf;
+        int ksiz;
+        TCLISTVAL(kbuf, args, 0, ksiz);
+        int k = tcatoi(TCLISTVALPTR(args, 1));
+        int64_t r, dmax, usec;
+        int pmax;
+        tcadbdsaparams(args, 2, &r, &pmax, &dmax, &usec);
+        bool exact;
+        TCLIST *keys = tcdsadbknn(adb->dsadb, kbuf, ksiz, k, r, pmax, dmax, usec, &exact);
+        if(keys){
+          rv = tclistnew2(TCLISTNUM(keys) * 2 + 1);
+          TCLISTPUSH(rv, exact ? "1" : "0", 1);
+          tcadbdsaknnout(adb->dsadb, keys, rv);
+          tclistdel(keys);
+        } else {
+          rv = NULL;
+        }
+      } else {
+        rv = NULL;
+      }
+    } else if(!strcmp(name, "searchbatch") || !strcmp(name, "knnbatch")){
+      bool knn = !strcmp(name, "knnbatch");
+      int pidx = knn ? 2 : 1;
+      if(argc >= pidx && TCLISTVALSIZ(args, 0) % TCDSADBPSIZ == 0){
+        const char *qbuf;
+        int qsiz;
+        TCLISTVAL(qbuf, args, 0, qsiz);
+        int k = knn ? tcatoi(TCLISTVALPTR(args, 1)) : 1;
+        int64_t r, dmax, usec;
+        int pmax;
+        tcadbdsaparams(args, pidx, &r, &pmax, &dmax, &usec);
+        double deadline = usec > 0 ? tctime() + usec / 1000000.0 : 0;
+        int qnum = qsiz / TCDSADBPSIZ;
+        rv = tclistnew2(qnum * 3 + 1);
+        TCLISTPUSH(rv, "1", 1);
+        bool all = true;
+        for(int i = 0; i < qnum && rv; i++){
+          const char *kbuf = qbuf + i * TCDSADBPSIZ;
+          int64_t rest = 0;
+          if(deadline > 0){
+            rest = (deadline - tctime()) * 1000000;
+            if(rest < 1) rest = 1;
+          }
+          bool exact;
+          TCLIST *keys = tcdsadbknn(adb->dsadb, kbuf, TCDSADBPSIZ, k, r, pmax, dmax, rest, &exact);
+          if(!keys){
+            tclistdel(rv);
+            rv = NULL;
+            break;
+          }
+          if(!exact) all = false;
+          if(knn){
+            char numbuf[TCNUMBUFSIZ];
+            int nsiz = sprintf(numbuf, "%d", TCLISTNUM(keys));
+            TCLISTPUSH(rv, numbuf, nsiz);
+            tcadbdsaknnout(adb->dsadb, keys, rv);
+          } else if(TCLISTNUM(keys) > 0){
+            tcadbdsaknnout(adb->dsadb, keys, rv);
+          } else {
+            TCLISTPUSH(rv, "", 0);
+            TCLISTPUSH(rv, "", 0);
+          }
+          tclistdel(keys);
+        }
+        if(rv && !all) tclistover(rv, 0, "0", 1);
+      } else {
+        rv = NULL;
+      }
+    } else {
+      rv = NULL;
+    }
+    break;
   case ADBOSKEL:
     skel = adb->skel;
     if(skel->misc){
@@ -2954,6 +3197,14 @@ bool tcadbforeach(TCADB *adb, TCITER iter, void *op){
 }
 
 
+/* Process each record of an abstract database object with multiple threads. */
+bool tcadbforeach2(TCADB *adb, TCITER iter, void *op, int thnum){
+  assert(adb && iter);
+  if(adb->omode != ADBOHDB) return tcadbforeach(adb, iter, op);
+  return tchdbforeach2(adb->hdb, iter, op, thnum);
+}
+
+
 /* Map records of an abstract database object into another B+ tree database. */
 bool tcadbmapbdb(TCADB *adb, TCLIST *keys, TCBDB *bdb, ADBMAPPROC proc, void *op, int64_t csiz){
   assert(adb && bdb && proc);
@@ -3163,5 +3414,52 @@ static int tcadbtdbqrygetout(const void *pkbuf, int pksiz, TCMAP *cols, void *op
 }
 
 
+/* Parse the search parameters of a DSA tree database given to the misc function.
+   `args' specifies a list object containing arguments.
+   `start' specifies the index of the first parameter.
+   `rp' specifies the pointer to the variable into which the radius is assigned.
+   `pmaxp' specifies the pointer to the variable into which the page budget is assigned.
+   `dmaxp' specifies the pointer to the variable into which the distance budget is assigned.
+   `usecp' specifies the pointer to the variable into which the time budget is assigned.
+   Missing or empty parameters mean no limit. */
+static void tcadbdsaparams(const TCLIST *args, int start, int64_t *rp, int *pmaxp,
+                           int64_t *dmaxp, int64_t *usecp){
+  assert(args && start >= 0 && rp && pmaxp && dmaxp && usecp);
+  int64_t vals[4] = { -1, 0, 0, 0 };
+  int argc = TCLISTNUM(args);
+  for(int i = 0; i < 4 && start + i < argc; i++){
+    const char *str = TCLISTVALPTR(args, start + i);
+    if(*str != '\0') vals[i] = tcatoi(str);
+  }
+  *rp = vals[0];
+  *pmaxp = vals[1];
+  *dmaxp = vals[2];
+  *usecp = vals[3];
+}
+
+
+/* Add the records of the result of a nearest neighbor search to a list.
+   `dsadb' specifies the DSA tree database object.
+   `keys' specifies a list object of the keys found.
+   `rv' specifies a list object into which keys and values are added one after the other. */
+static void tcadbdsaknnout(TCDSADB *dsadb, const TCLIST *keys, TCLIST *rv){
+  assert(dsadb && keys && rv);
+  for(int i = 0; i < TCLISTNUM(keys); i++){
+    const char *kbuf;
+    int ksiz;
+    TCLISTVAL(kbuf, keys, i, ksiz);
+    int vsiz;
+    char *vbuf = tcdsadbget(dsadb, (DSADBCORD *)kbuf, ksiz, &vsiz);
+    TCLISTPUSH(rv, kbuf, ksiz);
+    if(vbuf){
+      TCLISTPUSH(rv, vbuf, vsiz);
+      TCFREE(vbuf);
+    } else {
+      TCLISTPUSH(rv, "", 0);
+    }
+  }
+}
+
+
 
 // END OF FILE
@@ -90,18 +90,28 @@ void tcadbdel(TCADB *adb);
    fails.  Tuning parameters can trail the name, separated by "#".  Each parameter is composed of
    the name and the value, separated by "=".  On-memory hash database supports "bnum", "capnum",
    and "capsiz".  On-memory tree database supports "capnum" and "capsiz".  Hash database supports
-   "mode", "bnum", "apow", "fpow", "opts", "rcnum", "xmsiz", and "dfunit".  B+ tree database
-   supports "mode", "lmemb", "nmemb", "bnum", "apow", "fpow", "opts", "lcnum", "ncnum", "xmsiz",
-   and "dfunit".  Fixed-length database supports "mode", "width", and "limsiz".  Table database
-   supports "mode", "bnum", "apow", "fpow", "opts", "rcnum", "lcnum", "ncnum", "xmsiz", "dfunit",
-   and "idx".
+   "mode", "bnum", "apow", "fpow", "opts", "rcnum", "xmsiz", "xmmax", "dfunit", "bmax",
+   "bloom", "iodepth", and "mopts".  B+ tree database supports "mode", "lmemb", "nmemb", "bnum",
+   "apow", "fpow", "opts", "lcnum", "ncnum", "xmsiz", and "dfunit".  Fixed-length database supports
+   "mode", "width", and "limsiz".  Table database supports "mode", "bnum", "apow", "fpow", "opts",
+   "rcnum", "lcnum", "ncnum", "xmsiz", "dfunit", "bloom", and "idx".
    If successful, the return value is true, else, it is false.
    The tuning parameter "capnum" specifies the capacity number of records.  "capsiz" specifies
    the capacity size of using memory.  Records spilled the capacity are removed by the storing
    order.  "mode" can contain "w" of writer, "r" of reader, "c" of creating, "t" of truncating,
    "e" of no locking, and "f" of non-blocking lock.  The default mode is relevant to "wc".
-   "opts" can contains "l" of large option, "d" of Deflate option, "b" of BZIP2 option, and "t"
-   of TCBS option.  "idx" specifies the column name of an index and its type separated by ":".
+   "opts" can contains "l" of large option, "d" of Deflate option, "b" of BZIP2 option, "t" of
+   TCBS option, "f" of LZ option, "h" of the word-at-a-time hash option of hash database, and
+   "e" of the expiration time option of hash database.
+   "bmax" specifies the maximum number of the bucket array of hash database which grows by
+   linear hashing.
+   "xmmax" specifies the maximum size of the mapped memory of hash database which grows with the
+   file.
+   "bloom" specifies the expected number of records of the Bloom filter for missing keys.
+   "iodepth" specifies the depth of the asynchronous I/O ring of hash database.
+   "mopts" can contain "h" of huge pages, "m" of the mirror of the bucket array, and "i" of NUMA
+   interleaving of hash database.
+   "idx" specifies the column name of an index and its type separated by ":".
    For example, "casket.tch#bnum=1000000#opts=ld" means that the name of the database file is
    "casket.tch", and the bucket number is 1000000, and the options are large and Deflate. */
 bool tcadbopen(TCADB *adb, const char *name);
@@ -412,7 +422,20 @@ uint64_t tcadbsize(TCADB *adb);
    of the values.  "putlist" is to store records.  It receives keys and values one after the
    other, and returns an empty list.  "outlist" is to remove records.  It receives keys, and
    returns an empty list.  "getlist" is to retrieve records.  It receives keys, and returns keys
-   and values of corresponding records one after the other.
+   and values of corresponding records one after the other.  The hash database also supports
+   "putttl".  It receives a key, a value, and the lifetime in seconds as a decimal string, stores a
+   record which expires after the lifetime, and returns an empty list.  The DSA tree database
+   supports "put", "get", "putlist", and "getlist", and also "search", "knn", "searchbatch", and
+   "knnbatch".  Their optional trailing parameters are the radius, the page budget, the distance
+   budget, and the time budget in microseconds, as decimal strings; a missing or empty one means no
+   limit.  "search" receives a point, and returns the value of the nearest record and "1" or "0" as
+   whether the result is exact.  "knn" receives a point and the number of records, and returns the
+   exactness flag followed by keys and values of the nearest records one after the other.
+   "searchbatch" receives points packed into one argument, and returns the exactness flag of the
+   whole batch followed by the key and the value of the nearest record of each point, which are
+   empty if no record is found.  "knnbatch" receives packed points and the number of records, and
+   returns the exactness flag followed by the number of records of each point and their keys and
+   values.  The time budget of the batch functions bounds the whole batch.
    `args' specifies a list object containing arguments.
    If successful, the return value is a list object of the result.  `NULL' is returned on failure.
    Because the object of the return value is created with the function `tclistnew', it
@@ -515,6 +538,20 @@ bool tcadbputproc(TCADB *adb, const void *kbuf, int ksiz, const void *vbuf, int
 bool tcadbforeach(TCADB *adb, TCITER iter, void *op);
 
 
+/* Process each record of an abstract database object with multiple threads.
+   `adb' specifies the abstract database object.
+   `iter' specifies the pointer to the iterator function called for each record.  It should be
+   thread-safe.
+   `op' specifies an arbitrary pointer to be given as a parameter of the iterator function.  If
+   it is not needed, `NULL' can be specified.
+   `thnum' specifies the number of threads.
+   If successful, the return value is true, else, it is false.
+   The record region of the hash database is split into ranges of roughly the same size and each
+   of them is processed by its own thread.  If the iterator function returns false, all threads
+   stop soon after.  The other databases are processed by `tcadbforeach'. */
+bool tcadbforeach2(TCADB *adb, TCITER iter, void *op, int thnum);
+
+
 /* Map records of an abstract database object into another B+ tree database.
    `adb' specifies the abstract database object.
    `keys' specifies a list object of the keys of the target records.  If it is `NULL', every
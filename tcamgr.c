@@ -41,6 +41,7 @@ static int runget(int argc, char **argv);
 static int runlist(int argc, char **argv);
 static int runoptimize(int argc, char **argv);
 static int runmisc(int argc, char **argv);
+static int runsearch(int argc, char **argv);
 static int runmap(int argc, char **argv);
 static int runversion(int argc, char **argv);
 static int proccreate(const char *name);
@@ -52,6 +53,8 @@ static int procget(const char *name, const char *kbuf, int ksiz, int sep, bool p
 static int proclist(const char *name, int sep, int max, bool pv, bool px, const char *fmstr);
 static int procoptimize(const char *name, const char *params);
 static int procmisc(const char *name, const char *func, const TCLIST *args, int sep, bool px);
+static int procsearch(const char *name, const char *kbuf, int ksiz, int knum, const char *rstr,
+                      const char *pstr, const char *dstr, const char *ustr, bool px);
 static int procmap(const char *name, const char *dest, const char *fmstr);
 static int procversion(void);
 
@@ -77,6 +80,8 @@ int main(int argc, char **argv){
     rv = runoptimize(argc, argv);
   } else if(!strcmp(argv[1], "misc")){
     rv = runmisc(argc, argv);
+  } else if(!strcmp(argv[1], "search") || !strcmp(argv[1], "knn")){
+    rv = runsearch(argc, argv);
   } else if(!strcmp(argv[1], "map")){
     rv = runmap(argc, argv);
   } else if(!strcmp(argv[1], "version") || !strcmp(argv[1], "--version")){
@@ -101,6 +106,10 @@ static void usage(void){
   fprintf(stderr, "  %s list [-sep chr] [-m num] [-pv] [-px] [-fm str] name\n", g_progname);
   fprintf(stderr, "  %s optimize name [params]\n", g_progname);
   fprintf(stderr, "  %s misc [-sx] [-sep chr] [-px] name func [arg...]\n", g_progname);
+  fprintf(stderr, "  %s search [-sx] [-px] [-pmax num] [-dmax num] [-usec num] name key [radius]\n",
+          g_progname);
+  fprintf(stderr, "  %s knn [-sx] [-px] [-pmax num] [-dmax num] [-usec num] name key num"
+          " [radius]\n", g_progname);
   fprintf(stderr, "  %s map [-fm str] name dest\n", g_progname);
   fprintf(stderr, "  %s version\n", g_progname);
   fprintf(stderr, "\n");
@@ -462,6 +471,67 @@ static int runmisc(int argc, char **argv){
 }
 
 
+/* parse arguments of search command */
+static int runsearch(int argc, char **argv){
+  bool knn = !strcmp(argv[1], "knn");
+  char *name = NULL;
+  char *key = NULL;
+  char *nstr = NULL;
+  char *rstr = NULL;
+  char *pstr = NULL;
+  char *dstr = NULL;
+  char *ustr = NULL;
+  bool sx = false;
+  bool px = false;
+  for(int i = 2; i < argc; i++){
+    if(!name && argv[i][0] == '-'){
+      if(!strcmp(argv[i], "-sx")){
+        sx = true;
+      } else if(!strcmp(argv[i], "-px")){
+        px = true;
+      } else if(!strcmp(argv[i], "-pmax")){
+        if(++i >= argc) usage();
+        pstr = argv[i];
+      } else if(!strcmp(argv[i], "-dmax")){
+        if(++i >= argc) usage();
+        dstr = argv[i];
+      } else if(!strcmp(argv[i], "-usec")){
+        if(++i >= argc) usage();
+        ustr = argv[i];
+      } else {
+        usage();
+      }
+    } else if(!name){
+      name = argv[i];
+    } else if(!key){
+      key = argv[i];
+    } else if(knn && !nstr){
+      nstr = argv[i];
+    } else if(!rstr){
+      rstr = argv[i];
+    } else {
+      usage();
+    }
+  }
+  if(!name || !key || (knn && !nstr)) usage();
+  int knum = knn ? tcatoi(nstr) : 0;
+  if(knn && knum < 1) usage();
+  int ksiz;
+  char *kbuf;
+  if(sx){
+    kbuf = tchexdecode(key, &ksiz);
+  } else {
+    ksiz = strlen(key);
+    kbuf = tcmemdup(key, ksiz);
+  }
+  name = tcsprintf("%s#mode=r", name);
+  int rv = procsearch(name, kbuf, ksiz, knum, rstr, pstr, dstr, ustr, px);
+  tcfree(name);
+  tcfree(kbuf);
+  return rv;
+}
+
+
 /* parse arguments of map command */
 static int runmap(int argc, char **argv){
   char *name = NULL;
@@ -764,6 +834,59 @@ static int procmisc(const char *name, const char *func, const TCLIST *args, int
 }
 
 
+/* perform search command */
+static int procsearch(const char *name, const char *kbuf, int ksiz, int knum, const char *rstr,
+                      const char *pstr, const char *dstr, const char *ustr, bool px){
+  TCADB *adb = tcadbnew();
+  if(!tcadbopen(adb, name)){
+    printerr(adb);
+    tcadbdel(adb);
+    return 1;
+  }
+  bool err = false;
+  TCLIST *args = tclistnew();
+  tclistpush(args, kbuf, ksiz);
+  if(knum > 0) tclistprintf(args, "%d", knum);
+  tclistpush2(args, rstr ? rstr : "");
+  tclistpush2(args, pstr ? pstr : "");
+  tclistpush2(args, dstr ? dstr : "");
+  tclistpush2(args, ustr ? ustr : "");
+  TCLIST *res = tcadbmisc(adb, knum > 0 ? "knn" : "search", args);
+  if(res){
+    int rnum = tclistnum(res);
+    if(knum > 0){
+      for(int i = 1; i < rnum - 1; i += 2){
+        int rsiz;
+        const char *rbuf = tclistval(res, i, &rsiz);
+        printdata(rbuf, rsiz, true, -1);
+        putchar('\t');
+        rbuf = tclistval(res, i + 1, &rsiz);
+        printdata(rbuf, rsiz, px, -1);
+        putchar('\n');
+      }
+      printf("exact: %s\n", rnum > 0 && !strcmp(tclistval2(res, 0), "1") ? "yes" : "no");
+    } else {
+      int rsiz;
+      const char *rbuf = tclistval(res, 0, &rsiz);
+      printdata(rbuf, rsiz, px, -1);
+      putchar('\n');
+      printf("exact: %s\n", !strcmp(tclistval2(res, 1), "1") ? "yes" : "no");
+    }
+    tclistdel(res);
+  } else {
+    printerr(adb);
+    err = true;
+  }
+  tclistdel(args);
+  if(!tcadbclose(adb)){
+    if(!err) printerr(adb);
+    err = true;
+  }
+  tcadbdel(adb);
+  return err ? 1 : 0;
+}
+
+
 /* perform map command */
 static int procmap(const char *name, const char *dest, const char *fmstr){
   TCADB *adb = tcadbnew();
@@ -1047,6 +1047,10 @@ static int procmisc(const char *name, int rnum){
     eprint(adb, __LINE__, "tcadbforeach");
     err = true;
   }
+  if(!tcadbforeach2(adb, iterfunc, NULL, 4)){
+    eprint(adb, __LINE__, "tcadbforeach2");
+    err = true;
+  }
   iprintf("record number: %llu\n", (unsigned long long)tcadbrnum(adb));
   iprintf("size: %llu\n", (unsigned long long)tcadbsize(adb));
   sysprint();
@@ -261,6 +261,7 @@ bool tcbdbtune(TCBDB *bdb, int32_t lmemb, int32_t nmemb,
   if(opts & BDBTDEFLATE) hopts |= HDBTDEFLATE;
   if(opts & BDBTBZIP) hopts |= HDBTBZIP;
   if(opts & BDBTTCBS) hopts |= HDBTTCBS;
+  if(opts & BDBTFAST) hopts |= HDBTFAST;
   if(opts & BDBTEXCODEC) hopts |= HDBTEXCODEC;
   bnum = (bnum > 0) ? bnum : BDBDEFBNUM;
   apow = (apow >= 0) ? apow : BDBDEFAPOW;
@@ -561,6 +562,47 @@ TCLIST *tcbdbget4(TCBDB *bdb, const void *kbuf, int ksiz){
 }
 
 
+/* Retrieve multiple records in a B+ tree database object at once. */
+bool tcbdbgetmulti(TCBDB *bdb, const TCLIST *keys, TCMAP *recs){
+  assert(bdb && keys && recs);
+  if(!BDBLOCKMETHOD(bdb, false)) return false;
+  if(!bdb->open){
+    tcbdbsetecode(bdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    BDBUNLOCKMETHOD(bdb);
+    return false;
+  }
+  TCTREE *sorted = tctreenew2(bdb->cmp, bdb->cmpop);
+  int knum = TCLISTNUM(keys);
+  for(int i = 0; i < knum; i++){
+    const char *kbuf;
+    int ksiz;
+    TCLISTVAL(kbuf, keys, i, ksiz);
+    tctreeputkeep(sorted, kbuf, ksiz, "", 0);
+  }
+  bool err = false;
+  tctreeiterinit(sorted);
+  const char *kbuf;
+  int ksiz;
+  while(!err && (kbuf = tctreeiternext(sorted, &ksiz)) != NULL){
+    int vsiz;
+    const char *vbuf = tcbdbgetimpl(bdb, kbuf, ksiz, &vsiz);
+    if(vbuf){
+      tcmapput(recs, kbuf, ksiz, vbuf, vsiz);
+    } else if(tcbdbecode(bdb) != TCENOREC){
+      err = true;
+    }
+  }
+  tctreedel(sorted);
+  bool adj = TCMAPRNUM(bdb->leafc) > bdb->lcnum || TCMAPRNUM(bdb->nodec) > bdb->ncnum;
+  BDBUNLOCKMETHOD(bdb);
+  if(adj && BDBLOCKMETHOD(bdb, true)){
+    if(!bdb->tran && !tcbdbcacheadjust(bdb)) err = true;
+    BDBUNLOCKMETHOD(bdb);
+  }
+  return !err;
+}
+
+
 /* Get the number of records corresponding a key in a B+ tree database object. */
 int tcbdbvnum(TCBDB *bdb, const void *kbuf, int ksiz){
   assert(bdb && kbuf && ksiz >= 0);
@@ -3002,6 +3044,7 @@ static bool tcbdbopenimpl(TCBDB *bdb, const char *path, int omode){
   if(hopts & HDBTDEFLATE) opts |= BDBTDEFLATE;
   if(hopts & HDBTBZIP) opts |= BDBTBZIP;
   if(hopts & HDBTTCBS) opts |= BDBTTCBS;
+  if(hopts & HDBTFAST) opts |= BDBTFAST;
   if(hopts & HDBTEXCODEC) opts |= BDBTEXCODEC;
   bdb->opts = opts;
   bdb->hleaf = 0;
@@ -88,7 +88,8 @@ enum {                                   /* enumeration for tuning options */
   BDBTDEFLATE = 1 << 1,                  /* compress each page with Deflate */
   BDBTBZIP = 1 << 2,                     /* compress each record with BZIP2 */
   BDBTTCBS = 1 << 3,                     /* compress each page with TCBS */
-  BDBTEXCODEC = 1 << 4                   /* compress each record with outer functions */
+  BDBTEXCODEC = 1 << 4,                  /* compress each record with outer functions */
+  BDBTFAST = 1 << 5                      /* compress each page with LZ */
 };
 
 enum {                                   /* enumeration for open modes */
@@ -191,7 +192,9 @@ bool tcbdbsetcmpfunc(TCBDB *bdb, TCCMP cmp, void *cmpop);
    `opts' specifies options by bitwise-or: `BDBTLARGE' specifies that the size of the database
    can be larger than 2GB by using 64-bit bucket array, `BDBTDEFLATE' specifies that each page
    is compressed with Deflate encoding, `BDBTBZIP' specifies that each page is compressed with
-   BZIP2 encoding, `BDBTTCBS' specifies that each page is compressed with TCBS encoding.
+   BZIP2 encoding, `BDBTTCBS' specifies that each page is compressed with TCBS encoding,
+   `BDBTFAST' specifies that each page is compressed with LZ encoding, which keeps the latency
+   of reading leaves low.
    If successful, the return value is true, else, it is false.
    Note that the tuning parameters should be set before the database is opened. */
 bool tcbdbtune(TCBDB *bdb, int32_t lmemb, int32_t nmemb,
@@ -422,6 +425,18 @@ const void *tcbdbget3(TCBDB *bdb, const void *kbuf, int ksiz, int *sp);
 TCLIST *tcbdbget4(TCBDB *bdb, const void *kbuf, int ksiz);
 
 
+/* Retrieve multiple records in a B+ tree database object at once.
+   `bdb' specifies the B+ tree database object.
+   `keys' specifies a list object of the keys.
+   `recs' specifies a map object into which the keys and the values of the corresponding records
+   are stored.  Keys with no corresponding record are ignored.
+   If successful, the return value is true, else, it is false.
+   If the key of duplicated records is specified, the first one is selected.  The keys are looked
+   up in the order of the comparison function while the method is locked only once, so that
+   neighboring keys are found in the same leaf. */
+bool tcbdbgetmulti(TCBDB *bdb, const TCLIST *keys, TCMAP *recs);
+
+
 /* Get the number of records corresponding a key in a B+ tree database object.
    `bdb' specifies the B+ tree database object.
    `kbuf' specifies the pointer to the region of the key.
@@ -563,8 +578,9 @@ bool tcbdbsync(TCBDB *bdb);
    `opts' specifies options by bitwise-or: `BDBTLARGE' specifies that the size of the database
    can be larger than 2GB by using 64-bit bucket array, `BDBTDEFLATE' specifies that each record
    is compressed with Deflate encoding, `BDBTBZIP' specifies that each page is compressed with
-   BZIP2 encoding, `BDBTTCBS' specifies that each page is compressed with TCBS encoding.  If it
-   is `UINT8_MAX', the current setting is not changed.
+   BZIP2 encoding, `BDBTTCBS' specifies that each page is compressed with TCBS encoding,
+   `BDBTFAST' specifies that each page is compressed with LZ encoding.  If it is `UINT8_MAX',
+   the current setting is not changed.
    If successful, the return value is true, else, it is false.
    This function is useful to reduce the size of the database file with data fragmentation by
    successive updating. */
@@ -108,21 +108,22 @@ static void usage(void){
   fprintf(stderr, "%s: test cases of the B+ tree database API of Tokyo Cabinet\n", g_progname);
   fprintf(stderr, "\n");
   fprintf(stderr, "usage:\n");
-  fprintf(stderr, "  %s write [-mt] [-cd|-ci|-cj] [-tl] [-td|-tb|-tt|-tx] [-lc num] [-nc num]"
+  fprintf(stderr, "  %s write [-mt] [-cd|-ci|-cj] [-tl] [-td|-tb|-tt|-tf|-tx] [-lc num] [-nc num]"
           " [-xm num] [-df num] [-ls num] [-ca num] [-nl|-nb] [-rnd] path rnum"
           " [lmemb [nmemb [bnum [apow [fpow]]]]]\n", g_progname);
   fprintf(stderr, "  %s read [-mt] [-cd|-ci|-cj] [-lc num] [-nc num] [-xm num] [-df num]"
           " [-nl|-nb] [-wb] [-rnd] path\n", g_progname);
   fprintf(stderr, "  %s remove [-mt] [-cd|-ci|-cj] [-lc num] [-nc num] [-xm num] [-df num]"
           " [-nl|-nb] [-rnd] path\n", g_progname);
-  fprintf(stderr, "  %s rcat [-mt] [-cd|-ci|-cj] [-tl] [-td|-tb|-tt|-tx] [-lc num] [-nc num]"
+  fprintf(stderr, "  %s rcat [-mt] [-cd|-ci|-cj] [-tl] [-td|-tb|-tt|-tf|-tx] [-lc num] [-nc num]"
           " [-xm num] [-df num] [-ls num] [-ca num] [-nl|-nb] [-pn num] [-dai|-dad|-rl|-ru]"
           " path rnum [lmemb [nmemb [bnum [apow [fpow]]]]]\n", g_progname);
-  fprintf(stderr, "  %s queue [-mt] [-cd|-ci|-cj] [-tl] [-td|-tb|-tt|-tx] [-lc num] [-nc num]"
+  fprintf(stderr, "  %s queue [-mt] [-cd|-ci|-cj] [-tl] [-td|-tb|-tt|-tf|-tx] [-lc num] [-nc num]"
           " [-xm num] [-df num] [-ls num] [-ca num] [-nl|-nb] path rnum"
           " [lmemb [nmemb [bnum [apow [fpow]]]]]\n", g_progname);
-  fprintf(stderr, "  %s misc [-mt] [-tl] [-td|-tb|-tt|-tx] [-nl|-nb] path rnum\n", g_progname);
-  fprintf(stderr, "  %s wicked [-mt] [-tl] [-td|-tb|-tt|-tx] [-nl|-nb] path rnum\n", g_progname);
+  fprintf(stderr, "  %s misc [-mt] [-tl] [-td|-tb|-tt|-tf|-tx] [-nl|-nb] path rnum\n", g_progname);
+  fprintf(stderr, "  %s wicked [-mt] [-tl] [-td|-tb|-tt|-tf|-tx] [-nl|-nb] path rnum\n",
+          g_progname);
   fprintf(stderr, "\n");
   exit(1);
 }
@@ -293,6 +294,8 @@ static int runwrite(int argc, char **argv){
         opts |= BDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= BDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= BDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= BDBTEXCODEC;
       } else if(!strcmp(argv[i], "-lc")){
@@ -507,6 +510,8 @@ static int runrcat(int argc, char **argv){
         opts |= BDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= BDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= BDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= BDBTEXCODEC;
       } else if(!strcmp(argv[i], "-lc")){
@@ -614,6 +619,8 @@ static int runqueue(int argc, char **argv){
         opts |= BDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= BDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= BDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= BDBTEXCODEC;
       } else if(!strcmp(argv[i], "-lc")){
@@ -692,6 +699,8 @@ static int runmisc(int argc, char **argv){
         opts |= BDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= BDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= BDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= BDBTEXCODEC;
       } else if(!strcmp(argv[i], "-nl")){
@@ -736,6 +745,8 @@ static int runwicked(int argc, char **argv){
         opts |= BDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= BDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= BDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= BDBTEXCODEC;
       } else if(!strcmp(argv[i], "-nl")){
@@ -1713,6 +1724,41 @@ static int procmisc(const char *path, int rnum, bool mt, int opts, int omode){
       if(i == rnum || i % (rnum / 10) == 0) iprintf(" (%08d)\n", i);
     }
   }
+  iprintf("multiple reading:\n");
+  for(int i = 1; !err && i <= rnum; i += 100){
+    TCLIST *keys = tclistnew();
+    for(int j = i + 99; j >= i; j--){
+      char kbuf[RECBUFSIZ];
+      int ksiz = sprintf(kbuf, "%08d", j);
+      tclistpush(keys, kbuf, ksiz);
+    }
+    tclistpush2(keys, "[missing]");
+    TCMAP *recs = tcmapnew();
+    if(!tcbdbgetmulti(bdb, keys, recs)){
+      eprint(bdb, __LINE__, "tcbdbgetmulti");
+      err = true;
+    } else if(tcmaprnum(recs) != tclmin(100, rnum - i + 1)){
+      eprint(bdb, __LINE__, "(validation)");
+      err = true;
+    } else {
+      tcmapiterinit(recs);
+      const char *kbuf;
+      int ksiz;
+      while((kbuf = tcmapiternext(recs, &ksiz)) != NULL){
+        int vsiz;
+        const char *vbuf = tcmapiterval(kbuf, &vsiz);
+        if(vsiz != ksiz || memcmp(vbuf, kbuf, vsiz)){
+          eprint(bdb, __LINE__, "(validation)");
+          err = true;
+          break;
+        }
+      }
+    }
+    tcmapdel(recs);
+    tclistdel(keys);
+    if(rnum > 250) iputchar('.');
+  }
+  if(rnum > 250) iprintf(" (%08d)\n", rnum);
   iprintf("checking words:\n");
   for(int i = 0; words[i] != NULL; i += 2){
     const char *kbuf = words[i];
@@ -19,6 +19,9 @@
 #define DSADBDEFDIMENSION     81                /* max dimenstion of one node */
 
 #define DSADBCACHEOUT         64                /* number of pages in a process of cacheout  */
+#define DSADBPREFETCHMAX      64                /* maximum number of pages in a prefetch */
+#define DSADBOPTSAMPLE        256               /* number of root candidates in optimization */
+#define DSADBCOSTSAMPLE       128               /* number of queries to measure search cost */
 
 #define DSDDBDEFARITY         20                /* default number of maxarity */
 
@@ -53,6 +56,18 @@ typedef struct {
     DSADBNODE nodes[];
 } DSADBPAGE; /* Page structure */
 
+typedef struct {
+    int64_t lb;                      /* lower bound of the distance */
+    uint64_t pid;                    /* page ID of the node */
+    uint64_t offset;                 /* offset of the node in the page */
+    uint64_t t;                      /* time stamp bound of the subtree */
+} DSADBQENT; /* Entry of the queue of best-first search */
+
+typedef struct {
+    int64_t dist;                    /* distance from the query */
+    DSADBCORD point[DSADBDEFDIMENSION];
+} DSADBANS; /* Answer of best-first search */
+
 enum { /* enumeration for duplication behavior */
     DSADBPDOVER,     /* overwrite an existing value */
     DSADBPDKEEP,     /* keep the existing value */
@@ -86,11 +101,13 @@ static bool tcdsadbunlockcache(TCDSADB *dsadb);
 bool tcdsadbsetmutex(TCDSADB *dsadb);
 bool tcdsadbsetxmsiz(TCDSADB *dsadb, int64_t xmsiz);
 bool tcdsadbsetdfunit(TCDSADB *dsadb, int32_t dfunit);
+bool tcdsadbsetbloom(TCDSADB *dsadb, int64_t bfnum);
 bool tcdsadbmemsync(TCDSADB *dsadb, bool phys);
 bool tcdsadbsync(TCDSADB *dsadb);
 static void tcdsadbdumpmeta(TCDSADB *dsadb);
 bool tcdsadbtune(TCDSADB *dsadb, int32_t dimnum, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts);
 bool tcdsadbsetcache(TCDSADB *dsadb, int32_t pcnum, int32_t ncnum);
+bool tcdsadbsetprefetch(TCDSADB *dsadb, bool prefetch);
 static bool tcdsadbpagecacheout(TCDSADB *dsadb, DSADBPAGE *page);
 static bool tcdsadbcacheadjust(TCDSADB *dsadb);
 static DSADBNODE *tcdsadbnodeload(DSADBPAGE *page, int index);
@@ -101,16 +118,27 @@ static bool tcdsadbpagesave(TCDSADB *dsadb, DSADBPAGE *page);
 static DSADBPAGE *tcdsadbpageload(TCDSADB *dsadb, uint64_t id);
 void *tcdsadbgetimpl(TCDSADB *dsadb, const DSADBCORD *kbuf, uint64_t ksiz, int *sp);
 static bool tcdsadbnodecheck(TCDSADB *dsadb, const DSADBCORD *kbuf, uint64_t ksiz);
+static void tcdsadbprefetchchildren(TCDSADB *dsadb, DSADBPAGE *page, const DSADBNODE *elem,
+        const DSADBCORD *kbuf, int64_t r, time_t t);
 static const DSADBNODE *tcdsadbrangesearch(TCDSADB *dsadb, DSADBNODE *elem,
-        const void *kbuf, int64_t ksiz, int64_t r, time_t t);
+        const void *kbuf, int64_t ksiz, int64_t r, time_t t, uint64_t pid);
 static const DSADBNODE *tcdsadbsearchimpl(TCDSADB *dsadb, const DSADBCORD *kbuf,
         int64_t ksiz, int64_t r, int *sp);
+static void tcdsadbqueuepush(DSADBQENT **queue, int *qnum, int *qanum, const DSADBQENT *ent);
+static void tcdsadbqueuepop(DSADBQENT *queue, int *qnum, DSADBQENT *ent);
+static void tcdsadbansadd(DSADBANS *ans, int *anum, int k, const DSADBNODE *node, int64_t dist);
+static int tcdsadbknnimpl(TCDSADB *dsadb, const DSADBCORD *kbuf, int k, int64_t r,
+        int pmax, int64_t dmax, int64_t usec, DSADBANS *ans, bool *exact);
 static int tcdsadbinsertnode(DSADBPAGE *page,DSADBNODE *node);
 static bool tcdsadbputimpl(TCDSADB *dsadb, const void *kbuf, int ksiz,
         const void *vbuf, int vsiz, int dmode);
 static bool tcdsadbopenimpl(TCDSADB *dsadb, const char *path, int omode);
 static void tcdsadbclear(TCDSADB *dsadb);
 static bool tcdsadbcloseimpl(TCDSADB *dsadb);
+static TCLIST *tcdsadbpoints(TCDSADB *dsadb);
+static TCLIST *tcdsadbsample(const TCLIST *points, int num);
+static double tcdsadbsearchcostimpl(TCDSADB *dsadb, const TCLIST *queries, int64_t r);
+static bool tcdsadboptimizeimpl(TCDSADB *dsadb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts);
 void tcdsadbdel(TCDSADB *dsadb);
 void tcdsadbprintmeta(TCDSADB *dsadb);
 /*************************************************************************************************
@@ -237,6 +265,16 @@ bool tcdsadbsetdfunit(TCDSADB *dsadb, int32_t dfunit){
   return tchdbsetdfunit(dsadb->hdb, dfunit);
 }
 
+/* Set the Bloom filter of the internal database of a DSA tree database object. */
+bool tcdsadbsetbloom(TCDSADB *dsadb, int64_t bfnum){
+  assert(dsadb);
+  if(dsadb->open){
+    tcdsadbsetecode(dsadb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  return tchdbsetbloom(dsadb->hdb, bfnum);
+}
+
 /* Synchronize updated contents of a DSA tree database object with the file and the device. */
 bool tcdsadbsync(TCDSADB *dsadb)
 {
@@ -361,6 +399,7 @@ bool tcdsadbtune(TCDSADB *dsadb, int32_t dimnum, int64_t bnum, int8_t apow, int8
   if(opts & DSADBTDEFLATE) hopts |= HDBTDEFLATE;
   if(opts & DSADBTBZIP) hopts |= HDBTBZIP;
   if(opts & DSADBTTCBS) hopts |= HDBTTCBS;
+  if(opts & DSADBTFAST) hopts |= HDBTFAST;
   if(opts & DSADBTEXCODEC) hopts |= HDBTEXCODEC;
   bnum = (bnum > 0) ? bnum : DSADBDEFBNUM;
   apow = (apow >= 0) ? apow : DSADBDEFAPOW;
@@ -380,6 +419,17 @@ bool tcdsadbsetcache(TCDSADB *dsadb, int32_t pcnum, int32_t ncnum){
   return true;
 }
 
+/* Set the prefetching mode of a DSA tree database object. */
+bool tcdsadbsetprefetch(TCDSADB *dsadb, bool prefetch){
+  assert(dsadb);
+  if(dsadb->open){
+    tcdsadbsetecode(dsadb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  dsadb->prefetch = prefetch;
+  return true;
+}
+
 static bool tcdsadbpagecacheout(TCDSADB *dsadb, DSADBPAGE *page)
 {
   assert(dsadb && page);
@@ -584,15 +634,17 @@ static DSADBPAGE *tcdsadbpageload(TCDSADB *dsadb, uint64_t id) {
 
     TCMALLOC(page,DSADBPAGESIZE);
 
-    page->dirty = false;
-
     rsiz = tchdbget3(dsadb->hdb, hbuf, step, page, DSADBPAGESIZE);
 
     if (rsiz != DSADBPAGESIZE)
     {
+        TCFREE(page);
     	return NULL;
     }
 
+    // The stored image keeps the flag of the moment it was saved
+    page->dirty = false;
+
     clk = DSADBLOCKCACHE(dsadb);
     tcmapput(dsadb->pagec, &pid, sizeof(pid), page, DSADBPAGESIZE);
     TCFREE(page);
@@ -683,8 +735,70 @@ static bool tcdsadbnodecheck(TCDSADB *dsadb, const DSADBCORD *kbuf, uint64_t ksi
   return tchdbvsiz(dsadb->hdb, kbuf, ksiz) > 0;
 }
 
+/* Hint the internal database to read ahead the child pages which a range search will visit.
+   `dsadb' specifies the DSA tree database object.
+   `page' specifies the page containing the children of the node.
+   `elem' specifies the node whose children are examined.
+   `kbuf' specifies the query point.
+   `r' specifies the search radius.
+   `t' specifies the time stamp bound of the search.
+   Distinct page IDs of the qualifying children which are not cached are collected first, and
+   then all of them are hinted at once so that the reads are overlapped. */
+static void tcdsadbprefetchchildren(TCDSADB *dsadb, DSADBPAGE *page, const DSADBNODE *elem,
+        const DSADBCORD *kbuf, int64_t r, time_t t)
+{
+    uint64_t pids[DSADBPREFETCHMAX];
+    int pnum = 0;
+    DSADBDIST dp, min_dist = DSADBMAXDIST;
+    int64_t child_offset = elem->child.offset;
+
+    bool clk = DSADBLOCKCACHE(dsadb);
+    while (child_offset != DSADBINVOFFSETID && pnum < DSADBPREFETCHMAX)
+    {
+        DSADBNODE *node = tcdsadbnodeload(page, child_offset);
+        TCDSADBDIST(DSADBDEFDIMENSION, kbuf, node->point, dp);
+
+        /* same pruning rule as the descent, so only pages to be visited are hinted */
+        if (dp <= min_dist + 2 * r)
+        {
+            uint64_t pid = node->child.pid;
+            if ((node->time <= t) && (dp > r) && (dp <= node->radius + r) &&
+                (pid != DSADBINVPAGEID) && (pid != page->id))
+            {
+                bool dup = false;
+                for (int i = 0; i < pnum; i++)
+                {
+                    if (pids[i] == pid) {
+                        dup = true;
+                        break;
+                    }
+                }
+                int rsiz;
+                if (!dup && !tcmapget(dsadb->pagec, &pid, sizeof(pid), &rsiz))
+                    pids[pnum++] = pid;
+            }
+            min_dist = MIN(min_dist, dp);
+        }
+        child_offset = node->sibling.offset;
+    }
+    if (clk)
+        DSADBUNLOCKCACHE(dsadb);
+
+    if (pnum < 1)
+        return;
+    TCLIST *keys = tclistnew2(pnum);
+    for (int i = 0; i < pnum; i++)
+    {
+        char hbuf[(sizeof(uint64_t) + 1) * 2];
+        int step = sprintf(hbuf, "%llx", (unsigned long long) pids[i]);
+        TCLISTPUSH(keys, hbuf, step);
+    }
+    tchdbprefetchmulti(dsadb->hdb, keys);
+    tclistdel(keys);
+}
+
 static const DSADBNODE *tcdsadbrangesearch(TCDSADB *dsadb, DSADBNODE *elem,
-        const void *kbuf, int64_t ksiz, int64_t r, time_t t) {
+        const void *kbuf, int64_t ksiz, int64_t r, time_t t, uint64_t pid) {
     DSADBDIST dp, dp1,min_dist;
     DSADBNODE *sibling;
     int32_t child_offset, sibling_offset;
@@ -701,9 +815,14 @@ static const DSADBNODE *tcdsadbrangesearch(TCDSADB *dsadb, DSADBNODE *elem,
         }
 
         min_dist = DSADBMAXDIST;
+        if (elem->child.pid != DSADBINVPAGEID && elem->child.pid != pid)
+            __sync_fetch_and_add(&dsadb->pvisit, 1);
         DSADBPAGE *page = tcdsadbpageload(dsadb, elem->child.pid);
         child_offset = elem->child.offset;
 
+        if (dsadb->prefetch && page)
+            tcdsadbprefetchchildren(dsadb, page, elem, ktemp, r, t);
+
         while (child_offset != DSADBINVOFFSETID)
         {
             DSADBNODE *node = tcdsadbnodeload(page, child_offset);
@@ -729,7 +848,7 @@ static const DSADBNODE *tcdsadbrangesearch(TCDSADB *dsadb, DSADBNODE *elem,
                 }
                 /* END */
 
-                const DSADBNODE *result = tcdsadbrangesearch(dsadb, node, kbuf, ksiz, r, t1);
+                const DSADBNODE *result = tcdsadbrangesearch(dsadb, node, kbuf, ksiz, r, t1, page->id);
                 if (result != NULL) {
                     return result;
                 }
@@ -768,7 +887,218 @@ static const DSADBNODE *tcdsadbsearchimpl(TCDSADB *dsadb, const DSADBCORD *kbuf,
     DSADBNODE *elem = tcdsadbnodeload(page, dsadb->root_offset);
 	if (elem == NULL)
 		return NULL;
-    return tcdsadbrangesearch(dsadb, elem, kbuf, ksiz, r, t);
+    __sync_fetch_and_add(&dsadb->pvisit, 1);
+    return tcdsadbrangesearch(dsadb, elem, kbuf, ksiz, r, t, page->id);
+}
+
+/* Push an entry into the queue of a best-first search.
+   `queue' specifies the queue ordered by the lower bound of the distance.
+   `qnum' specifies the pointer to the number of entries.
+   `qanum' specifies the pointer to the number of allocated entries.
+   `ent' specifies the entry. */
+static void tcdsadbqueuepush(DSADBQENT **queue, int *qnum, int *qanum, const DSADBQENT *ent)
+{
+    if (*qnum >= *qanum)
+    {
+        *qanum *= 2;
+        TCREALLOC(*queue, *queue, sizeof(**queue) * *qanum);
+    }
+    DSADBQENT *ary = *queue;
+    int i = (*qnum)++;
+    while (i > 0)
+    {
+        int p = (i - 1) / 2;
+        if (ary[p].lb <= ent->lb) break;
+        ary[i] = ary[p];
+        i = p;
+    }
+    ary[i] = *ent;
+}
+
+/* Pop the entry with the smallest lower bound from the queue of a best-first search.
+   `queue' specifies the queue.
+   `qnum' specifies the pointer to the number of entries.
+   `ent' specifies the entry into which the popped one is assigned. */
+static void tcdsadbqueuepop(DSADBQENT *queue, int *qnum, DSADBQENT *ent)
+{
+    *ent = queue[0];
+    DSADBQENT last = queue[--(*qnum)];
+    int num = *qnum;
+    int i = 0;
+    while (true)
+    {
+        int c = i * 2 + 1;
+        if (c >= num) break;
+        if (c + 1 < num && queue[c+1].lb < queue[c].lb) c++;
+        if (last.lb <= queue[c].lb) break;
+        queue[i] = queue[c];
+        i = c;
+    }
+    if (num > 0) queue[i] = last;
+}
+
+/* Add a candidate into the answers of a best-first search.
+   `ans' specifies the answers sorted by ascending distance.
+   `anum' specifies the pointer to the number of answers.
+   `k' specifies the maximum number of answers.
+   `node' specifies the candidate node.
+   `dist' specifies the distance of the candidate. */
+static void tcdsadbansadd(DSADBANS *ans, int *anum, int k, const DSADBNODE *node, int64_t dist)
+{
+    int i = *anum;
+    if (i >= k)
+    {
+        if (ans[k-1].dist <= dist) return;
+        i = k - 1;
+    } else {
+        (*anum)++;
+    }
+    while (i > 0 && ans[i-1].dist > dist)
+    {
+        ans[i] = ans[i-1];
+        i--;
+    }
+    ans[i].dist = dist;
+    memcpy(ans[i].point, node->point, sizeof(ans[i].point));
+}
+
+/* Search for the nearest nodes in a DSA tree best-first with bounded work.
+ `dsadb' specifies the DSA tree database object.
+ `kbuf' specifies the query point.
+ `k' specifies the maximum number of answers.
+ `r' specifies the search radius.
+ `pmax' specifies the maximum number of pages to be visited.
+ `dmax' specifies the maximum number of distance evaluations.
+ `usec' specifies the deadline in microseconds.
+ `ans' specifies the array into which the answers are assigned.
+ `exact' specifies the pointer to the variable into which whether the answers are exact is
+ assigned.
+ The return value is the number of the answers.
+ Subtrees are expanded in ascending order of the lower bound of the distance, which is derived
+ from the covering radius and the hyperplane between siblings with the same pruning rule as the
+ range search.  The search radius shrinks to the distance of the k-th answer found so far, and
+ when a budget is exhausted the answers found so far are returned as approximate. */
+static int tcdsadbknnimpl(TCDSADB *dsadb, const DSADBCORD *kbuf, int k, int64_t r,
+        int pmax, int64_t dmax, int64_t usec, DSADBANS *ans, bool *exact)
+{
+    assert(dsadb && kbuf && k > 0 && ans && exact);
+    *exact = true;
+    if (dsadb->root_pid == DSADBINVPAGEID)
+        return 0;
+    DSADBPAGE *page = tcdsadbpageload(dsadb, dsadb->root_pid);
+    if (page == NULL)
+        return 0;
+    DSADBNODE *elem = tcdsadbnodeload(page, dsadb->root_offset);
+    if (elem == NULL)
+        return 0;
+    double deadline = (usec > 0) ? tctime() + usec / 1000000.0 : 0.0;
+    int64_t rk = (r >= 0) ? r : DSADBMAXDIST;
+    int anum = 0;
+    int pnum = 1;
+    int64_t dnum = 1;
+    __sync_fetch_and_add(&dsadb->pvisit, 1);
+    DSADBDIST dp;
+    TCDSADBDIST(DSADBDEFDIMENSION, kbuf, elem->point, dp);
+    if (dp <= rk)
+    {
+        tcdsadbansadd(ans, &anum, k, elem, dp);
+        if (anum >= k) rk = MIN(rk, ans[k-1].dist);
+    }
+    int qanum = 64;
+    int qnum = 0;
+    DSADBQENT *queue;
+    TCMALLOC(queue, sizeof(*queue) * qanum);
+    if (elem->child.pid != DSADBINVPAGEID && dp <= elem->radius + rk)
+    {
+        DSADBQENT ent;
+        ent.lb = MAX((int64_t)dp - elem->radius, 0);
+        ent.pid = page->id;
+        ent.offset = dsadb->root_offset;
+        ent.t = time(NULL);
+        tcdsadbqueuepush(&queue, &qnum, &qanum, &ent);
+    }
+    int64_t *dists;
+    TCMALLOC(dists, sizeof(*dists) * DSADBMAXNODECOUNT);
+    uint32_t *offs;
+    TCMALLOC(offs, sizeof(*offs) * DSADBMAXNODECOUNT);
+    while (qnum > 0)
+    {
+        if (queue[0].lb > rk)
+            break;
+        if ((pmax > 0 && pnum >= pmax) || (dmax > 0 && dnum >= dmax) ||
+            (deadline > 0.0 && tctime() >= deadline))
+        {
+            *exact = false;
+            break;
+        }
+        DSADBQENT ent;
+        tcdsadbqueuepop(queue, &qnum, &ent);
+        page = tcdsadbpageload(dsadb, ent.pid);
+        if (page == NULL) continue;
+        elem = tcdsadbnodeload(page, ent.offset);
+        if (elem->child.pid != page->id)
+        {
+            pnum++;
+            __sync_fetch_and_add(&dsadb->pvisit, 1);
+        }
+        DSADBPAGE *cpage = tcdsadbpageload(dsadb, elem->child.pid);
+        if (cpage == NULL) continue;
+
+        /* evaluate the distance of every child once */
+        int cnum = 0;
+        int64_t child_offset = elem->child.offset;
+        while (child_offset != DSADBINVOFFSETID && cnum < DSADBMAXNODECOUNT)
+        {
+            DSADBNODE *node = tcdsadbnodeload(cpage, child_offset);
+            TCDSADBDIST(DSADBDEFDIMENSION, kbuf, node->point, dp);
+            dists[cnum] = dp;
+            offs[cnum] = child_offset;
+            cnum++;
+            child_offset = node->sibling.offset;
+        }
+        dnum += cnum;
+
+        int64_t min_dist = DSADBMAXDIST;
+        for (int i = 0; i < cnum; i++)
+        {
+            int64_t di = dists[i];
+            if (di > min_dist + 2 * rk) continue;
+            DSADBNODE *node = tcdsadbnodeload(cpage, offs[i]);
+
+            /* smallest time stamp of the later siblings closer than the hyperplane */
+            uint64_t t1 = ent.t;
+            for (int j = i + 1; j < cnum; j++)
+            {
+                DSADBNODE *sibling = tcdsadbnodeload(cpage, offs[j]);
+                if (sibling->time <= t1 && di > dists[j] + 2 * rk)
+                    t1 = sibling->time;
+            }
+            if (node->time <= t1 && di <= node->radius + rk)
+            {
+                if (di <= rk)
+                {
+                    tcdsadbansadd(ans, &anum, k, node, di);
+                    if (anum >= k) rk = MIN(rk, ans[k-1].dist);
+                }
+                if (node->child.pid != DSADBINVPAGEID)
+                {
+                    DSADBQENT cent;
+                    cent.lb = MAX(ent.lb, MAX(di - node->radius,
+                                  min_dist < DSADBMAXDIST ? (di - min_dist) / 2 : 0));
+                    cent.pid = cpage->id;
+                    cent.offset = offs[i];
+                    cent.t = t1;
+                    if (cent.lb <= rk)
+                        tcdsadbqueuepush(&queue, &qnum, &qanum, &cent);
+                }
+            }
+            min_dist = MIN(min_dist, di);
+        }
+    }
+    TCFREE(offs);
+    TCFREE(dists);
+    TCFREE(queue);
+    return anum;
 }
 
 static int tcdsadbinsertnode(DSADBPAGE *page,DSADBNODE *node)
@@ -1350,6 +1680,7 @@ static bool tcdsadbopenimpl(TCDSADB *dsadb, const char *path, int omode) {
     if(hopts & HDBTDEFLATE) opts |= DSADBTDEFLATE;
     if(hopts & HDBTBZIP) opts |= DSADBTBZIP;
     if(hopts & HDBTTCBS) opts |= DSADBTTCBS;
+    if(hopts & HDBTFAST) opts |= DSADBTFAST;
     if(hopts & HDBTEXCODEC) opts |= DSADBTEXCODEC;
     dsadb->opts = opts;
 
@@ -1379,6 +1710,8 @@ static void tcdsadbclear(TCDSADB *dsadb) {
     dsadb->nnode = 0;
     dsadb->ncnum = DSADBDEFNCNUM;
     dsadb->pcnum = DSADBDEFPCNUM;
+    dsadb->prefetch = false;
+    dsadb->pvisit = 0;
 
     TCDODEBUG(dsadb->cnt_cachehit=0);
     TCDODEBUG(dsadb->cnt_cachemiss=0);
@@ -1420,6 +1753,217 @@ static bool tcdsadbcloseimpl(TCDSADB *dsadb) {
     return !err;
 }
 
+/* Get the list of the stored points of a DSA tree database object.
+   `dsadb' specifies the DSA tree database object.
+   The return value is the list object of the points.  Because the object of the return value
+   is created with the function `tclistnew', it should be deleted with the function `tclistdel'
+   when it is no longer in use. */
+static TCLIST *tcdsadbpoints(TCDSADB *dsadb)
+{
+    assert(dsadb);
+    TCLIST *points = tclistnew2(dsadb->nnode + 1);
+    if (!tchdbiterinit(dsadb->hdb))
+        return points;
+    char *kbuf;
+    int ksiz;
+    while ((kbuf = tchdbiternext(dsadb->hdb, &ksiz)) != NULL)
+    {
+        /* pages are stored with their hexadecimal IDs, which are shorter than points */
+        if (ksiz == DSADBDEFDIMENSION * sizeof(DSADBCORD)) {
+            tclistpushmalloc(points, kbuf, ksiz);
+        } else {
+            TCFREE(kbuf);
+        }
+    }
+    return points;
+}
+
+/* Pick evenly spaced samples from a list of points.
+   `points' specifies the list object of the points.
+   `num' specifies the maximum number of samples.
+   The return value is the list object of the samples. */
+static TCLIST *tcdsadbsample(const TCLIST *points, int num)
+{
+    assert(points && num > 0);
+    int pnum = TCLISTNUM(points);
+    TCLIST *samples = tclistnew2(num);
+    int step = tclmax(pnum / num, 1);
+    for (int i = 0; i < pnum && TCLISTNUM(samples) < num; i += step)
+    {
+        int psiz;
+        const char *pbuf = tclistval(points, i, &psiz);
+        TCLISTPUSH(samples, pbuf, psiz);
+    }
+    return samples;
+}
+
+/* Measure the search cost of a DSA tree database object.
+   `dsadb' specifies the DSA tree database object.
+   `queries' specifies the list object of the query points.
+   `r' specifies the search radius.
+   The return value is the average number of pages visited by a search.
+   The callers hold the method lock exclusively, so no other search is counted in the difference.
+   Every search takes the method lock exclusively as well; the atomic counting only keeps the
+   counter sound if searches are ever moved under the shared lock like `tcdsadbget'. */
+static double tcdsadbsearchcostimpl(TCDSADB *dsadb, const TCLIST *queries, int64_t r)
+{
+    assert(dsadb && queries);
+    int qnum = TCLISTNUM(queries);
+    if (qnum < 1)
+        return 0.0;
+    uint64_t pvisit = dsadb->pvisit;
+    for (int i = 0; i < qnum; i++)
+    {
+        int qsiz, sp;
+        const char *qbuf = tclistval(queries, i, &qsiz);
+        tcdsadbsearchimpl(dsadb, (const DSADBCORD *)qbuf, qsiz, r, &sp);
+    }
+    return (double)(dsadb->pvisit - pvisit) / qnum;
+}
+
+/* Optimize the file of a DSA tree database object.
+   `dsadb' specifies the DSA tree database object.
+   `bnum' specifies the number of elements of the bucket array.
+   `apow' specifies the size of record alignment by power of 2.
+   `fpow' specifies the maximum number of elements of the free block pool by power of 2.
+   `opts' specifies options by bitwise-or.
+   If successful, the return value is true, else, it is false. */
+static bool tcdsadboptimizeimpl(TCDSADB *dsadb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts)
+{
+    assert(dsadb);
+    const char *path = tchdbpath(dsadb->hdb);
+    char *tpath = tcsprintf("%s%ctmp%c%llu", path, MYEXTCHR, MYEXTCHR,
+                            (unsigned long long)tchdbinode(dsadb->hdb));
+    TCLIST *points = tcdsadbpoints(dsadb);
+    TCLIST *queries = tcdsadbsample(points, DSADBCOSTSAMPLE);
+    double before = tcdsadbsearchcostimpl(dsadb, queries, 0);
+    int pnum = TCLISTNUM(points);
+    TCLISTDATUM *array = points->array + points->start;
+
+    /* shuffle the points so that the shape does not depend on the order of storing */
+    uint64_t seed = 19780211;
+    for (int i = pnum - 1; i > 0; i--)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        int j = (seed >> 33) % (i + 1);
+        TCLISTDATUM swap = array[i];
+        array[i] = array[j];
+        array[j] = swap;
+    }
+
+    /* choose the root whose covering radius over the sample is the smallest */
+    int cnum = tclmin(pnum, DSADBOPTSAMPLE);
+    int snum = tclmin(pnum, DSADBOPTSAMPLE * 4);
+    DSADBDIST best = DSADBMAXDIST;
+    int bidx = 0;
+    for (int i = 0; i < cnum; i++)
+    {
+        const DSADBCORD *cand = (const DSADBCORD *)array[i].ptr;
+        DSADBDIST radius = 0;
+        for (int j = 0; j < snum && radius < best; j++)
+        {
+            const DSADBCORD *point = (const DSADBCORD *)array[j].ptr;
+            DSADBDIST dist;
+            TCDSADBDIST(DSADBDEFDIMENSION, cand, point, dist);
+            if (dist > radius) radius = dist;
+        }
+        if (radius < best) {
+            best = radius;
+            bidx = i;
+        }
+    }
+    if (pnum > 0) {
+        TCLISTDATUM swap = array[0];
+        array[0] = array[bidx];
+        array[bidx] = swap;
+    }
+
+    TCDSADB *tdsadb = tcdsadbnew();
+    int dbgfd = tchdbdbgfd(dsadb->hdb);
+    if (dbgfd >= 0)
+        tcdsadbsetdbgfd(tdsadb, dbgfd);
+    if (bnum < 1)
+        bnum = tchdbrnum(dsadb->hdb) * 2 + 1;
+    if (apow < 0)
+        apow = tclog2l(tchdbalign(dsadb->hdb));
+    if (fpow < 0)
+        fpow = tclog2l(tchdbfbpmax(dsadb->hdb));
+    if (opts == UINT8_MAX)
+        opts = dsadb->opts;
+    tcdsadbtune(tdsadb, DSADBDEFDIMENSION, bnum, apow, fpow, opts);
+    tcdsadbsetcache(tdsadb, dsadb->pcnum, dsadb->ncnum);
+    if (!tcdsadbopen(tdsadb, tpath, DSADBOWRITER | DSADBOCREAT | DSADBOTRUNC)) {
+        tcdsadbsetecode(dsadb, tcdsadbecode(tdsadb), __FILE__, __LINE__, __func__);
+        tcdsadbdel(tdsadb);
+        tclistdel(queries);
+        tclistdel(points);
+        TCFREE(tpath);
+        return false;
+    }
+    bool err = false;
+    for (int i = 0; !err && i < pnum; i++)
+    {
+        int vsiz;
+        char *vbuf = tchdbget(dsadb->hdb, array[i].ptr, array[i].size, &vsiz);
+        if (!vbuf) {
+            tcdsadbsetecode(dsadb, tcdsadbecode(dsadb), __FILE__, __LINE__, __func__);
+            err = true;
+            break;
+        }
+        if (!tcdsadbput(tdsadb, array[i].ptr, array[i].size, vbuf, vsiz)) {
+            tcdsadbsetecode(dsadb, tcdsadbecode(tdsadb), __FILE__, __LINE__, __func__);
+            err = true;
+        }
+        TCFREE(vbuf);
+    }
+    double after = tcdsadbsearchcostimpl(tdsadb, queries, 0);
+    tclistdel(queries);
+    tclistdel(points);
+    if (!tcdsadbclose(tdsadb)) {
+        tcdsadbsetecode(dsadb, tcdsadbecode(tdsadb), __FILE__, __LINE__, __func__);
+        err = true;
+    }
+    tcdsadbdel(tdsadb);
+    if (!err && dbgfd >= 0 && dbgfd != UINT16_MAX) {
+        char obuf[DSADBPAGEBUFSIZ];
+        int osiz = snprintf(obuf, sizeof(obuf), "INFO:%s:%s:pages per search:%.3f:%.3f\n",
+                            __func__, path, before, after);
+        tcwrite(dbgfd, obuf, osiz);
+    }
+    if (err) {
+        unlink(tpath);
+        TCFREE(tpath);
+        return false;
+    }
+    if (unlink(path) == -1) {
+        tcdsadbsetecode(dsadb, TCEUNLINK, __FILE__, __LINE__, __func__);
+        err = true;
+    }
+    if (rename(tpath, path) == -1) {
+        tcdsadbsetecode(dsadb, TCERENAME, __FILE__, __LINE__, __func__);
+        err = true;
+    }
+    TCFREE(tpath);
+    if (err)
+        return false;
+    tpath = tcstrdup(path);
+    int omode = (tchdbomode(dsadb->hdb) & ~HDBOCREAT) & ~HDBOTRUNC;
+    int domode = DSADBOWRITER;
+    if (omode & HDBONOLCK)
+        domode |= DSADBONOLCK;
+    if (omode & HDBOLCKNB)
+        domode |= DSADBOLCKNB;
+    if (omode & HDBOTSYNC)
+        domode |= DSADBOTSYNC;
+    if (!tcdsadbcloseimpl(dsadb)) {
+        TCFREE(tpath);
+        return false;
+    }
+    bool rv = tcdsadbopenimpl(dsadb, tpath, domode);
+    TCFREE(tpath);
+    return rv;
+}
+
 /* Delete a DSA tree database object. */
 void tcdsadbdel(TCDSADB *dsadb){
   assert(dsadb);
@@ -1620,6 +2164,70 @@ void *tcdsadbsearch2(TCDSADB *dsadb, const char *kbuf, int64_t r) {
     return tcdsadbsearch(dsadb, kstr, strlen(kbuf) * sizeof(DSADBCORD), r, &sp);
 }
 
+/* Search for the nearest records in a DSA tree database object with bounded work. */
+TCLIST *tcdsadbknn(TCDSADB *dsadb, const void *kbuf, int ksiz, int k, int64_t r,
+        int pmax, int64_t dmax, int64_t usec, bool *exact) {
+    assert(dsadb && kbuf && ksiz >= 0 && exact);
+    *exact = false;
+    if (!DSADBLOCKMETHOD(dsadb, true))
+        return NULL;
+    if (ksiz != DSADBDEFDIMENSION * sizeof(DSADBCORD) || k < 1 || !dsadb->open)
+    {
+        tcdsadbsetecode(dsadb, TCEINVALID, __FILE__, __LINE__, __func__);
+        DSADBUNLOCKMETHOD(dsadb);
+        return NULL;
+    }
+    DSADBANS *ans;
+    TCMALLOC(ans, sizeof(*ans) * k);
+    int anum = tcdsadbknnimpl(dsadb, kbuf, k, r, pmax, dmax, usec, ans, exact);
+    TCLIST *rv = tclistnew2(anum);
+    for (int i = 0; i < anum; i++)
+        TCLISTPUSH(rv, ans[i].point, sizeof(ans[i].point));
+    TCFREE(ans);
+    DSADBUNLOCKMETHOD(dsadb);
+
+    bool adj = TCMAPRNUM(dsadb->pagec) > dsadb->pcnum || TCMAPRNUM(dsadb->nodec) > dsadb->ncnum;
+    if(adj && DSADBLOCKMETHOD(dsadb, true)){
+      tcdsadbcacheadjust(dsadb);
+      DSADBUNLOCKMETHOD(dsadb);
+    }
+    return rv;
+}
+
+/* Search for a record in a DSA tree database object with bounded work. */
+void *tcdsadbsearch3(TCDSADB *dsadb, const void *kbuf, int ksiz, int64_t r,
+        int pmax, int64_t dmax, int64_t usec, bool *exact, int *sp) {
+    assert(dsadb && kbuf && ksiz >= 0 && exact && sp);
+    *exact = false;
+    if (!DSADBLOCKMETHOD(dsadb, true))
+        return NULL;
+    if (ksiz != DSADBDEFDIMENSION * sizeof(DSADBCORD) || !dsadb->open)
+    {
+        tcdsadbsetecode(dsadb, TCEINVALID, __FILE__, __LINE__, __func__);
+        DSADBUNLOCKMETHOD(dsadb);
+        return NULL;
+    }
+    char *rv = NULL;
+    const char *vbuf = tcdsadbgetimpl(dsadb, kbuf, ksiz, sp);
+    if (vbuf)
+    {
+        *exact = true;
+        rv = (char *)vbuf;
+    } else {
+        DSADBANS ans;
+        if (tcdsadbknnimpl(dsadb, kbuf, 1, r, pmax, dmax, usec, &ans, exact) > 0)
+            rv = tcdsadbgetimpl(dsadb, ans.point, sizeof(ans.point), sp);
+    }
+    DSADBUNLOCKMETHOD(dsadb);
+
+    bool adj = TCMAPRNUM(dsadb->pagec) > dsadb->pcnum || TCMAPRNUM(dsadb->nodec) > dsadb->ncnum;
+    if(adj && DSADBLOCKMETHOD(dsadb, true)){
+      tcdsadbcacheadjust(dsadb);
+      DSADBUNLOCKMETHOD(dsadb);
+    }
+    return rv;
+}
+
 void *tcdsadbinsertsafe(TCDSADB *dsadb, const void *kbuf, int ksiz, const void *vbuf, int vsiz, uint32_t r, int *sp) {
     assert(dsadb && kbuf && ksiz >= 0 && sp);
 
@@ -1676,6 +2284,46 @@ void *tcdsadbinsertsafe(TCDSADB *dsadb, const void *kbuf, int ksiz, const void *
     return rv;
 }
 
+/* Optimize the file of a DSA tree database object. */
+bool tcdsadboptimize(TCDSADB *dsadb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts) {
+    assert(dsadb);
+    if (!DSADBLOCKMETHOD(dsadb, true))
+        return false;
+    if (!dsadb->open || !dsadb->wmode || dsadb->tran) {
+        tcdsadbsetecode(dsadb, TCEINVALID, __FILE__, __LINE__, __func__);
+        DSADBUNLOCKMETHOD(dsadb);
+        return false;
+    }
+    bool rv = tcdsadboptimizeimpl(dsadb, bnum, apow, fpow, opts);
+    DSADBUNLOCKMETHOD(dsadb);
+    return rv;
+}
+
+/* Measure the search cost of a DSA tree database object. */
+double tcdsadbsearchcost(TCDSADB *dsadb, int num, int64_t r) {
+    assert(dsadb && num > 0);
+    if (!DSADBLOCKMETHOD(dsadb, true))
+        return -1.0;
+    if (!dsadb->open) {
+        tcdsadbsetecode(dsadb, TCEINVALID, __FILE__, __LINE__, __func__);
+        DSADBUNLOCKMETHOD(dsadb);
+        return -1.0;
+    }
+    TCLIST *points = tcdsadbpoints(dsadb);
+    TCLIST *queries = tcdsadbsample(points, num);
+    double rv = tcdsadbsearchcostimpl(dsadb, queries, r);
+    tclistdel(queries);
+    tclistdel(points);
+    DSADBUNLOCKMETHOD(dsadb);
+
+    bool adj = TCMAPRNUM(dsadb->pagec) > dsadb->pcnum || TCMAPRNUM(dsadb->nodec) > dsadb->ncnum;
+    if(adj && DSADBLOCKMETHOD(dsadb, true)){
+      tcdsadbcacheadjust(dsadb);
+      DSADBUNLOCKMETHOD(dsadb);
+    }
+    return rv;
+}
+
 /* Get the number of records of a DSA tree database object. */
 uint64_t tcdsadbrnum(TCDSADB *dsadb){
   assert(dsadb);
@@ -42,6 +42,8 @@ __TCBDB_CLINKAGEBEGIN
 typedef unsigned short DSADBDIST;
 typedef unsigned char DSADBCORD;
 
+#define TCDSADBPSIZ    (81 * sizeof(DSADBCORD))   /* size of the region of a point */
+
 #define TCDSADBDIST(TC_dim, TC_p1, TC_p2,TC_res) \
   do { \
           TC_res = 0;\
@@ -80,6 +82,8 @@ typedef struct {                         /* type of structure for a DSA tree dat
   int64_t cnt_savepage;                  /* tesing counter for node save times */
   int64_t depth;
   uint64_t maxnodeperpage;               /* maximum of nodes per page */
+  bool prefetch;                         /* whether to prefetch child pages */
+  uint64_t pvisit;                       /* number of pages visited by searches */
 } TCDSADB;
 
 enum {                                   /* enumeration for additional flags */
@@ -91,7 +95,8 @@ enum {                                   /* enumeration for tuning options */
   DSADBTDEFLATE = 1 << 1,                  /* compress each page with Deflate */
   DSADBTBZIP = 1 << 2,                     /* compress each record with BZIP2 */
   DSADBTTCBS = 1 << 3,                     /* compress each page with TCBS */
-  DSADBTEXCODEC = 1 << 4                   /* compress each record with outer functions */
+  DSADBTEXCODEC = 1 << 4,                  /* compress each record with outer functions */
+  DSADBTFAST = 1 << 5                      /* compress each page with LZ */
 };
 
 enum {                                   /* enumeration for open modes */
@@ -128,8 +133,63 @@ void *tcdsadbsearch(TCDSADB *dsadb, const void *kbuf, int ksiz, int64_t r, int *
 
 void *tcdsadbsearch2(TCDSADB *dsadb, const char *kbuf, int64_t r);
 
+/* Search for the nearest records in a DSA tree database object with bounded work.
+   `dsadb' specifies the DSA tree database object.
+   `kbuf' specifies the pointer to the region of the query point.
+   `ksiz' specifies the size of the region of the query point.
+   `k' specifies the maximum number of records to be fetched.
+   `r' specifies the search radius.  If it is negative, no limit is specified.
+   `pmax' specifies the maximum number of pages to be visited.  If it is not more than 0, no
+   limit is specified.
+   `dmax' specifies the maximum number of distance evaluations.  If it is not more than 0, no
+   limit is specified.
+   `usec' specifies the deadline in microseconds.  If it is not more than 0, no limit is
+   specified.
+   `exact' specifies the pointer to the variable into which whether the result is exact is
+   assigned.
+   If successful, the return value is a list object of the keys of the nearest records found
+   within the radius in ascending order of the distance, else, it is `NULL'.
+   Subtrees are visited in ascending order of the lower bound of their distances.  When a budget
+   is exhausted, the best records found so far are returned and false is assigned to `exact'.
+   Because the object of the return value is created with the function `tclistnew', it should
+   be deleted with the function `tclistdel' when it is no longer in use. */
+TCLIST *tcdsadbknn(TCDSADB *dsadb, const void *kbuf, int ksiz, int k, int64_t r,
+                   int pmax, int64_t dmax, int64_t usec, bool *exact);
+
+/* Search for a record in a DSA tree database object with bounded work.
+   `dsadb' specifies the DSA tree database object.
+   `kbuf' specifies the pointer to the region of the query point.
+   `ksiz' specifies the size of the region of the query point.
+   `r', `pmax', `dmax', `usec', and `exact' are the same as `tcdsadbknn'.
+   `sp' specifies the pointer to the variable into which the size of the region of the return
+   value is assigned.
+   If successful, the return value is the pointer to the region of the value of the nearest
+   record found within the radius, else, it is `NULL'.
+   Because the region of the return value is allocated with the `malloc' call, it should be
+   released with the `free' call when it is no longer in use. */
+void *tcdsadbsearch3(TCDSADB *dsadb, const void *kbuf, int ksiz, int64_t r,
+                     int pmax, int64_t dmax, int64_t usec, bool *exact, int *sp);
+
 void *tcdsadbinsertsafe(TCDSADB *dsadb, const void *kbuf, int ksiz, const void *vbuf, int vsiz, uint32_t r, int *sp);
 
+/* Optimize the file of a DSA tree database object.
+   `dsadb' specifies the DSA tree database object connected as a writer.
+   `bnum' specifies the number of elements of the bucket array.  If it is not more than 0, the
+   default value is specified.  The default value is two times of the number of records.
+   `apow' specifies the size of record alignment by power of 2.  If it is negative, the current
+   setting is not changed.
+   `fpow' specifies the maximum number of elements of the free block pool by power of 2.  If it
+   is negative, the current setting is not changed.
+   `opts' specifies options by bitwise-or.  If it is `UINT8_MAX', the current setting is not
+   changed.
+   If successful, the return value is true, else, it is false.
+   The tree is rebuilt into a new file.  The point whose covering radius over a sample is the
+   smallest becomes the root and the other points are inserted in a shuffled order, so that the
+   shape of the tree does not depend on the order in which the points were stored.  The average
+   numbers of pages visited by a search before and after rebuilding are written into the
+   debugging output. */
+bool tcdsadboptimize(TCDSADB *dsadb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts);
+
 /* Get the number of records of a DSA tree database object. */
 uint64_t tcdsadbrnum(TCDSADB *dsadb);
 
@@ -160,6 +220,9 @@ bool tcdsadbsetxmsiz(TCDSADB *dsadb, int64_t xmsiz);
 /* Set the unit step number of auto defragmentation of a B+ tree database object. */
 bool tcdsadbsetdfunit(TCDSADB *dsadb, int32_t dfunit);
 
+/* Set the Bloom filter of the internal database of a DSA tree database object. */
+bool tcdsadbsetbloom(TCDSADB *dsadb, int64_t bfnum);
+
 /* Delete a DSA tree database object. */
 void tcdsadbdel(TCDSADB *dsadb);
 
@@ -169,6 +232,17 @@ bool tcdsadbtune(TCDSADB *dsadb, int32_t dimnum, int64_t bnum, int8_t apow, int8
 /* Set the caching parameters of a DSA tree database object. */
 bool tcdsadbsetcache(TCDSADB *dsadb, int32_t pcnum, int32_t ncnum);
 
+/* Measure the search cost of a DSA tree database object.
+   `num' specifies the number of sample queries.  The queries are stored points.
+   `r' specifies the search radius.
+   The return value is the average number of pages visited by a search or -1.0 on failure. */
+double tcdsadbsearchcost(TCDSADB *dsadb, int num, int64_t r);
+
+/* Set the prefetching mode of a DSA tree database object.
+   If `prefetch' is true, the child pages which a search will descend into are hinted to be read
+   ahead together before the descent, so that their latency of disk access is overlapped. */
+bool tcdsadbsetprefetch(TCDSADB *dsadb, bool prefetch);
+
 __TCBDB_CLINKAGEEND
 
 #endif                                   /* duplication check */
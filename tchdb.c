@@ -33,6 +33,10 @@
 #define HDBRNUMOFF     48                // offset of the region for the record number
 #define HDBFSIZOFF     56                // offset of the region for the file size
 #define HDBFRECOFF     64                // offset of the region for the first record offset
+#define HDBLHBASEOFF   72                // offset of the region for the base bucket number
+#define HDBLHMAXOFF    80                // offset of the region for the maximum bucket number
+#define HDBGENOFF      88                // offset of the region for the generation number
+#define HDBTYPEEXT     0x80              // bit of the database type for the extended format
 #define HDBOPAQUEOFF   128               // offset of the region for the opaque field
 
 #define HDBDEFBNUM     131071            // default bucket number
@@ -43,17 +47,54 @@
 #define HDBDEFXMSIZ    (64LL<<20)        // default size of the extra mapped memory
 #define HDBXFSIZINC    32768             // increment of extra file size
 #define HDBMINRUNIT    48                // minimum record reading unit
-#define HDBMAXHSIZ     32                // maximum record header size
+#define HDBMAXHSIZ     36                // maximum record header size
+#define HDBXTKEEP      UINT32_MAX        // expiration time to keep that of the existing record
 #define HDBFBPALWRAT   2                 // allowance ratio of the free block pool
 #define HDBFBPBSIZ     64                // base region size of the free block pool
 #define HDBFBPESIZ     4                 // size of each region of the free block pool
-#define HDBFBPMGFREQ   4096              // frequency to merge the free block pool
 #define HDBDRPUNIT     65536             // unit size of the delayed record pool
 #define HDBDRPLAT      2048              // latitude size of the delayed record pool
+#define HDBBATCHUNIT   (1LL<<20)         // unit size of the pool of batched records
 #define HDBDFRSRAT     2                 // step ratio of auto defragmentation
+#define HDBDFWSTEP     32                // default step of background defragmentation
+#define HDBDFWDUTY     10                // inverse of the duty ratio of background defragmentation
 #define HDBFBMAXSIZ    (INT32_MAX/4)     // maximum size of a free block pool
-#define HDBCACHEOUT    128               // number of records in a process of cacheout
+#define HDBCACHEOUT    128               // minimum number of records of the record cache
+#define HDBRCSHARDS    16                // number of shards of the record cache
+#define HDBRCDOORRAT   8                 // ratio of bits of the doorkeeper of the record cache
+#define HDBRCNEGRAT    4                 // inverse ratio of slots for missing keys
 #define HDBWALSUFFIX   "wal"             // suffix of write ahead logging file
+#define HDBWALPROGUNIT (1LL<<20)         // unit size of reporting of progress of recovery
+#define HDBBFSUFFIX    "bf"              // suffix of the Bloom filter file
+#define HDBSNAPSUFFIX  "snap"            // suffix of the pre-image log of a snapshot
+#define HDBSNAPUNIT    (1LL<<20)         // unit size of copying of a snapshot
+#define HDBOPTSUFFIX   "opt"             // suffix of the checkpoint file of optimization
+#define HDBOPTMAGIC    "ToKyO CaBiNeT\nOP"  // magic data of the checkpoint file
+#define HDBOPTHEADSIZ  64                // size of the header of the checkpoint file
+#define HDBOPTUNIT     (1LL<<20)         // unit size of writing of a run of optimization
+#define HDBOPTCKFREQ   64                // number of units of a run between checkpoints
+#define HDBOPTMAXTH    64                // maximum number of threads of optimization
+#define HDBHUGEUNIT    (1LL<<21)         // unit size of huge pages
+#define HDBRINGMAXDEPTH 256              // maximum depth of the asynchronous I/O ring
+#define HDBRINGWUNIT   16384             // unit size of writing through the I/O ring
+#define HDBBFMAGIC     "ToKyO CaBiNeT\nBF"  // magic data of the Bloom filter file
+#define HDBBFHEADSIZ   64                // size of the header of the Bloom filter file
+#define HDBBFBITS      10                // number of bits of the Bloom filter per record
+#define HDBBFPROBE     6                 // number of bits set by each key
+#define HDBBFBWORDS    8                 // number of words of a block of the Bloom filter
+#define HDBDEFRLNUM    256               // default number of record locks
+#define HDBMAXRLNUM    65536             // maximum number of record locks
+#define HDBRLOCKALIGN  64                // alignment of each record lock
+#define HDBOPTRETRY    8                 // number of retries of an optimistic read
+#define HDBOPTRDSLOT   16                // maximum number of slots counting optimistic readers
+#define HDBLHLOAD      1                 // number of records per bucket to trigger a split
+#define HDBLHSTEP      256               // number of buckets split by automatic growth
+#define HDBXHSEED      19780211          // seed of the word-at-a-time hash function
+#define HDBXHPRIME1    0x9E3779B185EBCA87ULL  // primes of the word-at-a-time hash function
+#define HDBXHPRIME2    0xC2B2AE3D27D4EB4FULL
+#define HDBXHPRIME3    0x165667B19E3779F9ULL
+#define HDBXHPRIME4    0x85EBCA77C2B2AE63ULL
+#define HDBXHPRIME5    0x27D4EB2F165667C5ULL
 
 typedef struct {                         // type of structure for a record
   uint64_t off;                          // offset of the record
@@ -65,6 +106,7 @@ typedef struct {                         // type of structure for a record
   uint32_t ksiz;                         // size of the key
   uint32_t vsiz;                         // size of the value
   uint16_t psiz;                         // size of the padding
+  uint32_t xtime;                        // expiration time
   const char *kbuf;                      // pointer to the key
   const char *vbuf;                      // pointer to the value
   uint64_t boff;                         // offset of the body
@@ -76,6 +118,59 @@ typedef struct {                         // type of structure for a free block
   uint32_t rsiz;                         // size of the block
 } HDBFB;
 
+typedef struct {                         // type of structure for the free block pool
+  TCTREE *bysiz;                         // blocks ordered by size and offset
+  TCTREE *byoff;                         // sizes of blocks ordered by descending offset
+} HDBFBP;
+
+typedef struct {                         // type of structure for the body of a record lock
+  pthread_rwlock_t rwlock;               // reader-writer lock
+  volatile uint32_t seq;                 // sequence number, odd while a writer holds the lock
+  volatile uint32_t rdnum;               // number of optimistic readers counted in the slot
+} HDBRLOCKBODY;
+
+typedef union {                          // type of structure for a record lock
+  HDBRLOCKBODY b;                        // body
+  char pad[((sizeof(HDBRLOCKBODY) - 1) / HDBRLOCKALIGN + 1) * HDBRLOCKALIGN];  // padding
+} HDBRLOCK;
+
+typedef struct {                         // type of structure for a cached record
+  volatile uint32_t ref;                 // reference count
+  uint32_t ksiz;                         // size of the key
+  uint32_t vsiz;                         // size of the value
+  uint64_t hash;                         // hash value of the key
+  char buf[];                            // region of the key and the value
+} HDBRCREC;
+
+typedef struct {                         // type of structure for a slot of the record cache
+  HDBRCREC *rec;                         // cached record
+  int32_t next;                          // index of the next slot in the chain or the free list
+  bool hot;                              // whether the record was hit since the last sweep
+} HDBRCSLOT;
+
+typedef struct {                         // type of structure for a shard of the record cache
+  pthread_mutex_t mutex;                 // mutex for the shard
+  HDBRCSLOT *slots;                      // array of the slots
+  int32_t *heads;                        // chain heads of the index
+  bool mapped;                           // whether the index is mapped with a memory policy
+  uint32_t hmask;                        // mask of the index
+  uint32_t cap;                          // number of the slots
+  uint32_t num;                          // number of the cached records
+  uint32_t used;                         // number of the slots ever used
+  int32_t free;                          // head of the free list
+  uint32_t hand;                         // position of the clock hand
+  uint64_t *door;                        // bitmap of the doorkeeper
+  uint32_t dmask;                        // mask of the doorkeeper
+  uint32_t dnum;                         // number of keys noted in the doorkeeper
+  HDBRCREC **negs;                       // direct mapped table of missing keys
+  uint32_t nmask;                        // mask of the table of missing keys
+} HDBRCSHARD;
+
+typedef union {                          // type of structure for a padded shard
+  HDBRCSHARD s;                          // body
+  char pad[((sizeof(HDBRCSHARD) - 1) / HDBRLOCKALIGN + 1) * HDBRLOCKALIGN];  // padding
+} HDBRCACHE;
+
 enum {                                   // enumeration for magic data
   HDBMAGICREC = 0xc8,                    // for data block
   HDBMAGICFB = 0xb0                      // for free block
@@ -95,6 +190,100 @@ typedef struct {                         // type of structure for a duplication
   void *op;                              // opaque pointer
 } HDBPDPROCOP;
 
+typedef struct {                         // type of structure for a worker of defragmentation
+  pthread_t thid;                        // thread ID
+  pthread_mutex_t mutex;                 // mutex for the condition
+  pthread_cond_t cond;                   // condition to wake the worker
+  bool stop;                             // whether the worker should stop
+} HDBDFWORKER;
+
+typedef struct {                         // type of structure for a record of a split bucket
+  uint64_t off;                          // offset of the record
+  char *kbuf;                            // pointer to the key
+  int ksiz;                              // size of the key
+  uint8_t hash;                          // hash value for the collision tree
+  int left;                              // index of the left child
+  int right;                             // index of the right child
+} HDBLHREC;
+
+typedef struct {                         // type of structure for a worker of optimization
+  void *opt;                             // state of the optimization
+  pthread_t thid;                        // thread ID
+  char *rpath;                           // path of the run file
+  uint64_t begin;                        // offset of the beginning of the region
+  uint64_t end;                          // offset of the end of the region
+  uint64_t cur;                          // offset of the cursor
+  uint64_t rlen;                         // size of the run
+  uint64_t dcur;                         // offset of the cursor at the last checkpoint
+  uint64_t drlen;                        // size of the run at the last checkpoint
+  int ecode;                             // error code
+} HDBOPTWORKER;
+
+typedef struct {                         // type of structure for a worker of parallel iteration
+  TCHDB *hdb;                            // hash database object
+  uint64_t begin;                        // offset of the beginning of the range
+  uint64_t end;                          // offset of the end of the range
+  TCITER iter;                           // iterator function
+  void *op;                              // opaque object for the iterator function
+  volatile bool *stop;                   // flag to stop all workers
+  pthread_t thid;                        // thread ID
+  int ecode;                             // error code
+} HDBFEWORKER;
+
+typedef struct {                         // type of structure for a parallel optimization
+  TCHDB *hdb;                            // source database object
+  TCHDB *thdb;                           // destination database object
+  char *cpath;                           // path of the checkpoint file
+  pthread_mutex_t mutex;                 // mutex for checkpoints
+  HDBOPTWORKER *workers;                 // array of the workers
+  int wnum;                              // number of the workers
+  bool done;                             // whether all runs are complete
+} HDBOPT;
+
+typedef struct {                         // type of structure for a running snapshot
+  int fd;                                // file descriptor of the pre-image log
+  uint64_t end;                          // size of the database file at the start
+  uint64_t lsiz;                         // size of the pre-image log
+} HDBSNAP;
+
+typedef struct {                         // type of structure for a probe of multiple retrieval
+  uint64_t off;                          // offset of the first record of the bucket
+  uint64_t bidx;                         // index of the bucket
+  int kidx;                              // index of the key
+  uint8_t hash;                          // hash value for the collision tree
+} HDBPROBE;
+
+typedef struct {                         // type of structure for a request of the I/O ring
+  uint64_t off;                          // offset of the region
+  char *buf;                             // pointer to the buffer
+  int32_t size;                          // size of the region
+  int32_t done;                          // number of transferred bytes
+} HDBIOREQ;
+
+typedef struct {                         // type of structure for the asynchronous I/O ring
+  pthread_mutex_t mutex;                 // mutex for the ring
+  int fd;                                // file descriptor of the ring
+  uint32_t depth;                        // number of the entries of the submission queue
+  char *sqmap;                           // mapped region of the submission queue
+  size_t sqlen;                          // size of the region of the submission queue
+  char *cqmap;                           // mapped region of the completion queue
+  size_t cqlen;                          // size of the region of the completion queue
+  void *sqes;                            // array of the submission entries
+  size_t sqelen;                         // size of the array of the submission entries
+  uint32_t *sqtail;                      // tail of the submission queue
+  uint32_t *sqmask;                      // mask of the submission queue
+  uint32_t *sqarray;                     // index array of the submission queue
+  uint32_t *cqhead;                      // head of the completion queue
+  uint32_t *cqtail;                      // tail of the completion queue
+  uint32_t *cqmask;                      // mask of the completion queue
+  void *cqes;                            // array of the completion entries
+  char *bufs;                            // region of the buffers of the slots
+  size_t bsiz;                           // size of the region of the buffers
+  bool fixed;                            // whether the buffers are registered
+  bool dead;                             // whether the ring has failed
+  HDBIOREQ *reqs;                        // array of the requests
+} HDBRING;
+
 
 /* private macros */
 #define HDBLOCKMETHOD(TC_hdb, TC_wr) \
@@ -102,9 +291,9 @@ typedef struct {                         // type of structure for a duplication
 #define HDBUNLOCKMETHOD(TC_hdb) \
   ((TC_hdb)->mmtx ? tchdbunlockmethod(TC_hdb) : true)
 #define HDBLOCKRECORD(TC_hdb, TC_bidx, TC_wr) \
-  ((TC_hdb)->mmtx ? tchdblockrecord((TC_hdb), (uint8_t)(TC_bidx), (TC_wr)) : true)
+  ((TC_hdb)->mmtx ? tchdblockrecord((TC_hdb), (TC_bidx), (TC_wr)) : true)
 #define HDBUNLOCKRECORD(TC_hdb, TC_bidx) \
-  ((TC_hdb)->mmtx ? tchdbunlockrecord((TC_hdb), (uint8_t)(TC_bidx)) : true)
+  ((TC_hdb)->mmtx ? tchdbunlockrecord((TC_hdb), (TC_bidx)) : true)
 #define HDBLOCKALLRECORDS(TC_hdb, TC_wr) \
   ((TC_hdb)->mmtx ? tchdblockallrecords((TC_hdb), (TC_wr)) : true)
 #define HDBUNLOCKALLRECORDS(TC_hdb) \
@@ -117,74 +306,171 @@ typedef struct {                         // type of structure for a duplication
   ((TC_hdb)->mmtx ? tchdblockwal(TC_hdb) : true)
 #define HDBUNLOCKWAL(TC_hdb) \
   ((TC_hdb)->mmtx ? tchdbunlockwal(TC_hdb) : true)
+#define HDBLHNEEDGROW(TC_hdb) \
+  ((TC_hdb)->lhbase > 0 && !(TC_hdb)->snap && (TC_hdb)->bnum < (TC_hdb)->lhmax && \
+   (TC_hdb)->rnum > (TC_hdb)->bnum * HDBLHLOAD)
 #define HDBTHREADYIELD(TC_hdb) \
   do { if((TC_hdb)->mmtx) sched_yield(); } while(false)
+#define HDBXHROTL(TC_x, TC_r) (((TC_x) << (TC_r)) | ((TC_x) >> (64 - (TC_r))))
+#define HDBXHROUND(TC_acc, TC_lane) \
+  do { \
+    (TC_acc) += (TC_lane) * HDBXHPRIME2; \
+    (TC_acc) = HDBXHROTL((TC_acc), 31); \
+    (TC_acc) *= HDBXHPRIME1; \
+  } while(false)
+#define HDBXHMERGE(TC_acc, TC_val) \
+  do { \
+    uint64_t _TC_val = 0; \
+    HDBXHROUND(_TC_val, (TC_val)); \
+    (TC_acc) ^= _TC_val; \
+    (TC_acc) = (TC_acc) * HDBXHPRIME1 + HDBXHPRIME4; \
+  } while(false)
 
 
 /* private function prototypes */
 static uint64_t tcgetprime(uint64_t num);
 static bool tchdbseekwrite(TCHDB *hdb, off_t off, const void *buf, size_t size);
+static bool tchdbgrowmap(TCHDB *hdb, uint64_t end);
+static bool tchdbextendfile(TCHDB *hdb, uint64_t end);
 static bool tchdbseekread(TCHDB *hdb, off_t off, void *buf, size_t size);
 static bool tchdbseekreadtry(TCHDB *hdb, off_t off, void *buf, size_t size);
+static int tchdbseekreadpart(TCHDB *hdb, off_t off, void *buf, int size);
+static bool tchdbseekwritebatch(TCHDB *hdb, off_t off, const void *buf, size_t size);
+static HDBRING *tchdbringnew(int32_t depth);
+static void tchdbringdel(HDBRING *ring);
+static bool tchdbringio(TCHDB *hdb, HDBIOREQ *reqs, int num, bool wr);
 static void tchdbdumpmeta(TCHDB *hdb, char *hbuf);
 static void tchdbloadmeta(TCHDB *hdb, const char *hbuf);
 static void tchdbclear(TCHDB *hdb);
 static int32_t tchdbpadsize(TCHDB *hdb, uint64_t off);
+static bool tchdbexpired(TCHDB *hdb, uint32_t xtime);
 static void tchdbsetflag(TCHDB *hdb, int flag, bool sign);
+static bool tchdbadvancegen(TCHDB *hdb);
 static uint64_t tchdbbidx(TCHDB *hdb, const char *kbuf, int ksiz, uint8_t *hp);
+static uint64_t tchdbhashidx(TCHDB *hdb, const char *kbuf, int ksiz, uint8_t *hp);
+static uint64_t tchdblhaddr(TCHDB *hdb, uint64_t idx);
+static uint64_t tchdbxhash(const char *kbuf, int ksiz);
 static off_t tchdbgetbucket(TCHDB *hdb, uint64_t bidx);
 static void tchdbsetbucket(TCHDB *hdb, uint64_t bidx, uint64_t off);
 static bool tchdbsavefbp(TCHDB *hdb);
 static bool tchdbloadfbp(TCHDB *hdb);
-static void tcfbpsortbyoff(HDBFB *fbpool, int fbpnum);
-static void tcfbpsortbyrsiz(HDBFB *fbpool, int fbpnum);
-static void tchdbfbpmerge(TCHDB *hdb);
+static bool tchdbfbpready(TCHDB *hdb);
+static HDBFBP *tchdbfbpnew(void);
+static void tchdbfbpdel(HDBFBP *fbp);
+static void tchdbfbpclear(TCHDB *hdb);
+static int tchdbfbpcmpsiz(const char *aptr, int asiz, const char *bptr, int bsiz, void *op);
+static int tchdbfbpcmpoff(const char *aptr, int asiz, const char *bptr, int bsiz, void *op);
+static void tchdbfbpadd(TCHDB *hdb, uint64_t off, uint32_t rsiz);
+static void tchdbfbpremove(TCHDB *hdb, uint64_t off, uint32_t rsiz);
+static bool tchdbfbpfloor(TCHDB *hdb, uint64_t off, HDBFB *fb);
+static void tchdbfbpjoin(TCHDB *hdb, uint64_t off, uint32_t rsiz);
 static void tchdbfbpinsert(TCHDB *hdb, uint64_t off, uint32_t rsiz);
 static bool tchdbfbpsearch(TCHDB *hdb, TCHREC *rec);
 static bool tchdbfbpsplice(TCHDB *hdb, TCHREC *rec, uint32_t nsiz);
 static void tchdbfbptrim(TCHDB *hdb, uint64_t base, uint64_t next, uint64_t off, uint32_t rsiz);
 static bool tchdbwritefb(TCHDB *hdb, uint64_t off, uint32_t rsiz);
+static bool tchdbreserverec(TCHDB *hdb, TCHREC *rec, int ksiz, int vsiz);
 static bool tchdbwriterec(TCHDB *hdb, TCHREC *rec, uint64_t bidx, off_t entoff);
 static bool tchdbreadrec(TCHDB *hdb, TCHREC *rec, char *rbuf);
+static bool tchdbparserec(TCHDB *hdb, TCHREC *rec, const char *rbuf, int rsiz);
 static bool tchdbreadrecbody(TCHDB *hdb, TCHREC *rec);
 static bool tchdbremoverec(TCHDB *hdb, TCHREC *rec, char *rbuf, uint64_t bidx, off_t entoff);
 static bool tchdbshiftrec(TCHDB *hdb, TCHREC *rec, char *rbuf, off_t destoff);
+static bool tchdbexpirerec(TCHDB *hdb, TCHREC *rec);
 static int tcreckeycmp(const char *abuf, int asiz, const char *bbuf, int bsiz);
 static bool tchdbflushdrp(TCHDB *hdb);
-static void tchdbcacheadjust(TCHDB *hdb);
+static HDBRCACHE *tchdbrcnew(uint32_t rcnum, uint64_t nodes);
+static void tchdbrcdel(HDBRCACHE *rc);
+static void tchdbrcvanish(HDBRCACHE *rc);
+static HDBRCREC *tchdbrcrecnew(const char *kbuf, int ksiz, const char *vbuf, int vsiz,
+                               uint64_t hash);
+static bool tchdbrcrecmatch(HDBRCREC *rec, const char *kbuf, int ksiz, uint64_t hash);
+static int32_t tchdbrcsearch(HDBRCSHARD *shard, const char *kbuf, int ksiz, uint64_t hash,
+                             int32_t **pp);
+static int tchdbrcget(TCHDB *hdb, const char *kbuf, int ksiz, HDBRCREC **recp);
+static void tchdbrcput(TCHDB *hdb, const char *kbuf, int ksiz, const char *vbuf, int vsiz);
+static void tchdbrcputneg(TCHDB *hdb, const char *kbuf, int ksiz);
+static void tchdbrcout(TCHDB *hdb, const char *kbuf, int ksiz);
+static void tchdbrcrelease(HDBRCREC *rec);
 static bool tchdbwalinit(TCHDB *hdb);
 static bool tchdbwalwrite(TCHDB *hdb, uint64_t off, int64_t size);
+static bool tchdbwalgroup(TCHDB *hdb, const char *buf, int size);
 static int tchdbwalrestore(TCHDB *hdb, const char *path);
 static bool tchdbwalremove(TCHDB *hdb, const char *path);
+static void tchdbbloomadd(TCHDB *hdb, const char *kbuf, int ksiz);
+static bool tchdbbloomcheck(TCHDB *hdb, const char *kbuf, int ksiz);
+static bool tchdbbloomopen(TCHDB *hdb);
+static bool tchdbbloomload(TCHDB *hdb, const char *path);
+static bool tchdbbloomrebuild(TCHDB *hdb);
+static bool tchdbbloomsave(TCHDB *hdb);
 static bool tchdbopenimpl(TCHDB *hdb, const char *path, int omode);
 static bool tchdbcloseimpl(TCHDB *hdb);
 static bool tchdbputimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
-                         const char *vbuf, int vsiz, int dmode);
+                         const char *vbuf, int vsiz, int dmode, uint32_t xtime);
+static bool tchdbputexpire(TCHDB *hdb, const char *kbuf, int ksiz, const char *vbuf, int vsiz,
+                           uint32_t xtime);
 static void tchdbdrpappend(TCHDB *hdb, const char *kbuf, int ksiz, const char *vbuf, int vsiz,
                            uint8_t hash);
 static bool tchdbputasyncimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
-                              const char *vbuf, int vsiz);
+                              const char *vbuf, int vsiz, int64_t unit);
+static bool tchdbputbatchimpl(TCHDB *hdb, const TCLIST *recs);
 static bool tchdboutimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash);
 static char *tchdbgetimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
                           int *sp);
+static char *tchdbgetpreimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
+                             const char *hbuf, int hsiz, int *sp);
+static bool tchdbgetmultiring(TCHDB *hdb, const TCLIST *keys, TCMAP *recs);
 static int tchdbgetintobuf(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
                            char *vbuf, int max);
+static int tchdbgetoptimistic(TCHDB *hdb, const char *kbuf, int ksiz, char **vbp, int *sp);
+static int tchdbprobecmp(const void *a, const void *b);
+static int tchdbgetoptscan(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
+                           char **vbp, int *sp);
 static char *tchdbgetnextimpl(TCHDB *hdb, const char *kbuf, int ksiz, int *sp,
                               const char **vbp, int *vsp);
 static int tchdbvsizimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash);
+static bool tchdbprefetchimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash);
+static void tchdbwillneed(TCHDB *hdb, uint64_t off, int64_t size);
+static uint64_t tchdbnumanodes(void);
+static void tchdbmemadvise(void *ptr, size_t size, bool huge, uint64_t nodes);
+static void *tchdbmemmap(size_t size, bool huge, uint64_t nodes);
+static void tchdbmapadvise(TCHDB *hdb, uint64_t nodes);
 static bool tchdbiterinitimpl(TCHDB *hdb);
 static char *tchdbiternextimpl(TCHDB *hdb, int *sp);
 static bool tchdbiternextintoxstr(TCHDB *hdb, TCXSTR *kxstr, TCXSTR *vxstr);
 static bool tchdboptimizeimpl(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts);
+static bool tchdboptimize2impl(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts,
+                               int thnum);
+static TCHDB *tchdboptopen(TCHDB *hdb, const char *tpath, int64_t bnum, int8_t apow, int8_t fpow,
+                           uint8_t opts, bool mt);
+static bool tchdboptreplace(TCHDB *hdb, const char *tpath);
+static void tchdbsplitregion(TCHDB *hdb, uint64_t *bounds, int num);
+static void tchdboptsplit(HDBOPT *opt, const char *tpath, int wnum);
+static bool tchdboptload(HDBOPT *opt, const char *tpath);
+static bool tchdboptsave(HDBOPT *opt);
+static bool tchdboptrun(HDBOPT *opt, void *(*func)(void *));
+static void *tchdboptscan(void *arg);
+static void *tchdboptbuild(void *arg);
 static bool tchdbvanishimpl(TCHDB *hdb);
 static bool tchdbcopyimpl(TCHDB *hdb, const char *path);
+static bool tchdbsnapshotimpl(TCHDB *hdb, const char *path);
+static bool tchdbsnaplog(TCHDB *hdb, uint64_t off, int64_t size);
 static bool tchdbdefragimpl(TCHDB *hdb, int64_t step);
+static bool tchdbdfstart(TCHDB *hdb);
+static void tchdbdfstop(TCHDB *hdb);
+static void *tchdbdfworker(void *arg);
+static bool tchdbdfround(TCHDB *hdb);
+static bool tchdbgrowimpl(TCHDB *hdb, int64_t step);
+static bool tchdbsplitbucket(TCHDB *hdb);
 static bool tchdbiterjumpimpl(TCHDB *hdb, const char *kbuf, int ksiz);
-static bool tchdbforeachimpl(TCHDB *hdb, TCITER iter, void *op);
+static bool tchdbforeachimpl(TCHDB *hdb, uint64_t begin, uint64_t end, TCITER iter, void *op);
+static bool tchdbforeachmt(TCHDB *hdb, TCITER iter, void *op, int thnum);
+static bool tchdbforeachiter(const void *kbuf, int ksiz, const void *vbuf, int vsiz, void *op);
+static void *tchdbforeachworker(void *arg);
 static bool tchdblockmethod(TCHDB *hdb, bool wr);
 static bool tchdbunlockmethod(TCHDB *hdb);
-static bool tchdblockrecord(TCHDB *hdb, uint8_t bidx, bool wr);
-static bool tchdbunlockrecord(TCHDB *hdb, uint8_t bidx);
+static bool tchdblockrecord(TCHDB *hdb, uint64_t bidx, bool wr);
+static bool tchdbunlockrecord(TCHDB *hdb, uint64_t bidx);
 static bool tchdblockallrecords(TCHDB *hdb, bool wr);
 static bool tchdbunlockallrecords(TCHDB *hdb);
 static bool tchdblockdb(TCHDB *hdb);
@@ -225,20 +511,23 @@ void tchdbdel(TCHDB *hdb){
   if(hdb->fd >= 0) tchdbclose(hdb);
   if(hdb->mmtx){
     pthread_key_delete(*(pthread_key_t *)hdb->eckey);
+    pthread_cond_destroy(hdb->wcnd);
     pthread_mutex_destroy(hdb->wmtx);
     pthread_mutex_destroy(hdb->tmtx);
     pthread_mutex_destroy(hdb->dmtx);
-    for(int i = UINT8_MAX; i >= 0; i--){
-      pthread_rwlock_destroy((pthread_rwlock_t *)hdb->rmtxs + i);
+    for(int i = hdb->rmtxnum - 1; i >= 0; i--){
+      pthread_rwlock_destroy(&((HDBRLOCK *)hdb->rmtxs)[i].b.rwlock);
     }
     pthread_rwlock_destroy(hdb->mmtx);
     TCFREE(hdb->eckey);
+    TCFREE(hdb->wcnd);
     TCFREE(hdb->wmtx);
     TCFREE(hdb->tmtx);
     TCFREE(hdb->dmtx);
     TCFREE(hdb->rmtxs);
     TCFREE(hdb->mmtx);
   }
+  if(hdb->walque) tcxstrdel(hdb->walque);
   TCFREE(hdb);
 }
 
@@ -253,44 +542,67 @@ int tchdbecode(TCHDB *hdb){
 
 /* Set mutual exclusion control of a hash database object for threading. */
 bool tchdbsetmutex(TCHDB *hdb){
+  assert(hdb);
+  return tchdbsetmutex2(hdb, -1);
+}
+
+
+/* Set mutual exclusion control of a hash database object with the number of record locks. */
+bool tchdbsetmutex2(TCHDB *hdb, int32_t rlnum){
   assert(hdb);
   if(!TCUSEPTHREAD) return true;
   if(hdb->mmtx || hdb->fd >= 0){
     tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
     return false;
   }
+  uint32_t rmtxnum = 1;
+  if(rlnum < 1) rlnum = HDBDEFRLNUM;
+  while(rmtxnum < rlnum && rmtxnum < HDBMAXRLNUM){
+    rmtxnum <<= 1;
+  }
+  void *rmtxs;
+  if(posix_memalign(&rmtxs, HDBRLOCKALIGN, rmtxnum * sizeof(HDBRLOCK)) != 0)
+    tcmyfatal("out of memory");
   pthread_mutexattr_t rma;
   pthread_mutexattr_init(&rma);
   TCMALLOC(hdb->mmtx, sizeof(pthread_rwlock_t));
-  TCMALLOC(hdb->rmtxs, (UINT8_MAX + 1) * sizeof(pthread_rwlock_t));
+  hdb->rmtxs = rmtxs;
+  hdb->rmtxnum = rmtxnum;
   TCMALLOC(hdb->dmtx, sizeof(pthread_mutex_t));
   TCMALLOC(hdb->tmtx, sizeof(pthread_mutex_t));
   TCMALLOC(hdb->wmtx, sizeof(pthread_mutex_t));
+  TCMALLOC(hdb->wcnd, sizeof(pthread_cond_t));
   TCMALLOC(hdb->eckey, sizeof(pthread_key_t));
   bool err = false;
   if(pthread_mutexattr_settype(&rma, PTHREAD_MUTEX_RECURSIVE) != 0) err = true;
   if(pthread_rwlock_init(hdb->mmtx, NULL) != 0) err = true;
-  for(int i = 0; i <= UINT8_MAX; i++){
-    if(pthread_rwlock_init((pthread_rwlock_t *)hdb->rmtxs + i, NULL) != 0) err = true;
+  for(int i = 0; i < rmtxnum; i++){
+    if(pthread_rwlock_init(&((HDBRLOCK *)hdb->rmtxs)[i].b.rwlock, NULL) != 0) err = true;
+    ((HDBRLOCK *)hdb->rmtxs)[i].b.seq = 0;
+    ((HDBRLOCK *)hdb->rmtxs)[i].b.rdnum = 0;
   }
   if(pthread_mutex_init(hdb->dmtx, &rma) != 0) err = true;
   if(pthread_mutex_init(hdb->tmtx, NULL) != 0) err = true;
   if(pthread_mutex_init(hdb->wmtx, NULL) != 0) err = true;
+  if(pthread_cond_init(hdb->wcnd, NULL) != 0) err = true;
   if(pthread_key_create(hdb->eckey, NULL) != 0) err = true;
   if(err){
     tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
     pthread_mutexattr_destroy(&rma);
     TCFREE(hdb->eckey);
+    TCFREE(hdb->wcnd);
     TCFREE(hdb->wmtx);
     TCFREE(hdb->tmtx);
     TCFREE(hdb->dmtx);
     TCFREE(hdb->rmtxs);
     TCFREE(hdb->mmtx);
     hdb->eckey = NULL;
+    hdb->wcnd = NULL;
     hdb->wmtx = NULL;
     hdb->tmtx = NULL;
     hdb->dmtx = NULL;
     hdb->rmtxs = NULL;
+    hdb->rmtxnum = 0;
     hdb->mmtx = NULL;
     return false;
   }
@@ -340,6 +652,18 @@ bool tchdbsetxmsiz(TCHDB *hdb, int64_t xmsiz){
 }
 
 
+/* Set the maximum size of the growable mapped memory of a hash database object. */
+bool tchdbsetxmmax(TCHDB *hdb, int64_t xmmax){
+  assert(hdb);
+  if(hdb->fd >= 0 || sizeof(size_t) < sizeof(uint64_t)){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  hdb->xmmax = (xmmax > 0) ? tcpagealign(xmmax) : 0;
+  return true;
+}
+
+
 /* Set the unit step number of auto defragmentation of a hash database object. */
 bool tchdbsetdfunit(TCHDB *hdb, int32_t dfunit){
   assert(hdb);
@@ -352,6 +676,67 @@ bool tchdbsetdfunit(TCHDB *hdb, int32_t dfunit){
 }
 
 
+/* Set the maximum number of elements of the bucket array of a hash database object. */
+bool tchdbsetbmax(TCHDB *hdb, int64_t bmax){
+  assert(hdb);
+  if(hdb->fd >= 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  hdb->lhmax = (bmax > 0) ? bmax : 0;
+  return true;
+}
+
+
+/* Set the Bloom filter of a hash database object. */
+bool tchdbsetbloom(TCHDB *hdb, int64_t bfnum){
+  assert(hdb);
+  if(hdb->fd >= 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  hdb->bfnum = (bfnum > 0) ? bfnum : 0;
+  return true;
+}
+
+
+/* Set the background defragmentation of a hash database object. */
+bool tchdbsetdfthread(TCHDB *hdb, int32_t step, int32_t msec){
+  assert(hdb);
+  if(hdb->fd >= 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  hdb->dfwstep = (step > 0) ? step : HDBDFWSTEP;
+  hdb->dfwmsec = (msec > 0) ? msec : 0;
+  return true;
+}
+
+
+/* Set the asynchronous I/O ring of a hash database object. */
+bool tchdbsetiodepth(TCHDB *hdb, int32_t depth){
+  assert(hdb);
+  if(hdb->fd >= 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  hdb->iodepth = (depth > 0) ? tclmin(depth, HDBRINGMAXDEPTH) : 0;
+  return true;
+}
+
+
+/* Set the memory options of a hash database object. */
+bool tchdbsetmemopts(TCHDB *hdb, uint8_t mopts){
+  assert(hdb);
+  if(hdb->fd >= 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  hdb->mopts = mopts;
+  return true;
+}
+
+
 /* Open a database file and connect a hash database object. */
 bool tchdbopen(TCHDB *hdb, const char *path, int omode){
   assert(hdb && path);
@@ -387,6 +772,10 @@ bool tchdbopen(TCHDB *hdb, const char *path, int omode){
     TCFREE(rpath);
   }
   HDBUNLOCKMETHOD(hdb);
+  if(rv && !tchdbdfstart(hdb)){
+    tchdbclose(hdb);
+    rv = false;
+  }
   return rv;
 }
 
@@ -394,6 +783,7 @@ bool tchdbopen(TCHDB *hdb, const char *path, int omode){
 /* Close a database object. */
 bool tchdbclose(TCHDB *hdb){
   assert(hdb);
+  tchdbdfstop(hdb);
   if(!HDBLOCKMETHOD(hdb, true)) return false;
   if(hdb->fd < 0){
     tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
@@ -436,6 +826,8 @@ bool tchdbput(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int vsiz
       zbuf = _tc_bzcompress(vbuf, vsiz, &vsiz);
     } else if(hdb->opts & HDBTTCBS){
       zbuf = tcbsencode(vbuf, vsiz, &vsiz);
+    } else if(hdb->opts & HDBTFAST){
+      zbuf = tclzencode(vbuf, vsiz, &vsiz);
     } else {
       zbuf = hdb->enc(vbuf, vsiz, &vsiz, hdb->encop);
     }
@@ -445,19 +837,21 @@ bool tchdbput(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int vsiz
       HDBUNLOCKMETHOD(hdb);
       return false;
     }
-    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBPDOVER);
+    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBPDOVER, 0);
     TCFREE(zbuf);
     HDBUNLOCKRECORD(hdb, bidx);
     HDBUNLOCKMETHOD(hdb);
-    if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+    if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
        !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+    if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
     return rv;
   }
-  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDOVER);
+  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDOVER, 0);
   HDBUNLOCKRECORD(hdb, bidx);
   HDBUNLOCKMETHOD(hdb);
-  if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+  if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
      !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+  if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
   return rv;
 }
 
@@ -469,6 +863,22 @@ bool tchdbput2(TCHDB *hdb, const char *kstr, const char *vstr){
 }
 
 
+/* Store a record with an expiration time into a hash database object. */
+bool tchdbputttl(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int vsiz, int64_t ttl){
+  assert(hdb && kbuf && ksiz >= 0 && vbuf && vsiz >= 0);
+  if(!(hdb->opts & HDBTTTL)){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  uint32_t xtime = 0;
+  if(ttl > 0){
+    int64_t lnum = (int64_t)time(NULL) + ttl;
+    xtime = (lnum < HDBXTKEEP) ? lnum : HDBXTKEEP - 1;
+  }
+  return tchdbputexpire(hdb, kbuf, ksiz, vbuf, vsiz, xtime);
+}
+
+
 /* Store a new record into a hash database object. */
 bool tchdbputkeep(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int vsiz){
   assert(hdb && kbuf && ksiz >= 0 && vbuf && vsiz >= 0);
@@ -496,6 +906,8 @@ bool tchdbputkeep(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int
       zbuf = _tc_bzcompress(vbuf, vsiz, &vsiz);
     } else if(hdb->opts & HDBTTCBS){
       zbuf = tcbsencode(vbuf, vsiz, &vsiz);
+    } else if(hdb->opts & HDBTFAST){
+      zbuf = tclzencode(vbuf, vsiz, &vsiz);
     } else {
       zbuf = hdb->enc(vbuf, vsiz, &vsiz, hdb->encop);
     }
@@ -505,19 +917,21 @@ bool tchdbputkeep(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int
       HDBUNLOCKMETHOD(hdb);
       return false;
     }
-    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBPDKEEP);
+    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBPDKEEP, 0);
     TCFREE(zbuf);
     HDBUNLOCKRECORD(hdb, bidx);
     HDBUNLOCKMETHOD(hdb);
-    if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+    if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
        !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+    if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
     return rv;
   }
-  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDKEEP);
+  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDKEEP, 0);
   HDBUNLOCKRECORD(hdb, bidx);
   HDBUNLOCKMETHOD(hdb);
-  if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+  if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
      !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+  if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
   return rv;
 }
 
@@ -560,6 +974,8 @@ bool tchdbputcat(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int v
         zbuf = _tc_bzcompress(obuf, osiz + vsiz, &vsiz);
       } else if(hdb->opts & HDBTTCBS){
         zbuf = tcbsencode(obuf, osiz + vsiz, &vsiz);
+      } else if(hdb->opts & HDBTFAST){
+        zbuf = tclzencode(obuf, osiz + vsiz, &vsiz);
       } else {
         zbuf = hdb->enc(obuf, osiz + vsiz, &vsiz, hdb->encop);
       }
@@ -571,6 +987,8 @@ bool tchdbputcat(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int v
         zbuf = _tc_bzcompress(vbuf, vsiz, &vsiz);
       } else if(hdb->opts & HDBTTCBS){
         zbuf = tcbsencode(vbuf, vsiz, &vsiz);
+      } else if(hdb->opts & HDBTFAST){
+        zbuf = tclzencode(vbuf, vsiz, &vsiz);
       } else {
         zbuf = hdb->enc(vbuf, vsiz, &vsiz, hdb->encop);
       }
@@ -581,19 +999,21 @@ bool tchdbputcat(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int v
       HDBUNLOCKMETHOD(hdb);
       return false;
     }
-    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBPDOVER);
+    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBPDOVER, HDBXTKEEP);
     TCFREE(zbuf);
     HDBUNLOCKRECORD(hdb, bidx);
     HDBUNLOCKMETHOD(hdb);
-    if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+    if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
        !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+    if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
     return rv;
   }
-  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDCAT);
+  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDCAT, 0);
   HDBUNLOCKRECORD(hdb, bidx);
   HDBUNLOCKMETHOD(hdb);
-  if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+  if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
      !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+  if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
   return rv;
 }
 
@@ -625,6 +1045,8 @@ bool tchdbputasync(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int
       zbuf = _tc_bzcompress(vbuf, vsiz, &vsiz);
     } else if(hdb->opts & HDBTTCBS){
       zbuf = tcbsencode(vbuf, vsiz, &vsiz);
+    } else if(hdb->opts & HDBTFAST){
+      zbuf = tclzencode(vbuf, vsiz, &vsiz);
     } else {
       zbuf = hdb->enc(vbuf, vsiz, &vsiz, hdb->encop);
     }
@@ -633,12 +1055,12 @@ bool tchdbputasync(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int
       HDBUNLOCKMETHOD(hdb);
       return false;
     }
-    bool rv = tchdbputasyncimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz);
+    bool rv = tchdbputasyncimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBDRPUNIT);
     TCFREE(zbuf);
     HDBUNLOCKMETHOD(hdb);
     return rv;
   }
-  bool rv = tchdbputasyncimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz);
+  bool rv = tchdbputasyncimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBDRPUNIT);
   HDBUNLOCKMETHOD(hdb);
   return rv;
 }
@@ -651,6 +1073,28 @@ bool tchdbputasync2(TCHDB *hdb, const char *kstr, const char *vstr){
 }
 
 
+/* Store multiple records into a hash database object at once. */
+bool tchdbputbatch(TCHDB *hdb, const TCLIST *recs){
+  assert(hdb && recs);
+  if(!HDBLOCKMETHOD(hdb, true)) return false;
+  if(hdb->fd < 0 || !(hdb->omode & HDBOWRITER)){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  bool rv = tchdbputbatchimpl(hdb, recs);
+  HDBUNLOCKMETHOD(hdb);
+  if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
+     !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+  if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
+  return rv;
+}
+
+
 /* Remove a record of a hash database object. */
 bool tchdbout(TCHDB *hdb, const void *kbuf, int ksiz){
   assert(hdb && kbuf && ksiz >= 0);
@@ -673,8 +1117,9 @@ bool tchdbout(TCHDB *hdb, const void *kbuf, int ksiz){
   bool rv = tchdboutimpl(hdb, kbuf, ksiz, bidx, hash);
   HDBUNLOCKRECORD(hdb, bidx);
   HDBUNLOCKMETHOD(hdb);
-  if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+  if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
      !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+  if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
   return rv;
 }
 
@@ -689,6 +1134,15 @@ bool tchdbout2(TCHDB *hdb, const char *kstr){
 /* Retrieve a record in a hash database object. */
 void *tchdbget(TCHDB *hdb, const void *kbuf, int ksiz, int *sp){
   assert(hdb && kbuf && ksiz >= 0 && sp);
+  if(hdb->mmtx){
+    char *vbuf;
+    int orv = tchdbgetoptimistic(hdb, kbuf, ksiz, &vbuf, sp);
+    if(orv > 0) return vbuf;
+    if(orv == 0){
+      tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+      return NULL;
+    }
+  }
   if(!HDBLOCKMETHOD(hdb, false)) return NULL;
   uint8_t hash;
   uint64_t bidx = tchdbbidx(hdb, kbuf, ksiz, &hash);
@@ -723,6 +1177,21 @@ char *tchdbget2(TCHDB *hdb, const char *kstr){
 /* Retrieve a record in a hash database object and write the value into a buffer. */
 int tchdbget3(TCHDB *hdb, const void *kbuf, int ksiz, void *vbuf, int max){
   assert(hdb && kbuf && ksiz >= 0 && vbuf && max >= 0);
+  if(hdb->mmtx){
+    char *obuf;
+    int osiz;
+    int orv = tchdbgetoptimistic(hdb, kbuf, ksiz, &obuf, &osiz);
+    if(orv > 0){
+      osiz = tclmin(osiz, max);
+      memcpy(vbuf, obuf, osiz);
+      TCFREE(obuf);
+      return osiz;
+    }
+    if(orv == 0){
+      tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+      return -1;
+    }
+  }
   if(!HDBLOCKMETHOD(hdb, false)) return -1;
   uint8_t hash;
   uint64_t bidx = tchdbbidx(hdb, kbuf, ksiz, &hash);
@@ -746,6 +1215,68 @@ int tchdbget3(TCHDB *hdb, const void *kbuf, int ksiz, void *vbuf, int max){
 }
 
 
+/* Retrieve multiple records in a hash database object at once. */
+bool tchdbgetmulti(TCHDB *hdb, const TCLIST *keys, TCMAP *recs){
+  assert(hdb && keys && recs);
+  if(!HDBLOCKMETHOD(hdb, false)) return false;
+  if(hdb->fd < 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  HDBRING *ring = hdb->ring;
+  if(ring && pthread_mutex_trylock(&ring->mutex) == 0){
+    bool rv = tchdbgetmultiring(hdb, keys, recs);
+    pthread_mutex_unlock(&ring->mutex);
+    HDBUNLOCKMETHOD(hdb);
+    return rv;
+  }
+  int knum = TCLISTNUM(keys);
+  HDBPROBE *probes;
+  TCMALLOC(probes, sizeof(*probes) * knum + 1);
+  for(int i = 0; i < knum; i++){
+    const char *kbuf;
+    int ksiz;
+    TCLISTVAL(kbuf, keys, i, ksiz);
+    HDBPROBE *probe = probes + i;
+    probe->bidx = tchdbbidx(hdb, kbuf, ksiz, &probe->hash);
+    probe->off = tchdbgetbucket(hdb, probe->bidx);
+    probe->kidx = i;
+  }
+  qsort(probes, knum, sizeof(*probes), tchdbprobecmp);
+  for(int i = 0; i < knum; i++){
+    if(probes[i].off + hdb->runit > hdb->xmsiz) tchdbwillneed(hdb, probes[i].off, hdb->runit);
+  }
+  bool err = false;
+  for(int i = 0; !err && i < knum; i++){
+    HDBPROBE *probe = probes + i;
+    const char *kbuf;
+    int ksiz;
+    TCLISTVAL(kbuf, keys, probe->kidx, ksiz);
+    if(!HDBLOCKRECORD(hdb, probe->bidx, false)){
+      err = true;
+      break;
+    }
+    int vsiz;
+    char *vbuf = tchdbgetimpl(hdb, kbuf, ksiz, probe->bidx, probe->hash, &vsiz);
+    HDBUNLOCKRECORD(hdb, probe->bidx);
+    if(vbuf){
+      tcmapput(recs, kbuf, ksiz, vbuf, vsiz);
+      TCFREE(vbuf);
+    } else if(tchdbecode(hdb) != TCENOREC){
+      err = true;
+    }
+  }
+  TCFREE(probes);
+  HDBUNLOCKMETHOD(hdb);
+  return !err;
+}
+
+
 /* Get the size of the value of a record in a hash database object. */
 int tchdbvsiz(TCHDB *hdb, const void *kbuf, int ksiz){
   assert(hdb && kbuf && ksiz >= 0);
@@ -924,6 +1455,8 @@ int tchdbaddint(TCHDB *hdb, const void *kbuf, int ksiz, int num){
       zbuf = _tc_bzcompress((char *)&num, sizeof(num), &zsiz);
     } else if(hdb->opts & HDBTTCBS){
       zbuf = tcbsencode((char *)&num, sizeof(num), &zsiz);
+    } else if(hdb->opts & HDBTFAST){
+      zbuf = tclzencode((char *)&num, sizeof(num), &zsiz);
     } else {
       zbuf = hdb->enc((char *)&num, sizeof(num), &zsiz, hdb->encop);
     }
@@ -933,19 +1466,21 @@ int tchdbaddint(TCHDB *hdb, const void *kbuf, int ksiz, int num){
       HDBUNLOCKMETHOD(hdb);
       return INT_MIN;
     }
-    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, zsiz, HDBPDOVER);
+    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, zsiz, HDBPDOVER, HDBXTKEEP);
     TCFREE(zbuf);
     HDBUNLOCKRECORD(hdb, bidx);
     HDBUNLOCKMETHOD(hdb);
-    if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+    if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
        !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+    if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
     return rv ? num : INT_MIN;
   }
-  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, (char *)&num, sizeof(num), HDBPDADDINT);
+  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, (char *)&num, sizeof(num), HDBPDADDINT, 0);
   HDBUNLOCKRECORD(hdb, bidx);
   HDBUNLOCKMETHOD(hdb);
-  if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+  if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
      !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+  if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
   return rv ? num : INT_MIN;
 }
 
@@ -991,6 +1526,8 @@ double tchdbadddouble(TCHDB *hdb, const void *kbuf, int ksiz, double num){
       zbuf = _tc_bzcompress((char *)&num, sizeof(num), &zsiz);
     } else if(hdb->opts & HDBTTCBS){
       zbuf = tcbsencode((char *)&num, sizeof(num), &zsiz);
+    } else if(hdb->opts & HDBTFAST){
+      zbuf = tclzencode((char *)&num, sizeof(num), &zsiz);
     } else {
       zbuf = hdb->enc((char *)&num, sizeof(num), &zsiz, hdb->encop);
     }
@@ -1000,19 +1537,21 @@ double tchdbadddouble(TCHDB *hdb, const void *kbuf, int ksiz, double num){
       HDBUNLOCKMETHOD(hdb);
       return nan("");
     }
-    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, zsiz, HDBPDOVER);
+    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, zsiz, HDBPDOVER, HDBXTKEEP);
     TCFREE(zbuf);
     HDBUNLOCKRECORD(hdb, bidx);
     HDBUNLOCKMETHOD(hdb);
-    if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+    if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
        !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+    if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
     return rv ? num : nan("");
   }
-  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, (char *)&num, sizeof(num), HDBPDADDDBL);
+  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, (char *)&num, sizeof(num), HDBPDADDDBL, 0);
   HDBUNLOCKRECORD(hdb, bidx);
   HDBUNLOCKMETHOD(hdb);
-  if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+  if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
      !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+  if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
   return rv ? num : nan("");
 }
 
@@ -1056,6 +1595,27 @@ bool tchdboptimize(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t o
 }
 
 
+/* Optimize the file of a hash database object by multiple threads. */
+bool tchdboptimize2(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts,
+                    int thnum){
+  assert(hdb);
+  if(!HDBLOCKMETHOD(hdb, true)) return false;
+  if(hdb->fd < 0 || !(hdb->omode & HDBOWRITER) || hdb->tran){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  HDBTHREADYIELD(hdb);
+  bool rv = tchdboptimize2impl(hdb, bnum, apow, fpow, opts, thnum);
+  HDBUNLOCKMETHOD(hdb);
+  return rv;
+}
+
+
 /* Remove all records of a hash database object. */
 bool tchdbvanish(TCHDB *hdb){
   assert(hdb);
@@ -1101,6 +1661,45 @@ bool tchdbcopy(TCHDB *hdb, const char *path){
 }
 
 
+/* Create a consistent snapshot of the database file of a hash database object online. */
+bool tchdbsnapshot(TCHDB *hdb, const char *path){
+  assert(hdb && path);
+  bool wr = hdb->omode & HDBOWRITER;
+  for(double wsec = 1.0 / sysconf(_SC_CLK_TCK); true; wsec *= 2){
+    if(!HDBLOCKMETHOD(hdb, false)) return false;
+    if(hdb->fd < 0){
+      tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+      HDBUNLOCKMETHOD(hdb);
+      return false;
+    }
+    if(!hdb->tran && !hdb->snap){
+      if(hdb->async && !tchdbflushdrp(hdb)){
+        HDBUNLOCKMETHOD(hdb);
+        return false;
+      }
+      if(!HDBLOCKALLRECORDS(hdb, wr)){
+        HDBUNLOCKMETHOD(hdb);
+        return false;
+      }
+      if(!hdb->snap) break;
+      HDBUNLOCKALLRECORDS(hdb);
+    }
+    HDBUNLOCKMETHOD(hdb);
+    if(wsec > 1.0) wsec = 1.0;
+    tcsleep(wsec);
+  }
+  bool rv;
+  if(wr){
+    rv = tchdbsnapshotimpl(hdb, path);
+  } else {
+    rv = tchdbcopyimpl(hdb, path);
+    HDBUNLOCKALLRECORDS(hdb);
+  }
+  HDBUNLOCKMETHOD(hdb);
+  return rv;
+}
+
+
 /* Begin the transaction of a hash database object. */
 bool tchdbtranbegin(TCHDB *hdb){
   assert(hdb);
@@ -1206,8 +1805,8 @@ bool tchdbtranabort(TCHDB *hdb){
   hdb->dfcur = hdb->frec;
   hdb->iter = 0;
   hdb->xfsiz = 0;
-  hdb->fbpnum = 0;
-  if(hdb->recc) tcmdbvanish(hdb->recc);
+  tchdbfbpclear(hdb);
+  if(hdb->recc) tchdbrcvanish(hdb->recc);
   hdb->tran = false;
   HDBUNLOCKMETHOD(hdb);
   return !err;
@@ -1356,7 +1955,7 @@ bool tchdbcacheclear(TCHDB *hdb){
     tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
     return false;
   }
-  if(hdb->recc) tcmdbvanish(hdb->recc);
+  if(hdb->recc) tchdbrcvanish(hdb->recc);
   return true;
 }
 
@@ -1523,6 +2122,22 @@ bool tchdbsetcodecfunc(TCHDB *hdb, TCCODEC enc, void *encop, TCCODEC dec, void *
 }
 
 
+/* Set the progress function of recovery of a hash database object. */
+bool tchdbsetrcvfunc(TCHDB *hdb, void (*proc)(uint64_t done, uint64_t total, void *op), void *op){
+  assert(hdb);
+  if(!HDBLOCKMETHOD(hdb, true)) return false;
+  if(hdb->fd >= 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  hdb->rcvproc = proc;
+  hdb->rcvop = op;
+  HDBUNLOCKMETHOD(hdb);
+  return true;
+}
+
+
 /* Get the unit step number of auto defragmentation of a hash database object. */
 uint32_t tchdbdfunit(TCHDB *hdb){
   assert(hdb);
@@ -1530,6 +2145,16 @@ uint32_t tchdbdfunit(TCHDB *hdb){
 }
 
 
+/* Get the statistics of the background defragmentation of a hash database object. */
+uint64_t tchdbdfstat(TCHDB *hdb, uint64_t *rnp, uint64_t *snp, uint64_t *usp){
+  assert(hdb && rnp && snp && usp);
+  *rnp = hdb->dfwrnum;
+  *snp = hdb->dfwsnum;
+  *usp = hdb->dfwusec;
+  return hdb->dfcur;
+}
+
+
 /* Perform dynamic defragmentation of a hash database object. */
 bool tchdbdefrag(TCHDB *hdb, int64_t step){
   assert(hdb);
@@ -1582,6 +2207,63 @@ bool tchdbdefrag(TCHDB *hdb, int64_t step){
 }
 
 
+/* Perform defragmentation of a region of a hash database object. */
+bool tchdbdefrag2(TCHDB *hdb, int64_t size){
+  assert(hdb);
+  if(!HDBLOCKMETHOD(hdb, false)) return false;
+  if(hdb->fd < 0 || !(hdb->omode & HDBOWRITER)){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  bool err = false;
+  uint64_t end = UINT64_MAX;
+  if(HDBLOCKALLRECORDS(hdb, true)){
+    if(size > 0 && hdb->dfcur < UINT64_MAX - size) end = hdb->dfcur + size;
+    HDBUNLOCKALLRECORDS(hdb);
+  } else {
+    err = true;
+  }
+  bool stop = false;
+  while(!err && !stop){
+    if(HDBLOCKALLRECORDS(hdb, true)){
+      uint64_t cur = hdb->dfcur;
+      if(!tchdbdefragimpl(hdb, UINT8_MAX)) err = true;
+      if(hdb->dfcur <= cur || hdb->dfcur >= end) stop = true;
+      HDBUNLOCKALLRECORDS(hdb);
+      HDBTHREADYIELD(hdb);
+    } else {
+      err = true;
+    }
+  }
+  HDBUNLOCKMETHOD(hdb);
+  return !err;
+}
+
+
+/* Grow the bucket array of a hash database object incrementally. */
+bool tchdbgrow(TCHDB *hdb, int64_t step){
+  assert(hdb);
+  if(!HDBLOCKMETHOD(hdb, true)) return false;
+  if(hdb->fd < 0 || !(hdb->omode & HDBOWRITER)){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  bool rv = tchdbgrowimpl(hdb, step);
+  HDBUNLOCKMETHOD(hdb);
+  return rv;
+}
+
+
 /* Store a record into a hash database object with a duplication handler. */
 bool tchdbputproc(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int vsiz,
                   TCPDPROC proc, void *op){
@@ -1622,6 +2304,8 @@ bool tchdbputproc(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int
           zbuf = _tc_bzcompress(nbuf, nsiz, &vsiz);
         } else if(hdb->opts & HDBTTCBS){
           zbuf = tcbsencode(nbuf, nsiz, &vsiz);
+        } else if(hdb->opts & HDBTFAST){
+          zbuf = tclzencode(nbuf, nsiz, &vsiz);
         } else {
           zbuf = hdb->enc(nbuf, nsiz, &vsiz, hdb->encop);
         }
@@ -1637,6 +2321,8 @@ bool tchdbputproc(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int
         zbuf = _tc_bzcompress(vbuf, vsiz, &vsiz);
       } else if(hdb->opts & HDBTTCBS){
         zbuf = tcbsencode(vbuf, vsiz, &vsiz);
+      } else if(hdb->opts & HDBTFAST){
+        zbuf = tclzencode(vbuf, vsiz, &vsiz);
       } else {
         zbuf = hdb->enc(vbuf, vsiz, &vsiz, hdb->encop);
       }
@@ -1652,12 +2338,13 @@ bool tchdbputproc(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int
       HDBUNLOCKMETHOD(hdb);
       return false;
     }
-    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBPDOVER);
+    bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBPDOVER, HDBXTKEEP);
     TCFREE(zbuf);
     HDBUNLOCKRECORD(hdb, bidx);
     HDBUNLOCKMETHOD(hdb);
-    if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+    if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
        !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+    if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
     return rv;
   }
   HDBPDPROCOP procop;
@@ -1676,12 +2363,13 @@ bool tchdbputproc(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int
   wp += sizeof(procptr);
   memcpy(wp, kbuf, ksiz);
   kbuf = rbuf + sizeof(procptr);
-  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDPROC);
+  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDPROC, 0);
   if(rbuf != stack) TCFREE(rbuf);
   HDBUNLOCKRECORD(hdb, bidx);
   HDBUNLOCKMETHOD(hdb);
-  if(hdb->dfunit > 0 && hdb->dfcnt > hdb->dfunit &&
+  if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
      !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+  if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
   return rv;
 }
 
@@ -1786,36 +2474,183 @@ bool tchdbforeach(TCHDB *hdb, TCITER iter, void *op){
     return false;
   }
   HDBTHREADYIELD(hdb);
-  bool rv = tchdbforeachimpl(hdb, iter, op);
+  bool rv = tchdbforeachimpl(hdb, hdb->frec, hdb->fsiz, iter, op);
   HDBUNLOCKALLRECORDS(hdb);
   HDBUNLOCKMETHOD(hdb);
   return rv;
 }
 
 
-/* Void the transaction of a hash database object. */
-bool tchdbtranvoid(TCHDB *hdb){
-  assert(hdb);
-  if(!HDBLOCKMETHOD(hdb, true)) return false;
-  if(hdb->fd < 0 || !(hdb->omode & HDBOWRITER) || hdb->fatal || !hdb->tran){
+/* Split the record region of a hash database object into ranges for partitioned iteration. */
+bool tchdbforeachsplit(TCHDB *hdb, uint64_t *bounds, int num){
+  assert(hdb && bounds);
+  if(!HDBLOCKMETHOD(hdb, false)) return false;
+  if(hdb->fd < 0 || num < 1){
     tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
     HDBUNLOCKMETHOD(hdb);
     return false;
   }
-  hdb->tran = false;
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  tchdbsplitregion(hdb, bounds, num);
   HDBUNLOCKMETHOD(hdb);
   return true;
 }
 
 
-
-/*************************************************************************************************
- * private features
- *************************************************************************************************/
-
-
-/* Get a natural prime number not less than a floor number.
-   `num' specified the floor number.
+/* Process each record atomically in a range of a hash database object. */
+bool tchdbforeachrange(TCHDB *hdb, uint64_t begin, uint64_t end, TCITER iter, void *op){
+  assert(hdb && iter);
+  if(!HDBLOCKMETHOD(hdb, false)) return false;
+  if(hdb->fd < 0 || begin < hdb->frec){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(end > hdb->fsiz) end = hdb->fsiz;
+  if(begin >= end){
+    HDBUNLOCKMETHOD(hdb);
+    return true;
+  }
+  if(!HDBLOCKALLRECORDS(hdb, false)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  HDBTHREADYIELD(hdb);
+  bool rv = tchdbforeachimpl(hdb, begin, end, iter, op);
+  HDBUNLOCKALLRECORDS(hdb);
+  HDBUNLOCKMETHOD(hdb);
+  return rv;
+}
+
+
+/* Process each record of a hash database object with multiple threads. */
+bool tchdbforeach2(TCHDB *hdb, TCITER iter, void *op, int thnum){
+  assert(hdb && iter);
+  if(!HDBLOCKMETHOD(hdb, false)) return false;
+  if(hdb->fd < 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(!HDBLOCKALLRECORDS(hdb, false)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  HDBTHREADYIELD(hdb);
+  bool rv = tchdbforeachmt(hdb, iter, op, thnum);
+  HDBUNLOCKALLRECORDS(hdb);
+  HDBUNLOCKMETHOD(hdb);
+  return rv;
+}
+
+
+/* Void the transaction of a hash database object. */
+bool tchdbtranvoid(TCHDB *hdb){
+  assert(hdb);
+  if(!HDBLOCKMETHOD(hdb, true)) return false;
+  if(hdb->fd < 0 || !(hdb->omode & HDBOWRITER) || hdb->fatal || !hdb->tran){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  hdb->tran = false;
+  HDBUNLOCKMETHOD(hdb);
+  return true;
+}
+
+
+/* Advise the operating system to read ahead a record of a hash database object. */
+bool tchdbprefetch(TCHDB *hdb, const void *kbuf, int ksiz){
+  assert(hdb && kbuf && ksiz >= 0);
+  if(!HDBLOCKMETHOD(hdb, false)) return false;
+  uint8_t hash;
+  uint64_t bidx = tchdbbidx(hdb, kbuf, ksiz, &hash);
+  if(hdb->fd < 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(!HDBLOCKRECORD(hdb, bidx, false)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  bool rv = tchdbprefetchimpl(hdb, kbuf, ksiz, bidx, hash);
+  HDBUNLOCKRECORD(hdb, bidx);
+  HDBUNLOCKMETHOD(hdb);
+  return rv;
+}
+
+
+/* Advise the operating system to read ahead multiple records of a hash database object. */
+bool tchdbprefetchmulti(TCHDB *hdb, const TCLIST *keys){
+  assert(hdb && keys);
+  if(!HDBLOCKMETHOD(hdb, false)) return false;
+  if(hdb->fd < 0){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  int knum = TCLISTNUM(keys);
+  HDBPROBE *probes;
+  TCMALLOC(probes, sizeof(*probes) * knum + 1);
+  for(int i = 0; i < knum; i++){
+    const char *kbuf;
+    int ksiz;
+    TCLISTVAL(kbuf, keys, i, ksiz);
+    HDBPROBE *probe = probes + i;
+    probe->bidx = tchdbbidx(hdb, kbuf, ksiz, &probe->hash);
+    probe->off = tchdbgetbucket(hdb, probe->bidx);
+    probe->kidx = i;
+    if(probe->off > 0) tchdbwillneed(hdb, probe->off, hdb->runit);
+  }
+  bool err = false;
+  for(int i = 0; !err && i < knum; i++){
+    HDBPROBE *probe = probes + i;
+    if(probe->off < 1) continue;
+    const char *kbuf;
+    int ksiz;
+    TCLISTVAL(kbuf, keys, probe->kidx, ksiz);
+    if(!HDBLOCKRECORD(hdb, probe->bidx, false)){
+      err = true;
+      break;
+    }
+    if(!tchdbprefetchimpl(hdb, kbuf, ksiz, probe->bidx, probe->hash) &&
+       tchdbecode(hdb) != TCENOREC) err = true;
+    HDBUNLOCKRECORD(hdb, probe->bidx);
+  }
+  TCFREE(probes);
+  HDBUNLOCKMETHOD(hdb);
+  return !err;
+}
+
+
+
+/*************************************************************************************************
+ * private features
+ *************************************************************************************************/
+
+
+/* Get a natural prime number not less than a floor number.
+   `num' specified the floor number.
    The return value is a prime number not less than the floor number. */
 static uint64_t tcgetprime(uint64_t num){
   uint64_t primes[] = {
@@ -1861,16 +2696,19 @@ static uint64_t tcgetprime(uint64_t num){
    The return value is true if successful, else, it is false. */
 static bool tchdbseekwrite(TCHDB *hdb, off_t off, const void *buf, size_t size){
   assert(hdb && off >= 0 && buf && size >= 0);
+  if(!hdb->genup && !tchdbadvancegen(hdb)) return false;
   if(hdb->tran && !tchdbwalwrite(hdb, off, size)) return false;
+  if(hdb->snap && !tchdbsnaplog(hdb, off, size)) return false;
   off_t end = off + size;
+  if(end > hdb->xmsiz && end <= hdb->xmlen && !tchdbgrowmap(hdb, end)) return false;
   if(end <= hdb->xmsiz){
-    if(end >= hdb->fsiz && end >= hdb->xfsiz){
-      uint64_t xfsiz = end + HDBXFSIZINC;
-      if(ftruncate(hdb->fd, xfsiz) == -1){
-        tchdbsetecode(hdb, TCETRUNC, __FILE__, __LINE__, __func__);
+    if(end >= hdb->xfsiz){
+      if(!HDBLOCKDB(hdb)) return false;
+      if(end >= hdb->xfsiz && !tchdbextendfile(hdb, end)){
+        HDBUNLOCKDB(hdb);
         return false;
       }
-      hdb->xfsiz = xfsiz;
+      HDBUNLOCKDB(hdb);
     }
     memcpy(hdb->map + off, buf, size);
     return true;
@@ -1906,6 +2744,48 @@ static bool tchdbseekwrite(TCHDB *hdb, off_t off, const void *buf, size_t size){
 }
 
 
+/* Grow the window of the mapped memory of a hash database object.
+   `hdb' specifies the hash database object.
+   `end' specifies the end offset to be covered by the window.
+   If successful, the return value is true, else, it is false.
+   The whole region up to the maximum size has been mapped on opening, so growing the window does
+   not move the mapping and readers without locks only see a stale size.  The file is extended
+   beforehand, because records reserved beyond the window are not written yet and the pages of
+   the window past the end of the file would fault. */
+static bool tchdbgrowmap(TCHDB *hdb, uint64_t end){
+  assert(hdb);
+  if(!HDBLOCKDB(hdb)) return false;
+  if(end > hdb->xmsiz){
+    if(tclmax(end, hdb->fsiz) >= hdb->xfsiz && !tchdbextendfile(hdb, end)){
+      HDBUNLOCKDB(hdb);
+      return false;
+    }
+    uint64_t xmsiz = tcpagealign(tclmax(hdb->xmsiz * 2, end));
+    hdb->xmsiz = tclmin(xmsiz, hdb->xmlen);
+  }
+  HDBUNLOCKDB(hdb);
+  return true;
+}
+
+
+/* Extend the file of a hash database object to cover a region and every reserved record.
+   `hdb' specifies the hash database object.
+   `end' specifies the end offset to be covered.
+   If successful, the return value is true, else, it is false.
+   The database lock should be held.  The file is never shortened below the reserved size,
+   which can be beyond `end' when other threads have reserved records after it. */
+static bool tchdbextendfile(TCHDB *hdb, uint64_t end){
+  assert(hdb);
+  uint64_t xfsiz = tclmax(end, hdb->fsiz) + HDBXFSIZINC;
+  if(ftruncate(hdb->fd, xfsiz) == -1){
+    tchdbsetecode(hdb, TCETRUNC, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  hdb->xfsiz = xfsiz;
+  return true;
+}
+
+
 /* Seek and read data from a file.
    `hdb' specifies the hash database object.
    `off' specifies the offset of the region to seek.
@@ -1977,13 +2857,273 @@ static bool tchdbseekreadtry(TCHDB *hdb, off_t off, void *buf, size_t size){
 }
 
 
+/* Seek and read the leading part of a region from a file.
+   `hdb' specifies the hash database object.
+   `off' specifies the offset of the region to seek.
+   `buf' specifies the buffer to store into.
+   `size' specifies the size of the buffer.
+   The return value is the size of the read data, or -1 on failure.
+   Reading stops at the end of the file, because the tail of the region can have been reserved by
+   another thread which has not written it yet. */
+static int tchdbseekreadpart(TCHDB *hdb, off_t off, void *buf, int size){
+  assert(hdb && off >= 0 && buf && size >= 0);
+  if(off + size <= hdb->xmsiz){
+    memcpy(buf, hdb->map + off, size);
+    return size;
+  }
+  int rsiz = 0;
+  if(!TCUBCACHE && off < hdb->xmsiz){
+    rsiz = hdb->xmsiz - off;
+    memcpy(buf, hdb->map + off, rsiz);
+  }
+  while(rsiz < size){
+    int rb = pread(hdb->fd, (char *)buf + rsiz, size - rsiz, off + rsiz);
+    if(rb > 0){
+      rsiz += rb;
+    } else if(rb == 0){
+      break;
+    } else if(errno != EINTR){
+      tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
+      return -1;
+    }
+  }
+  return rsiz;
+}
+
+
+/* Seek and write a large region through the asynchronous I/O ring.
+   `hdb' specifies the hash database object.
+   `off' specifies the offset of the region to seek.
+   `buf' specifies the buffer to write.
+   `size' specifies the size of the buffer.
+   The return value is true if successful, else, it is false.
+   The region is split into units which are kept in flight at once.  If the ring is not available
+   or busy, or the region fits in the mapped memory, it is written by `tchdbseekwrite'. */
+static bool tchdbseekwritebatch(TCHDB *hdb, off_t off, const void *buf, size_t size){
+  assert(hdb && off >= 0 && buf && size >= 0);
+  HDBRING *ring = hdb->ring;
+  if(!ring || size <= HDBRINGWUNIT || off + size <= hdb->xmlen ||
+     pthread_mutex_trylock(&ring->mutex) != 0) return tchdbseekwrite(hdb, off, buf, size);
+  bool err = false;
+  if(!hdb->genup && !tchdbadvancegen(hdb)) err = true;
+  if(hdb->tran && !tchdbwalwrite(hdb, off, size)) err = true;
+  if(hdb->snap && !tchdbsnaplog(hdb, off, size)) err = true;
+  const char *rp = buf;
+  while(!err && size > 0){
+    int num = 0;
+    while(num < ring->depth && size > 0){
+      HDBIOREQ *req = ring->reqs + num++;
+      req->off = off;
+      req->buf = (char *)rp;
+      req->size = tclmin(size, HDBRINGWUNIT);
+      off += req->size;
+      rp += req->size;
+      size -= req->size;
+    }
+    if(!tchdbringio(hdb, ring->reqs, num, true)) err = true;
+  }
+  pthread_mutex_unlock(&ring->mutex);
+  return !err;
+}
+
+
+/* Create an asynchronous I/O ring.
+   `depth' specifies the number of requests in flight at once.
+   The return value is the new ring object or `NULL' if the ring is not available.
+   The ring has a slot of the size of an I/O buffer for each entry and the region of the slots is
+   registered to the kernel if the limit of locked memory allows it. */
+static HDBRING *tchdbringnew(int32_t depth){
+  assert(depth > 0);
+#if TCUSEURING
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = syscall(__NR_io_uring_setup, tclmin(depth, HDBRINGMAXDEPTH), &params);
+  if(fd == -1) return NULL;
+  HDBRING *ring;
+  TCMALLOC(ring, sizeof(*ring));
+  memset(ring, 0, sizeof(*ring));
+  if(pthread_mutex_init(&ring->mutex, NULL) != 0) tcmyfatal("pthread_mutex_init failed");
+  ring->fd = fd;
+  ring->depth = params.sq_entries;
+  ring->sqlen = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  ring->cqlen = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+  if(single) ring->sqlen = ring->cqlen = tclmax(ring->sqlen, ring->cqlen);
+  void *map = mmap(0, ring->sqlen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   fd, IORING_OFF_SQ_RING);
+  if(map == MAP_FAILED){
+    tchdbringdel(ring);
+    return NULL;
+  }
+  ring->sqmap = map;
+  if(single){
+    ring->cqmap = ring->sqmap;
+  } else {
+    map = mmap(0, ring->cqlen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+               fd, IORING_OFF_CQ_RING);
+    if(map == MAP_FAILED){
+      tchdbringdel(ring);
+      return NULL;
+    }
+    ring->cqmap = map;
+  }
+  ring->sqelen = params.sq_entries * sizeof(struct io_uring_sqe);
+  map = mmap(0, ring->sqelen, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+             fd, IORING_OFF_SQES);
+  if(map == MAP_FAILED){
+    tchdbringdel(ring);
+    return NULL;
+  }
+  ring->sqes = map;
+  ring->sqtail = (uint32_t *)(ring->sqmap + params.sq_off.tail);
+  ring->sqmask = (uint32_t *)(ring->sqmap + params.sq_off.ring_mask);
+  ring->sqarray = (uint32_t *)(ring->sqmap + params.sq_off.array);
+  ring->cqhead = (uint32_t *)(ring->cqmap + params.cq_off.head);
+  ring->cqtail = (uint32_t *)(ring->cqmap + params.cq_off.tail);
+  ring->cqmask = (uint32_t *)(ring->cqmap + params.cq_off.ring_mask);
+  ring->cqes = ring->cqmap + params.cq_off.cqes;
+  ring->bsiz = ring->depth * HDBIOBUFSIZ;
+  TCMALLOC(ring->bufs, ring->bsiz);
+  TCMALLOC(ring->reqs, sizeof(*ring->reqs) * ring->depth);
+  struct iovec iov;
+  iov.iov_base = ring->bufs;
+  iov.iov_len = ring->bsiz;
+  ring->fixed = syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, &iov, 1) == 0;
+  struct io_uring_sqe *sqe = ring->sqes;
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = IORING_OP_NOP;
+  ring->sqarray[0] = 0;
+  __atomic_store_n(ring->sqtail, *ring->sqtail + 1, __ATOMIC_RELEASE);
+  int rv;
+  do {
+    rv = syscall(__NR_io_uring_enter, fd, 1, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+  } while(rv == -1 && errno == EINTR);
+  if(rv != 1){
+    tchdbringdel(ring);
+    return NULL;
+  }
+  __atomic_store_n(ring->cqhead, *ring->cqhead + 1, __ATOMIC_RELEASE);
+  return ring;
+#else
+  return NULL;
+#endif
+}
+
+
+/* Delete an asynchronous I/O ring.
+   `ring' specifies the ring object. */
+static void tchdbringdel(HDBRING *ring){
+  assert(ring);
+  if(ring->sqes) munmap(ring->sqes, ring->sqelen);
+  if(ring->cqmap && ring->cqmap != ring->sqmap) munmap(ring->cqmap, ring->cqlen);
+  if(ring->sqmap) munmap(ring->sqmap, ring->sqlen);
+  close(ring->fd);
+  TCFREE(ring->reqs);
+  TCFREE(ring->bufs);
+  pthread_mutex_destroy(&ring->mutex);
+  TCFREE(ring);
+}
+
+
+/* Perform requests through the asynchronous I/O ring.
+   `hdb' specifies the hash database object.
+   `reqs' specifies the array of the requests.
+   `num' specifies the number of the requests.  It should not be more than the depth of the ring.
+   `wr' specifies whether the requests write or read.
+   The return value is true if successful, else, it is false.
+   The caller should hold the mutex of the ring.  The number of transferred bytes is stored into
+   the `done' member of each request.  The rest of a request which the ring has failed or
+   transferred partially is done by the usual system calls, so reading is short only at the end
+   of the file.  The ring is marked dead when submission fails and is not used any more. */
+static bool tchdbringio(TCHDB *hdb, HDBIOREQ *reqs, int num, bool wr){
+  assert(hdb && reqs && num >= 0);
+  HDBRING *ring = hdb->ring;
+  for(int i = 0; i < num; i++){
+    reqs[i].done = 0;
+  }
+#if TCUSEURING
+  if(!ring->dead && num > 0){
+    struct io_uring_sqe *sqes = ring->sqes;
+    struct io_uring_cqe *cqes = ring->cqes;
+    uint32_t tail = *ring->sqtail;
+    uint32_t mask = *ring->sqmask;
+    for(int i = 0; i < num; i++){
+      HDBIOREQ *req = reqs + i;
+      uint32_t idx = tail++ & mask;
+      struct io_uring_sqe *sqe = sqes + idx;
+      memset(sqe, 0, sizeof(*sqe));
+      if(ring->fixed && req->buf >= ring->bufs && req->buf + req->size <= ring->bufs + ring->bsiz){
+        sqe->opcode = wr ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+        sqe->buf_index = 0;
+      } else {
+        sqe->opcode = wr ? IORING_OP_WRITE : IORING_OP_READ;
+      }
+      sqe->fd = hdb->fd;
+      sqe->off = req->off;
+      sqe->addr = (uintptr_t)req->buf;
+      sqe->len = req->size;
+      sqe->user_data = i;
+      ring->sqarray[idx] = idx;
+    }
+    __atomic_store_n(ring->sqtail, tail, __ATOMIC_RELEASE);
+    int wnum = num;
+    int rest = num;
+    while(rest > 0){
+      int rv = syscall(__NR_io_uring_enter, ring->fd, wnum, rest, IORING_ENTER_GETEVENTS,
+                       NULL, 0);
+      if(rv == -1){
+        if(errno == EINTR || errno == EAGAIN || errno == EBUSY) continue;
+        ring->dead = true;
+        break;
+      }
+      wnum -= tclmin(rv, wnum);
+      uint32_t head = *ring->cqhead;
+      uint32_t end = __atomic_load_n(ring->cqtail, __ATOMIC_ACQUIRE);
+      while(head != end){
+        struct io_uring_cqe *cqe = cqes + (head++ & *ring->cqmask);
+        if(cqe->user_data < (uint64_t)num && cqe->res > 0) reqs[cqe->user_data].done = cqe->res;
+        rest--;
+      }
+      __atomic_store_n(ring->cqhead, head, __ATOMIC_RELEASE);
+    }
+  }
+#endif
+  for(int i = 0; i < num; i++){
+    HDBIOREQ *req = reqs + i;
+    while(req->done < req->size){
+      int rb = wr ? pwrite(hdb->fd, req->buf + req->done, req->size - req->done,
+                           req->off + req->done) :
+        pread(hdb->fd, req->buf + req->done, req->size - req->done, req->off + req->done);
+      if(rb > 0){
+        req->done += rb;
+      } else if(rb == -1){
+        if(errno != EINTR){
+          tchdbsetecode(hdb, wr ? TCEWRITE : TCEREAD, __FILE__, __LINE__, __func__);
+          return false;
+        }
+      } else if(wr){
+        tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+        return false;
+      } else {
+        break;
+      }
+    }
+  }
+  return true;
+}
+
+
 /* Serialize meta data into a buffer.
    `hdb' specifies the hash database object.
-   `hbuf' specifies the buffer. */
+   `hbuf' specifies the buffer.
+   If the file uses a feature which changes the places of records, the type is marked with the
+   extended format so that older versions of the library refuse to open it. */
 static void tchdbdumpmeta(TCHDB *hdb, char *hbuf){
   memset(hbuf, 0, HDBHEADSIZ);
   sprintf(hbuf, "%s\n%s:%d\n", HDBMAGICDATA, _TC_FORMATVER, _TC_LIBVER);
-  memcpy(hbuf + HDBTYPEOFF, &(hdb->type), sizeof(hdb->type));
+  uint8_t type = hdb->type;
+  if((hdb->opts & (HDBTFAST | HDBTXHASH | HDBTTTL)) || hdb->lhbase > 0) type |= HDBTYPEEXT;
+  memcpy(hbuf + HDBTYPEOFF, &type, sizeof(type));
   memcpy(hbuf + HDBFLAGSOFF, &(hdb->flags), sizeof(hdb->flags));
   memcpy(hbuf + HDBAPOWOFF, &(hdb->apow), sizeof(hdb->apow));
   memcpy(hbuf + HDBFPOWOFF, &(hdb->fpow), sizeof(hdb->fpow));
@@ -2001,6 +3141,15 @@ static void tchdbdumpmeta(TCHDB *hdb, char *hbuf){
   llnum = hdb->frec;
   llnum = TCHTOILL(llnum);
   memcpy(hbuf + HDBFRECOFF, &llnum, sizeof(llnum));
+  llnum = hdb->lhbase;
+  llnum = TCHTOILL(llnum);
+  memcpy(hbuf + HDBLHBASEOFF, &llnum, sizeof(llnum));
+  llnum = hdb->lhbase > 0 ? hdb->lhmax : 0;
+  llnum = TCHTOILL(llnum);
+  memcpy(hbuf + HDBLHMAXOFF, &llnum, sizeof(llnum));
+  llnum = hdb->gen;
+  llnum = TCHTOILL(llnum);
+  memcpy(hbuf + HDBGENOFF, &llnum, sizeof(llnum));
 }
 
 
@@ -2009,6 +3158,7 @@ static void tchdbdumpmeta(TCHDB *hdb, char *hbuf){
    `hbuf' specifies the buffer. */
 static void tchdbloadmeta(TCHDB *hdb, const char *hbuf){
   memcpy(&(hdb->type), hbuf + HDBTYPEOFF, sizeof(hdb->type));
+  hdb->type &= ~HDBTYPEEXT;
   memcpy(&(hdb->flags), hbuf + HDBFLAGSOFF, sizeof(hdb->flags));
   memcpy(&(hdb->apow), hbuf + HDBAPOWOFF, sizeof(hdb->apow));
   memcpy(&(hdb->fpow), hbuf + HDBFPOWOFF, sizeof(hdb->fpow));
@@ -2022,6 +3172,18 @@ static void tchdbloadmeta(TCHDB *hdb, const char *hbuf){
   hdb->fsiz = TCITOHLL(llnum);
   memcpy(&llnum, hbuf + HDBFRECOFF, sizeof(llnum));
   hdb->frec = TCITOHLL(llnum);
+  memcpy(&llnum, hbuf + HDBLHBASEOFF, sizeof(llnum));
+  hdb->lhbase = TCITOHLL(llnum);
+  memcpy(&llnum, hbuf + HDBLHMAXOFF, sizeof(llnum));
+  hdb->lhmax = TCITOHLL(llnum);
+  memcpy(&llnum, hbuf + HDBGENOFF, sizeof(llnum));
+  hdb->gen = TCITOHLL(llnum);
+  hdb->lhspan = hdb->lhbase;
+  if(hdb->lhbase > 0){
+    while(hdb->lhspan <= hdb->bnum / 2){
+      hdb->lhspan *= 2;
+    }
+  }
 }
 
 
@@ -2031,14 +3193,20 @@ static void tchdbclear(TCHDB *hdb){
   assert(hdb);
   hdb->mmtx = NULL;
   hdb->rmtxs = NULL;
+  hdb->rmtxnum = 0;
+  hdb->mseq = 0;
   hdb->dmtx = NULL;
   hdb->tmtx = NULL;
   hdb->wmtx = NULL;
+  hdb->wcnd = NULL;
   hdb->eckey = NULL;
   hdb->rpath = NULL;
   hdb->type = TCDBTHASH;
   hdb->flags = 0;
   hdb->bnum = HDBDEFBNUM;
+  hdb->lhbase = 0;
+  hdb->lhmax = 0;
+  hdb->lhspan = 0;
   hdb->apow = HDBDEFAPOW;
   hdb->fpow = HDBDEFFPOW;
   hdb->opts = 0;
@@ -2053,6 +3221,8 @@ static void tchdbclear(TCHDB *hdb){
   hdb->map = NULL;
   hdb->msiz = 0;
   hdb->xmsiz = HDBDEFXMSIZ;
+  hdb->xmmax = 0;
+  hdb->xmlen = 0;
   hdb->xfsiz = 0;
   hdb->ba32 = NULL;
   hdb->ba64 = NULL;
@@ -2063,6 +3233,7 @@ static void tchdbclear(TCHDB *hdb){
   hdb->fbpool = NULL;
   hdb->fbpnum = 0;
   hdb->fbpmis = 0;
+  hdb->fbplazy = false;
   hdb->async = false;
   hdb->drpool = NULL;
   hdb->drpdef = NULL;
@@ -2073,15 +3244,38 @@ static void tchdbclear(TCHDB *hdb){
   hdb->encop = NULL;
   hdb->dec = NULL;
   hdb->decop = NULL;
+  hdb->rcvproc = NULL;
+  hdb->rcvop = NULL;
   hdb->ecode = TCESUCCESS;
   hdb->fatal = false;
   hdb->inode = 0;
   hdb->mtime = 0;
+  hdb->gen = 0;
+  hdb->genup = false;
   hdb->dfunit = 0;
   hdb->dfcnt = 0;
+  hdb->bfnum = 0;
+  hdb->bloom = NULL;
+  hdb->bfbnum = 0;
+  hdb->dfwstep = HDBDFWSTEP;
+  hdb->dfwmsec = 0;
+  hdb->dfworker = NULL;
+  hdb->dfwrnum = 0;
+  hdb->dfwsnum = 0;
+  hdb->dfwusec = 0;
   hdb->tran = false;
   hdb->walfd = -1;
   hdb->walend = 0;
+  hdb->walque = NULL;
+  hdb->walqnum = 0;
+  hdb->walsnum = 0;
+  hdb->walsync = false;
+  hdb->snap = NULL;
+  hdb->iodepth = 0;
+  hdb->ring = NULL;
+  hdb->mopts = 0;
+  hdb->bamirror = NULL;
+  hdb->bmsiz = 0;
   hdb->dbgfd = -1;
   hdb->cnt_writerec = -1;
   hdb->cnt_reuserec = -1;
@@ -2131,6 +3325,16 @@ static int32_t tchdbpadsize(TCHDB *hdb, uint64_t off){
 }
 
 
+/* Check whether an expiration time has passed.
+   `hdb' specifies the hash database object.
+   `xtime' specifies the expiration time of a record.
+   The return value is true if the record has expired, else, it is false. */
+static bool tchdbexpired(TCHDB *hdb, uint32_t xtime){
+  assert(hdb);
+  return xtime > 0 && (hdb->opts & HDBTTTL) && xtime <= (uint32_t)time(NULL);
+}
+
+
 /* Set the open flag.
    `hdb' specifies the hash database object.
    `flag' specifies the flag value.
@@ -2147,6 +3351,25 @@ static void tchdbsetflag(TCHDB *hdb, int flag, bool sign){
 }
 
 
+/* Advance the generation number of a hash database object at its first update.
+   `hdb' specifies the hash database object.
+   If successful, the return value is true, else, it is false.
+   The generation number is advanced once for each connection as a writer which updates the
+   file, so that a saved state of the file can be told from any later update. */
+static bool tchdbadvancegen(TCHDB *hdb){
+  assert(hdb);
+  if(!HDBLOCKDB(hdb)) return false;
+  if(!hdb->genup){
+    hdb->gen++;
+    uint64_t llnum = TCHTOILL(hdb->gen);
+    memcpy(hdb->map + HDBGENOFF, &llnum, sizeof(llnum));
+    hdb->genup = true;
+  }
+  HDBUNLOCKDB(hdb);
+  return true;
+}
+
+
 /* Get the bucket index of a record.
    `hdb' specifies the hash database object.
    `kbuf' specifies the pointer to the region of the key.
@@ -2155,6 +3378,26 @@ static void tchdbsetflag(TCHDB *hdb, int flag, bool sign){
    The return value is the bucket index. */
 static uint64_t tchdbbidx(TCHDB *hdb, const char *kbuf, int ksiz, uint8_t *hp){
   assert(hdb && kbuf && ksiz >= 0 && hp);
+  uint64_t idx = tchdbhashidx(hdb, kbuf, ksiz, hp);
+  if(hdb->lhbase > 0) return tchdblhaddr(hdb, idx);
+  if((hdb->opts & HDBTXHASH) && hdb->bnum <= UINT32_MAX) return ((idx >> 32) * hdb->bnum) >> 32;
+  return idx % hdb->bnum;
+}
+
+
+/* Calculate the hash value of a key before it is mapped to a bucket.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `hp' specifies the pointer to the variable into which the second hash value is assigned.
+   The return value is the 64-bit hash value. */
+static uint64_t tchdbhashidx(TCHDB *hdb, const char *kbuf, int ksiz, uint8_t *hp){
+  assert(hdb && kbuf && ksiz >= 0 && hp);
+  if(hdb->opts & HDBTXHASH){
+    uint64_t hash = tchdbxhash(kbuf, ksiz);
+    *hp = hash;
+    return hash;
+  }
   uint64_t idx = 19780211;
   uint32_t hash = 751;
   const char *rp = kbuf + ksiz;
@@ -2163,7 +3406,86 @@ static uint64_t tchdbbidx(TCHDB *hdb, const char *kbuf, int ksiz, uint8_t *hp){
     hash = (hash * 31) ^ *(uint8_t *)--rp;
   }
   *hp = hash;
-  return idx % hdb->bnum;
+  return idx;
+}
+
+
+/* Map a hash value to a bucket by linear hashing.
+   `hdb' specifies the hash database object.
+   `idx' specifies the 64-bit hash value.
+   The return value is the bucket index.
+   Buckets before the split pointer have already been split in the current round, so they are
+   addressed with the doubled span. */
+static uint64_t tchdblhaddr(TCHDB *hdb, uint64_t idx){
+  assert(hdb);
+  uint64_t bidx = idx % hdb->lhspan;
+  if(bidx < hdb->bnum - hdb->lhspan) bidx = idx % (hdb->lhspan * 2);
+  return bidx;
+}
+
+
+/* Calculate the word-at-a-time hash value of a key.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   The return value is the 64-bit hash value.
+   This is the XXH64 algorithm.  Words are read in little endian so that the value does not
+   depend on the platform. */
+static uint64_t tchdbxhash(const char *kbuf, int ksiz){
+  assert(kbuf && ksiz >= 0);
+  const unsigned char *rp = (const unsigned char *)kbuf;
+  const unsigned char *ep = rp + ksiz;
+  uint64_t hash, lane;
+  if(ksiz >= 32){
+    uint64_t v1 = HDBXHSEED + HDBXHPRIME1 + HDBXHPRIME2;
+    uint64_t v2 = HDBXHSEED + HDBXHPRIME2;
+    uint64_t v3 = HDBXHSEED;
+    uint64_t v4 = HDBXHSEED - HDBXHPRIME1;
+    const unsigned char *lp = ep - 32;
+    while(rp <= lp){
+      memcpy(&lane, rp, sizeof(lane));
+      HDBXHROUND(v1, TCITOHLL(lane));
+      memcpy(&lane, rp + 8, sizeof(lane));
+      HDBXHROUND(v2, TCITOHLL(lane));
+      memcpy(&lane, rp + 16, sizeof(lane));
+      HDBXHROUND(v3, TCITOHLL(lane));
+      memcpy(&lane, rp + 24, sizeof(lane));
+      HDBXHROUND(v4, TCITOHLL(lane));
+      rp += 32;
+    }
+    hash = HDBXHROTL(v1, 1) + HDBXHROTL(v2, 7) + HDBXHROTL(v3, 12) + HDBXHROTL(v4, 18);
+    HDBXHMERGE(hash, v1);
+    HDBXHMERGE(hash, v2);
+    HDBXHMERGE(hash, v3);
+    HDBXHMERGE(hash, v4);
+  } else {
+    hash = HDBXHSEED + HDBXHPRIME5;
+  }
+  hash += (uint64_t)ksiz;
+  while(rp + 8 <= ep){
+    memcpy(&lane, rp, sizeof(lane));
+    uint64_t acc = 0;
+    HDBXHROUND(acc, TCITOHLL(lane));
+    hash ^= acc;
+    hash = HDBXHROTL(hash, 27) * HDBXHPRIME1 + HDBXHPRIME4;
+    rp += 8;
+  }
+  if(rp + 4 <= ep){
+    uint32_t word;
+    memcpy(&word, rp, sizeof(word));
+    hash ^= (uint64_t)TCITOHL(word) * HDBXHPRIME1;
+    hash = HDBXHROTL(hash, 23) * HDBXHPRIME2 + HDBXHPRIME3;
+    rp += 4;
+  }
+  while(rp < ep){
+    hash ^= *(rp++) * HDBXHPRIME5;
+    hash = HDBXHROTL(hash, 11) * HDBXHPRIME1;
+  }
+  hash ^= hash >> 33;
+  hash *= HDBXHPRIME2;
+  hash ^= hash >> 29;
+  hash *= HDBXHPRIME3;
+  hash ^= hash >> 32;
+  return hash;
 }
 
 
@@ -2191,30 +3513,41 @@ static void tchdbsetbucket(TCHDB *hdb, uint64_t bidx, uint64_t off){
   if(hdb->ba64){
     uint64_t llnum = off >> hdb->apow;
     if(hdb->tran) tchdbwalwrite(hdb, HDBHEADSIZ + bidx * sizeof(llnum), sizeof(llnum));
+    if(hdb->snap) tchdbsnaplog(hdb, HDBHEADSIZ + bidx * sizeof(llnum), sizeof(llnum));
     hdb->ba64[bidx] = TCHTOILL(llnum);
   } else {
     uint32_t lnum = off >> hdb->apow;
     if(hdb->tran) tchdbwalwrite(hdb, HDBHEADSIZ + bidx * sizeof(lnum), sizeof(lnum));
+    if(hdb->snap) tchdbsnaplog(hdb, HDBHEADSIZ + bidx * sizeof(lnum), sizeof(lnum));
     hdb->ba32[bidx] = TCHTOIL(lnum);
   }
 }
 
 
-/* Load the free block pool from the file.
-   The return value is true if successful, else, it is false. */
+/* Save the free block pool into the file.
+   The return value is true if successful, else, it is false.
+   If the pool has not been loaded, the stored pool is still valid and kept as it is. */
 static bool tchdbsavefbp(TCHDB *hdb){
   assert(hdb);
-  if(hdb->fbpnum > hdb->fbpmax){
-    tchdbfbpmerge(hdb);
-  } else if(hdb->fbpnum > 1){
-    tcfbpsortbyoff(hdb->fbpool, hdb->fbpnum);
-  }
+  if(hdb->fbplazy) return true;
+  HDBFBP *fbp = hdb->fbpool;
   int bsiz = hdb->frec - hdb->msiz;
   char *buf;
   TCMALLOC(buf, bsiz);
   char *wp = buf;
-  HDBFB *cur = hdb->fbpool;
-  HDBFB *end = cur + hdb->fbpnum;
+  HDBFB *blocks;
+  TCMALLOC(blocks, sizeof(*blocks) * (hdb->fbpnum + 1));
+  HDBFB *cur = blocks + hdb->fbpnum;
+  const char *kbuf;
+  int ksiz;
+  tctreeiterinit(fbp->byoff);
+  while(cur > blocks && (kbuf = tctreeiternext(fbp->byoff, &ksiz)) != NULL){
+    cur--;
+    memcpy(&cur->off, kbuf, sizeof(cur->off));
+    int vsiz;
+    memcpy(&cur->rsiz, tctreeiterval(kbuf, &vsiz), sizeof(cur->rsiz));
+  }
+  HDBFB *end = blocks + hdb->fbpnum;
   uint64_t base = 0;
   bsiz -= sizeof(HDBFB) + sizeof(uint8_t) + sizeof(uint8_t);
   while(cur < end && bsiz > 0){
@@ -2231,6 +3564,7 @@ static bool tchdbsavefbp(TCHDB *hdb){
     base = noff;
     cur++;
   }
+  TCFREE(blocks);
   *(wp++) = '\0';
   *(wp++) = '\0';
   if(!tchdbseekwrite(hdb, hdb->msiz, buf, wp - buf)){
@@ -2242,7 +3576,7 @@ static bool tchdbsavefbp(TCHDB *hdb){
 }
 
 
-/* Save the free block pool into the file.
+/* Load the free block pool from the file.
    The return value is true if successful, else, it is false. */
 static bool tchdbloadfbp(TCHDB *hdb){
   int bsiz = hdb->frec - hdb->msiz;
@@ -2253,138 +3587,215 @@ static bool tchdbloadfbp(TCHDB *hdb){
     return false;
   }
   const char *rp = buf;
-  HDBFB *cur = hdb->fbpool;
-  HDBFB *end = cur + hdb->fbpmax * HDBFBPALWRAT;
+  int num = hdb->fbpmax * HDBFBPALWRAT;
   uint64_t base = 0;
-  while(cur < end && *rp != '\0'){
+  while(num-- > 0 && *rp != '\0'){
     int step;
     uint64_t llnum;
     TCREADVNUMBUF64(rp, llnum, step);
     base += llnum << hdb->apow;
-    cur->off = base;
     rp += step;
     uint32_t lnum;
     TCREADVNUMBUF(rp, lnum, step);
-    cur->rsiz = lnum << hdb->apow;
     rp += step;
-    cur++;
+    if(lnum > 0) tchdbfbpadd(hdb, base, lnum << hdb->apow);
   }
-  hdb->fbpnum = cur - (HDBFB *)hdb->fbpool;
   TCFREE(buf);
-  tcfbpsortbyrsiz(hdb->fbpool, hdb->fbpnum);
   return true;
 }
 
 
-/* Sort the free block pool by offset.
-   `fbpool' specifies the free block pool.
-   `fbpnum' specifies the number of blocks. */
-static void tcfbpsortbyoff(HDBFB *fbpool, int fbpnum){
-  assert(fbpool && fbpnum >= 0);
-  fbpnum--;
-  int bottom = fbpnum / 2 + 1;
-  int top = fbpnum;
-  while(bottom > 0){
-    bottom--;
-    int mybot = bottom;
-    int i = mybot * 2;
-    while(i <= top){
-      if(i < top && fbpool[i+1].off > fbpool[i].off) i++;
-      if(fbpool[mybot].off >= fbpool[i].off) break;
-      HDBFB swap = fbpool[mybot];
-      fbpool[mybot] = fbpool[i];
-      fbpool[i] = swap;
-      mybot = i;
-      i = mybot * 2;
-    }
-  }
-  while(top > 0){
-    HDBFB swap = fbpool[0];
-    fbpool[0] = fbpool[top];
-    fbpool[top] = swap;
-    top--;
-    int mybot = bottom;
-    int i = mybot * 2;
-    while(i <= top){
-      if(i < top && fbpool[i+1].off > fbpool[i].off) i++;
-      if(fbpool[mybot].off >= fbpool[i].off) break;
-      swap = fbpool[mybot];
-      fbpool[mybot] = fbpool[i];
-      fbpool[i] = swap;
-      mybot = i;
-      i = mybot * 2;
-    }
-  }
-}
-
-
-/* Sort the free block pool by record size.
-   `fbpool' specifies the free block pool.
-   `fbpnum' specifies the number of blocks. */
-static void tcfbpsortbyrsiz(HDBFB *fbpool, int fbpnum){
-  assert(fbpool && fbpnum >= 0);
-  fbpnum--;
-  int bottom = fbpnum / 2 + 1;
-  int top = fbpnum;
-  while(bottom > 0){
-    bottom--;
-    int mybot = bottom;
-    int i = mybot * 2;
-    while(i <= top){
-      if(i < top && fbpool[i+1].rsiz > fbpool[i].rsiz) i++;
-      if(fbpool[mybot].rsiz >= fbpool[i].rsiz) break;
-      HDBFB swap = fbpool[mybot];
-      fbpool[mybot] = fbpool[i];
-      fbpool[i] = swap;
-      mybot = i;
-      i = mybot * 2;
-    }
-  }
-  while(top > 0){
-    HDBFB swap = fbpool[0];
-    fbpool[0] = fbpool[top];
-    fbpool[top] = swap;
-    top--;
-    int mybot = bottom;
-    int i = mybot * 2;
-    while(i <= top){
-      if(i < top && fbpool[i+1].rsiz > fbpool[i].rsiz) i++;
-      if(fbpool[mybot].rsiz >= fbpool[i].rsiz) break;
-      swap = fbpool[mybot];
-      fbpool[mybot] = fbpool[i];
-      fbpool[i] = swap;
-      mybot = i;
-      i = mybot * 2;
-    }
-  }
-}
-
-
-/* Merge successive records in the free block pool.
+/* Load the free block pool whose loading was deferred at opening.
+   `hdb' specifies the hash database object.
+   The return value is true if successful, else, it is false.
+   The pool is loaded when it is used for the first time, so that opening a database with a large
+   pool does not wait for it.  Then the stored pool is invalidated because it gets stale. */
+static bool tchdbfbpready(TCHDB *hdb){
+  assert(hdb);
+  if(!hdb->fbplazy) return true;
+  hdb->fbplazy = false;
+  bool err = false;
+  if(!tchdbloadfbp(hdb)) err = true;
+  char hbuf[2];
+  memset(hbuf, 0, sizeof(hbuf));
+  if(!tchdbseekwrite(hdb, hdb->msiz, hbuf, sizeof(hbuf))) err = true;
+  return !err;
+}
+
+
+/* Create the free block pool.
+   The return value is the new free block pool. */
+static HDBFBP *tchdbfbpnew(void){
+  HDBFBP *fbp;
+  TCMALLOC(fbp, sizeof(*fbp));
+  fbp->bysiz = tctreenew2(tchdbfbpcmpsiz, NULL);
+  fbp->byoff = tctreenew2(tchdbfbpcmpoff, NULL);
+  return fbp;
+}
+
+
+/* Delete the free block pool.
+   `fbp' specifies the free block pool. */
+static void tchdbfbpdel(HDBFBP *fbp){
+  assert(fbp);
+  tctreedel(fbp->byoff);
+  tctreedel(fbp->bysiz);
+  TCFREE(fbp);
+}
+
+
+/* Remove all blocks of the free block pool.
    `hdb' specifies the hash database object. */
-static void tchdbfbpmerge(TCHDB *hdb){
+static void tchdbfbpclear(TCHDB *hdb){
   assert(hdb);
-  TCDODEBUG(hdb->cnt_mergefbp++);
-  tcfbpsortbyoff(hdb->fbpool, hdb->fbpnum);
-  HDBFB *wp = hdb->fbpool;
-  HDBFB *cur = wp;
-  HDBFB *end = wp + hdb->fbpnum - 1;
-  while(cur < end){
-    if(cur->off > 0){
-      HDBFB *next = cur + 1;
-      if(cur->off + cur->rsiz == next->off){
-        if(hdb->dfcur == next->off) hdb->dfcur += next->rsiz;
-        if(hdb->iter == next->off) hdb->iter += next->rsiz;
-        cur->rsiz += next->rsiz;
-        next->off = 0;
-      }
-      *(wp++) = *cur;
+  HDBFBP *fbp = hdb->fbpool;
+  if(fbp){
+    tctreeclear(fbp->bysiz);
+    tctreeclear(fbp->byoff);
+  }
+  hdb->fbpnum = 0;
+  hdb->fbplazy = false;
+}
+
+
+/* Compare two free blocks by size and offset.
+   `aptr' specifies the pointer to the region of one block.
+   `asiz' specifies the size of the region of one block.
+   `bptr' specifies the pointer to the region of the other block.
+   `bsiz' specifies the size of the region of the other block.
+   `op' is ignored.
+   The return value is positive if the former is big, negative if the latter is big, 0 if both
+   are equivalent. */
+static int tchdbfbpcmpsiz(const char *aptr, int asiz, const char *bptr, int bsiz, void *op){
+  assert(aptr && asiz == sizeof(HDBFB) && bptr && bsiz == sizeof(HDBFB));
+  HDBFB a, b;
+  memcpy(&a, aptr, sizeof(a));
+  memcpy(&b, bptr, sizeof(b));
+  if(a.rsiz != b.rsiz) return (a.rsiz < b.rsiz) ? -1 : 1;
+  return (a.off < b.off) ? -1 : a.off > b.off;
+}
+
+
+/* Compare two offsets of free blocks in the descending order.
+   `aptr' specifies the pointer to the region of one offset.
+   `asiz' specifies the size of the region of one offset.
+   `bptr' specifies the pointer to the region of the other offset.
+   `bsiz' specifies the size of the region of the other offset.
+   `op' is ignored.
+   The return value is positive if the former is small, negative if the latter is small, 0 if
+   both are equivalent.  Because of the descending order, the iterator initialized with an
+   offset points to the nearest block not after it. */
+static int tchdbfbpcmpoff(const char *aptr, int asiz, const char *bptr, int bsiz, void *op){
+  assert(aptr && asiz == sizeof(uint64_t) && bptr && bsiz == sizeof(uint64_t));
+  uint64_t a, b;
+  memcpy(&a, aptr, sizeof(a));
+  memcpy(&b, bptr, sizeof(b));
+  return (a > b) ? -1 : a < b;
+}
+
+
+/* Add a block to the indexes of the free block pool.
+   `hdb' specifies the hash database object.
+   `off' specifies the offset of the block.
+   `rsiz' specifies the size of the block.
+   If the pool overflows, the smallest blocks are dropped. */
+static void tchdbfbpadd(TCHDB *hdb, uint64_t off, uint32_t rsiz){
+  assert(hdb && off > 0 && rsiz > 0);
+  HDBFBP *fbp = hdb->fbpool;
+  HDBFB fb;
+  memset(&fb, 0, sizeof(fb));
+  fb.off = off;
+  fb.rsiz = rsiz;
+  tctreeput(fbp->bysiz, &fb, sizeof(fb), "", 0);
+  tctreeput(fbp->byoff, &off, sizeof(off), &rsiz, sizeof(rsiz));
+  hdb->fbpnum++;
+  if(hdb->fbpnum > hdb->fbpmax * HDBFBPALWRAT){
+    TCDODEBUG(hdb->cnt_reducefbp++);
+    while(hdb->fbpnum > hdb->fbpmax){
+      tctreeiterinit(fbp->bysiz);
+      int ksiz;
+      const char *kbuf = tctreeiternext(fbp->bysiz, &ksiz);
+      if(!kbuf) break;
+      memcpy(&fb, kbuf, sizeof(fb));
+      tchdbfbpremove(hdb, fb.off, fb.rsiz);
     }
-    cur++;
   }
-  if(end->off > 0) *(wp++) = *end;
-  hdb->fbpnum = wp - (HDBFB *)hdb->fbpool;
-  hdb->fbpmis = hdb->fbpnum * -1;
+}
+
+
+/* Remove a block from the indexes of the free block pool.
+   `hdb' specifies the hash database object.
+   `off' specifies the offset of the block.
+   `rsiz' specifies the size of the block. */
+static void tchdbfbpremove(TCHDB *hdb, uint64_t off, uint32_t rsiz){
+  assert(hdb);
+  HDBFBP *fbp = hdb->fbpool;
+  HDBFB fb;
+  memset(&fb, 0, sizeof(fb));
+  fb.off = off;
+  fb.rsiz = rsiz;
+  tctreeout(fbp->bysiz, &fb, sizeof(fb));
+  tctreeout(fbp->byoff, &off, sizeof(off));
+  hdb->fbpnum--;
+}
+
+
+/* Get the nearest block not after an offset in the free block pool.
+   `hdb' specifies the hash database object.
+   `off' specifies the offset.
+   `fb' specifies the block object into which the result is assigned.
+   The return value is true if the block exists, else, it is false.
+   The iterator of a tree keeps its old position if no record follows the key, so that the
+   fetched block is checked again. */
+static bool tchdbfbpfloor(TCHDB *hdb, uint64_t off, HDBFB *fb){
+  assert(hdb && fb);
+  HDBFBP *fbp = hdb->fbpool;
+  tctreeiterinit2(fbp->byoff, &off, sizeof(off));
+  int ksiz;
+  const char *kbuf = tctreeiternext(fbp->byoff, &ksiz);
+  if(!kbuf) return false;
+  memcpy(&fb->off, kbuf, sizeof(fb->off));
+  if(fb->off > off) return false;
+  int vsiz;
+  memcpy(&fb->rsiz, tctreeiterval(kbuf, &vsiz), sizeof(fb->rsiz));
+  return true;
+}
+
+
+/* Insert a block into the free block pool with coalescing its free neighbors.
+   `hdb' specifies the hash database object.
+   `off' specifies the offset of the block.
+   `rsiz' specifies the size of the block.
+   Neighbors are merged only in the pool, so that headers of the absorbed blocks are kept in the
+   file.  The cursors pointing at them are moved to the end of the merged block. */
+static void tchdbfbpjoin(TCHDB *hdb, uint64_t off, uint32_t rsiz){
+  assert(hdb && off > 0 && rsiz > 0);
+  HDBFBP *fbp = hdb->fbpool;
+  uint64_t next = off + rsiz;
+  int vsiz;
+  const char *vbuf = tctreeget(fbp->byoff, &next, sizeof(next), &vsiz);
+  if(vbuf){
+    uint32_t nsiz;
+    memcpy(&nsiz, vbuf, sizeof(nsiz));
+    if((uint64_t)rsiz + nsiz <= HDBFBMAXSIZ){
+      TCDODEBUG(hdb->cnt_mergefbp++);
+      tchdbfbpremove(hdb, next, nsiz);
+      if(hdb->dfcur == next) hdb->dfcur += nsiz;
+      if(hdb->iter == next) hdb->iter += nsiz;
+      rsiz += nsiz;
+    }
+  }
+  HDBFB fb;
+  if(tchdbfbpfloor(hdb, off, &fb) && fb.off + fb.rsiz == off &&
+     (uint64_t)fb.rsiz + rsiz <= HDBFBMAXSIZ){
+    TCDODEBUG(hdb->cnt_mergefbp++);
+    tchdbfbpremove(hdb, fb.off, fb.rsiz);
+    if(hdb->dfcur == off) hdb->dfcur += rsiz;
+    if(hdb->iter == off) hdb->iter += rsiz;
+    off = fb.off;
+    rsiz += fb.rsiz;
+  }
+  tchdbfbpadd(hdb, off, rsiz);
 }
 
 
@@ -2397,45 +3808,8 @@ static void tchdbfbpinsert(TCHDB *hdb, uint64_t off, uint32_t rsiz){
   TCDODEBUG(hdb->cnt_insertfbp++);
   hdb->dfcnt++;
   if(hdb->fpow < 1) return;
-  HDBFB *pv = hdb->fbpool;
-  if(hdb->fbpnum >= hdb->fbpmax * HDBFBPALWRAT){
-    tchdbfbpmerge(hdb);
-    tcfbpsortbyrsiz(hdb->fbpool, hdb->fbpnum);
-    int diff = hdb->fbpnum - hdb->fbpmax;
-    if(diff > 0){
-      TCDODEBUG(hdb->cnt_reducefbp++);
-      memmove(pv, pv + diff, (hdb->fbpnum - diff) * sizeof(*pv));
-      hdb->fbpnum -= diff;
-    }
-    hdb->fbpmis = 0;
-  }
-  int num = hdb->fbpnum;
-  int left = 0;
-  int right = num;
-  int i = (left + right) / 2;
-  int cand = -1;
-  while(right >= left && i < num){
-    int rv = (int)rsiz - (int)pv[i].rsiz;
-    if(rv == 0){
-      cand = i;
-      break;
-    } else if(rv <= 0){
-      cand = i;
-      right = i - 1;
-    } else {
-      left = i + 1;
-    }
-    i = (left + right) / 2;
-  }
-  if(cand >= 0){
-    pv += cand;
-    memmove(pv + 1, pv, sizeof(*pv) * (num - cand));
-  } else {
-    pv += num;
-  }
-  pv->off = off;
-  pv->rsiz = rsiz;
-  hdb->fbpnum++;
+  tchdbfbpready(hdb);
+  tchdbfbpjoin(hdb, off, rsiz);
 }
 
 
@@ -2446,58 +3820,42 @@ static void tchdbfbpinsert(TCHDB *hdb, uint64_t off, uint32_t rsiz){
 static bool tchdbfbpsearch(TCHDB *hdb, TCHREC *rec){
   assert(hdb && rec);
   TCDODEBUG(hdb->cnt_searchfbp++);
+  if(!tchdbfbpready(hdb)) return false;
   if(hdb->fbpnum < 1){
     rec->off = hdb->fsiz;
     rec->rsiz = 0;
     return true;
   }
   uint32_t rsiz = rec->rsiz;
-  HDBFB *pv = hdb->fbpool;
-  int num = hdb->fbpnum;
-  int left = 0;
-  int right = num;
-  int i = (left + right) / 2;
-  int cand = -1;
-  while(right >= left && i < num){
-    int rv = (int)rsiz - (int)pv[i].rsiz;
-    if(rv == 0){
-      cand = i;
-      break;
-    } else if(rv <= 0){
-      cand = i;
-      right = i - 1;
-    } else {
-      left = i + 1;
-    }
-    i = (left + right) / 2;
-  }
-  if(cand >= 0){
-    pv += cand;
-    if(pv->rsiz > rsiz * 2){
-      uint32_t psiz = tchdbpadsize(hdb, pv->off + rsiz);
-      uint64_t noff = pv->off + rsiz + psiz;
-      if(pv->rsiz >= (noff - pv->off) * 2){
+  HDBFBP *fbp = hdb->fbpool;
+  HDBFB fb;
+  memset(&fb, 0, sizeof(fb));
+  fb.rsiz = rsiz;
+  tctreeiterinit2(fbp->bysiz, &fb, sizeof(fb));
+  int ksiz;
+  const char *kbuf = tctreeiternext(fbp->bysiz, &ksiz);
+  if(kbuf) memcpy(&fb, kbuf, sizeof(fb));
+  if(kbuf && fb.rsiz >= rsiz){
+    tchdbfbpremove(hdb, fb.off, fb.rsiz);
+    if(fb.rsiz > rsiz * 2){
+      uint32_t psiz = tchdbpadsize(hdb, fb.off + rsiz);
+      uint64_t noff = fb.off + rsiz + psiz;
+      if(fb.rsiz >= (noff - fb.off) * 2){
         TCDODEBUG(hdb->cnt_dividefbp++);
-        rec->off = pv->off;
-        rec->rsiz = noff - pv->off;
-        pv->off = noff;
-        pv->rsiz -= rec->rsiz;
-        return tchdbwritefb(hdb, pv->off, pv->rsiz);
+        rec->off = fb.off;
+        rec->rsiz = noff - fb.off;
+        uint32_t nsiz = fb.rsiz - rec->rsiz;
+        tchdbfbpadd(hdb, noff, nsiz);
+        return tchdbwritefb(hdb, noff, nsiz);
       }
     }
-    rec->off = pv->off;
-    rec->rsiz = pv->rsiz;
-    memmove(pv, pv + 1, sizeof(*pv) * (num - cand - 1));
-    hdb->fbpnum--;
+    rec->off = fb.off;
+    rec->rsiz = fb.rsiz;
     return true;
   }
   rec->off = hdb->fsiz;
   rec->rsiz = 0;
   hdb->fbpmis++;
-  if(hdb->fbpmis >= HDBFBPMGFREQ){
-    tchdbfbpmerge(hdb);
-    tcfbpsortbyrsiz(hdb->fbpool, hdb->fbpnum);
-  }
   return true;
 }
 
@@ -2509,26 +3867,25 @@ static bool tchdbfbpsearch(TCHDB *hdb, TCHREC *rec){
    The return value is whether splicing succeeded or not. */
 static bool tchdbfbpsplice(TCHDB *hdb, TCHREC *rec, uint32_t nsiz){
   assert(hdb && rec && nsiz > 0);
+  if(!tchdbfbpready(hdb)) return false;
   if(hdb->mmtx){
     if(hdb->fbpnum < 1) return false;
     uint64_t off = rec->off + rec->rsiz;
     uint32_t rsiz = rec->rsiz;
     uint8_t magic;
     if(tchdbseekreadtry(hdb, off, &magic, sizeof(magic)) && magic != HDBMAGICFB) return false;
-    HDBFB *pv = hdb->fbpool;
-    HDBFB *ep = pv + hdb->fbpnum;
-    while(pv < ep){
-      if(pv->off == off && rsiz + pv->rsiz >= nsiz){
-        if(hdb->dfcur == pv->off) hdb->dfcur += pv->rsiz;
-        if(hdb->iter == pv->off) hdb->iter += pv->rsiz;
-        rec->rsiz += pv->rsiz;
-        memmove(pv, pv + 1, sizeof(*pv) * ((ep - pv) - 1));
-        hdb->fbpnum--;
-        return true;
-      }
-      pv++;
-    }
-    return false;
+    HDBFBP *fbp = hdb->fbpool;
+    int vsiz;
+    const char *vbuf = tctreeget(fbp->byoff, &off, sizeof(off), &vsiz);
+    if(!vbuf) return false;
+    uint32_t fsiz;
+    memcpy(&fsiz, vbuf, sizeof(fsiz));
+    if(rsiz + fsiz < nsiz) return false;
+    if(hdb->dfcur == off) hdb->dfcur += fsiz;
+    if(hdb->iter == off) hdb->iter += fsiz;
+    rec->rsiz += fsiz;
+    tchdbfbpremove(hdb, off, fsiz);
+    return true;
   }
   uint64_t off = rec->off + rec->rsiz;
   TCHREC nrec;
@@ -2544,15 +3901,12 @@ static bool tchdbfbpsplice(TCHDB *hdb, TCHREC *rec, uint32_t nsiz){
   uint32_t jsiz = off - rec->off;
   if(jsiz < nsiz) return false;
   rec->rsiz = jsiz;
-  uint64_t base = rec->off;
-  HDBFB *wp = hdb->fbpool;
-  HDBFB *cur = wp;
-  HDBFB *end = wp + hdb->fbpnum;
-  while(cur < end){
-    if(cur->off < base || cur->off > off) *(wp++) = *cur;
-    cur++;
+  HDBFB fb;
+  if(hdb->fbpool){
+    while(tchdbfbpfloor(hdb, off, &fb) && fb.off >= rec->off){
+      tchdbfbpremove(hdb, fb.off, fb.rsiz);
+    }
   }
-  hdb->fbpnum = wp - (HDBFB *)hdb->fbpool;
   if(jsiz > nsiz * 2){
     uint32_t psiz = tchdbpadsize(hdb, rec->off + nsiz);
     uint64_t noff = rec->off + nsiz + psiz;
@@ -2573,43 +3927,27 @@ static bool tchdbfbpsplice(TCHDB *hdb, TCHREC *rec, uint32_t nsiz){
    `base' specifies the base offset of the region.
    `next' specifies the offset of the next region.
    `off' specifies the offset of the block.
-   `rsiz' specifies the size of the block. */
+   `rsiz' specifies the size of the block.
+   A block overlapping either edge of the region is cut at the edge, so that no block in the
+   pool covers records shifted into the region. */
 static void tchdbfbptrim(TCHDB *hdb, uint64_t base, uint64_t next, uint64_t off, uint32_t rsiz){
   assert(hdb && base > 0 && next > 0);
   if(hdb->fpow < 1) return;
-  if(hdb->fbpnum < 1){
-    if(off > 0){
-      HDBFB *fbpool = hdb->fbpool;
-      fbpool->off = off;
-      fbpool->rsiz = rsiz;
-      hdb->fbpnum = 1;
-    }
-    return;
+  tchdbfbpready(hdb);
+  HDBFB fb;
+  while(tchdbfbpfloor(hdb, next - 1, &fb) && fb.off >= base){
+    tchdbfbpremove(hdb, fb.off, fb.rsiz);
+    if(fb.off + fb.rsiz > next) tchdbfbpadd(hdb, next, fb.off + fb.rsiz - next);
   }
-  HDBFB *wp = hdb->fbpool;
-  HDBFB *cur = wp;
-  HDBFB *end = wp + hdb->fbpnum;
-  if(hdb->fbpnum >= hdb->fbpmax * HDBFBPALWRAT) cur++;
-  while(cur < end){
-    if(cur->rsiz >= rsiz && off > 0){
-      TCDODEBUG(hdb->cnt_insertfbp++);
-      wp->off = off;
-      wp->rsiz = rsiz;
-      wp++;
-      off = 0;
-    } else if(cur->off < base || cur->off >= next){
-      *(wp++) = *cur;
-    }
-    cur++;
+  if(tchdbfbpfloor(hdb, base, &fb) && fb.off + fb.rsiz > base){
+    tchdbfbpremove(hdb, fb.off, fb.rsiz);
+    tchdbfbpadd(hdb, fb.off, base - fb.off);
+    if(fb.off + fb.rsiz > next) tchdbfbpadd(hdb, next, fb.off + fb.rsiz - next);
   }
   if(off > 0){
     TCDODEBUG(hdb->cnt_insertfbp++);
-    wp->off = off;
-    wp->rsiz = rsiz;
-    wp++;
-    off = 0;
+    tchdbfbpjoin(hdb, off, rsiz);
   }
-  hdb->fbpnum = wp - (HDBFB *)hdb->fbpool;
 }
 
 
@@ -2631,6 +3969,34 @@ static bool tchdbwritefb(TCHDB *hdb, uint64_t off, uint32_t rsiz){
 }
 
 
+/* Reserve the region of a new record at the end of the file.
+   `hdb' specifies the hash database object.
+   `rec' specifies the record object.
+   `ksiz' specifies the size of the region of the key.
+   `vsiz' specifies the size of the region of the value.
+   The return value is true if successful, else, it is false.
+   The file size is advanced before the record is written, so that the record itself can be
+   written without the database lock. */
+static bool tchdbreserverec(TCHDB *hdb, TCHREC *rec, int ksiz, int vsiz){
+  assert(hdb && rec && ksiz >= 0 && vsiz >= 0);
+  int32_t hsiz = sizeof(uint8_t) + sizeof(uint8_t) +
+    (hdb->ba64 ? sizeof(uint64_t) : sizeof(uint32_t)) * 2 + sizeof(uint16_t) +
+    TCCALCVNUMSIZE(ksiz) + TCCALCVNUMSIZE(vsiz);
+  if(hdb->opts & HDBTTTL) hsiz += sizeof(uint32_t);
+  int32_t rsiz = hsiz + ksiz + vsiz;
+  uint16_t psiz = tchdbpadsize(hdb, hdb->fsiz + rsiz);
+  uint64_t end = hdb->fsiz + rsiz + psiz;
+  if(end <= hdb->xmsiz && end >= hdb->xfsiz && !tchdbextendfile(hdb, end)) return false;
+  rec->off = hdb->fsiz;
+  rec->rsiz = rsiz + psiz;
+  hdb->fsiz = end;
+  uint64_t llnum = hdb->fsiz;
+  llnum = TCHTOILL(llnum);
+  memcpy(hdb->map + HDBFSIZOFF, &llnum, sizeof(llnum));
+  return true;
+}
+
+
 /* Write a record into the file.
    `hdb' specifies the hash database object.
    `rec' specifies the record object.
@@ -2680,6 +4046,11 @@ static bool tchdbwriterec(TCHDB *hdb, TCHREC *rec, uint64_t bidx, off_t entoff){
   wp += step;
   TCSETVNUMBUF(step, wp, rec->vsiz);
   wp += step;
+  if(hdb->opts & HDBTTTL){
+    uint32_t lnum = TCHTOIL(rec->xtime);
+    memcpy(wp, &lnum, sizeof(lnum));
+    wp += sizeof(lnum);
+  }
   int32_t hsiz = wp - rbuf;
   int32_t rsiz = hsiz + rec->ksiz + rec->vsiz;
   int32_t finc = 0;
@@ -2793,12 +4164,27 @@ static bool tchdbreadrec(TCHDB *hdb, TCHREC *rec, char *rbuf){
       HDBUNLOCKDB(hdb);
       return false;
     }
-    if(!tchdbseekread(hdb, rec->off, rbuf, rsiz)){
+    rsiz = tchdbseekreadpart(hdb, rec->off, rbuf, rsiz);
+    if(rsiz < (int)(sizeof(uint8_t) + sizeof(uint32_t))){
+      if(rsiz >= 0) tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
       HDBUNLOCKDB(hdb);
       return false;
     }
     HDBUNLOCKDB(hdb);
   }
+  return tchdbparserec(hdb, rec, rbuf, rsiz);
+}
+
+
+/* Parse the header of a record read into a buffer.
+   `hdb' specifies the hash database object.
+   `rec' specifies the record object whose offset is set.
+   `rbuf' specifies the buffer holding the leading region of the record.
+   `rsiz' specifies the size of the region in the buffer.
+   The return value is true if successful, else, it is false.
+   The key and the value refer to the buffer if they are contained in the region. */
+static bool tchdbparserec(TCHDB *hdb, TCHREC *rec, const char *rbuf, int rsiz){
+  assert(hdb && rec && rbuf && rsiz >= 0);
   const char *rp = rbuf;
   rec->magic = *(uint8_t *)(rp++);
   if(rec->magic == HDBMAGICFB){
@@ -2840,6 +4226,12 @@ static bool tchdbreadrec(TCHDB *hdb, TCHREC *rec, char *rbuf){
   TCREADVNUMBUF(rp, lnum, step);
   rec->vsiz = lnum;
   rp += step;
+  rec->xtime = 0;
+  if(hdb->opts & HDBTTTL){
+    memcpy(&lnum, rp, sizeof(lnum));
+    rec->xtime = TCITOHL(lnum);
+    rp += sizeof(lnum);
+  }
   int32_t hsiz = rp - rbuf;
   rec->rsiz = hsiz + rec->ksiz + rec->vsiz + rec->psiz;
   rec->kbuf = NULL;
@@ -3022,6 +4414,72 @@ static bool tchdbshiftrec(TCHDB *hdb, TCHREC *rec, char *rbuf, off_t destoff){
 }
 
 
+/* Remove an expired record found by scanning the file.
+   `hdb' specifies the hash database object.
+   `rec' specifies the record object.
+   The return value is true if successful, else, it is false.
+   The record is unlinked from the tree of its bucket and its region becomes a free block. */
+static bool tchdbexpirerec(TCHDB *hdb, TCHREC *rec){
+  assert(hdb && rec);
+  if(!rec->kbuf && !tchdbreadrecbody(hdb, rec)) return false;
+  char *bbuf = rec->bbuf;
+  const char *kbuf = rec->kbuf;
+  int ksiz = rec->ksiz;
+  rec->kbuf = NULL;
+  rec->vbuf = NULL;
+  rec->bbuf = NULL;
+  if(hdb->recc) tchdbrcout(hdb, kbuf, ksiz);
+  uint8_t hash;
+  uint64_t bidx = tchdbbidx(hdb, kbuf, ksiz, &hash);
+  off_t off = tchdbgetbucket(hdb, bidx);
+  off_t entoff = 0;
+  TCHREC trec;
+  char tbuf[HDBIOBUFSIZ];
+  while(off > 0){
+    trec.off = off;
+    if(!tchdbreadrec(hdb, &trec, tbuf)){
+      TCFREE(bbuf);
+      return false;
+    }
+    if(hash > trec.hash){
+      off = trec.left;
+      entoff = trec.off + (sizeof(uint8_t) + sizeof(uint8_t));
+    } else if(hash < trec.hash){
+      off = trec.right;
+      entoff = trec.off + (sizeof(uint8_t) + sizeof(uint8_t)) +
+        (hdb->ba64 ? sizeof(uint64_t) : sizeof(uint32_t));
+    } else {
+      if(!trec.kbuf && !tchdbreadrecbody(hdb, &trec)){
+        TCFREE(bbuf);
+        return false;
+      }
+      int kcmp = tcreckeycmp(kbuf, ksiz, trec.kbuf, trec.ksiz);
+      TCFREE(trec.bbuf);
+      trec.kbuf = NULL;
+      trec.bbuf = NULL;
+      if(kcmp > 0){
+        off = trec.left;
+        entoff = trec.off + (sizeof(uint8_t) + sizeof(uint8_t));
+      } else if(kcmp < 0){
+        off = trec.right;
+        entoff = trec.off + (sizeof(uint8_t) + sizeof(uint8_t)) +
+          (hdb->ba64 ? sizeof(uint64_t) : sizeof(uint32_t));
+      } else {
+        TCFREE(bbuf);
+        if(trec.off != rec->off){
+          tchdbsetecode(hdb, TCEMISC, __FILE__, __LINE__, __func__);
+          return false;
+        }
+        return tchdbremoverec(hdb, &trec, tbuf, bidx, entoff);
+      }
+    }
+  }
+  TCFREE(bbuf);
+  tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+  return false;
+}
+
+
 /* Compare keys of two records.
    `abuf' specifies the pointer to the region of the former.
    `asiz' specifies the size of the region.
@@ -3047,7 +4505,7 @@ static bool tchdbflushdrp(TCHDB *hdb){
     return true;
   }
   TCDODEBUG(hdb->cnt_flushdrp++);
-  if(!tchdbseekwrite(hdb, hdb->drpoff, TCXSTRPTR(hdb->drpool), TCXSTRSIZE(hdb->drpool))){
+  if(!tchdbseekwritebatch(hdb, hdb->drpoff, TCXSTRPTR(hdb->drpool), TCXSTRSIZE(hdb->drpool))){
     HDBUNLOCKDB(hdb);
     return false;
   }
@@ -3065,7 +4523,7 @@ static bool tchdbflushdrp(TCHDB *hdb){
     rp += vsiz;
     uint8_t hash;
     uint64_t bidx = tchdbbidx(hdb, kbuf, ksiz, &hash);
-    if(!tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDOVER)){
+    if(!tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDOVER, 0)){
       tcxstrdel(hdb->drpdef);
       tcxstrdel(hdb->drpool);
       hdb->drpool = NULL;
@@ -3093,12 +4551,315 @@ static bool tchdbflushdrp(TCHDB *hdb){
 }
 
 
-/* Adjust the caches for leaves and nodes.
-   `hdb' specifies the hash tree database object. */
-static void tchdbcacheadjust(TCHDB *hdb){
-  assert(hdb);
-  TCDODEBUG(hdb->cnt_adjrecc++);
-  tcmdbcutfront(hdb->recc, HDBCACHEOUT);
+/* Create a record cache object.
+   `rcnum' specifies the maximum number of records to be cached.
+   `nodes' specifies the bit mask of NUMA nodes over which the index is interleaved.  If it is 0,
+   the index is allocated on the heap.
+   The return value is the new record cache object.
+   The cache is split into shards each of which is guarded by its own mutex and evicts by the
+   CLOCK algorithm.  A doorkeeper bitmap admits a key into a full shard only when it has been
+   missed before, so that one pass of a scan does not flush the working set.  Missing keys are
+   kept in a separate direct mapped table so that they never evict records. */
+static HDBRCACHE *tchdbrcnew(uint32_t rcnum, uint64_t nodes){
+  HDBRCACHE *rc;
+  TCMALLOC(rc, sizeof(*rc) * HDBRCSHARDS);
+  uint32_t cap = (rcnum - 1) / HDBRCSHARDS + 1;
+  uint32_t hnum = 1;
+  while(hnum < cap) hnum <<= 1;
+  uint32_t dnum = 64;
+  while(dnum < cap * HDBRCDOORRAT) dnum <<= 1;
+  uint32_t nnum = tclmax(hnum / HDBRCNEGRAT, 1);
+  for(int i = 0; i < HDBRCSHARDS; i++){
+    HDBRCSHARD *shard = &rc[i].s;
+    if(pthread_mutex_init(&shard->mutex, NULL) != 0) tcmyfatal("pthread_mutex_init failed");
+    shard->slots = nodes ? tchdbmemmap(sizeof(*shard->slots) * cap, false, nodes) : NULL;
+    shard->heads = shard->slots ? tchdbmemmap(sizeof(*shard->heads) * hnum, false, nodes) : NULL;
+    shard->mapped = shard->heads != NULL;
+    if(!shard->mapped){
+      if(shard->slots) munmap(shard->slots, sizeof(*shard->slots) * cap);
+      TCMALLOC(shard->slots, sizeof(*shard->slots) * cap);
+      TCMALLOC(shard->heads, sizeof(*shard->heads) * hnum);
+    }
+    for(uint32_t j = 0; j < hnum; j++){
+      shard->heads[j] = -1;
+    }
+    shard->hmask = hnum - 1;
+    shard->cap = cap;
+    shard->num = 0;
+    shard->used = 0;
+    shard->free = -1;
+    shard->hand = 0;
+    shard->door = tccalloc(dnum / 64, sizeof(*shard->door));
+    shard->dmask = dnum - 1;
+    shard->dnum = 0;
+    shard->negs = tccalloc(nnum, sizeof(*shard->negs));
+    shard->nmask = nnum - 1;
+  }
+  return rc;
+}
+
+
+/* Delete a record cache object.
+   `rc' specifies the record cache object. */
+static void tchdbrcdel(HDBRCACHE *rc){
+  assert(rc);
+  tchdbrcvanish(rc);
+  for(int i = 0; i < HDBRCSHARDS; i++){
+    HDBRCSHARD *shard = &rc[i].s;
+    TCFREE(shard->negs);
+    TCFREE(shard->door);
+    if(shard->mapped){
+      munmap(shard->heads, sizeof(*shard->heads) * (shard->hmask + 1));
+      munmap(shard->slots, sizeof(*shard->slots) * shard->cap);
+    } else {
+      TCFREE(shard->heads);
+      TCFREE(shard->slots);
+    }
+    pthread_mutex_destroy(&shard->mutex);
+  }
+  TCFREE(rc);
+}
+
+
+/* Remove all records of a record cache object.
+   `rc' specifies the record cache object. */
+static void tchdbrcvanish(HDBRCACHE *rc){
+  assert(rc);
+  for(int i = 0; i < HDBRCSHARDS; i++){
+    HDBRCSHARD *shard = &rc[i].s;
+    if(pthread_mutex_lock(&shard->mutex) != 0) tcmyfatal("pthread_mutex_lock failed");
+    for(uint32_t j = 0; j < shard->used; j++){
+      if(shard->slots[j].rec) tchdbrcrelease(shard->slots[j].rec);
+    }
+    for(uint32_t j = 0; j <= shard->hmask; j++){
+      shard->heads[j] = -1;
+    }
+    for(uint32_t j = 0; j <= shard->nmask; j++){
+      if(shard->negs[j]){
+        tchdbrcrelease(shard->negs[j]);
+        shard->negs[j] = NULL;
+      }
+    }
+    memset(shard->door, 0, (shard->dmask + 1) / 8);
+    shard->num = 0;
+    shard->used = 0;
+    shard->free = -1;
+    shard->hand = 0;
+    shard->dnum = 0;
+    pthread_mutex_unlock(&shard->mutex);
+  }
+}
+
+
+/* Create a cached record.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `vbuf' specifies the pointer to the region of the value.
+   `vsiz' specifies the size of the region of the value.
+   `hash' specifies the hash value of the key.
+   The return value is the new cached record with one reference held by the cache. */
+static HDBRCREC *tchdbrcrecnew(const char *kbuf, int ksiz, const char *vbuf, int vsiz,
+                               uint64_t hash){
+  HDBRCREC *rec;
+  TCMALLOC(rec, sizeof(*rec) + ksiz + vsiz);
+  rec->ref = 1;
+  rec->ksiz = ksiz;
+  rec->vsiz = vsiz;
+  rec->hash = hash;
+  memcpy(rec->buf, kbuf, ksiz);
+  if(vsiz > 0) memcpy(rec->buf + ksiz, vbuf, vsiz);
+  return rec;
+}
+
+
+/* Check whether a cached record matches a key.
+   `rec' specifies the cached record.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `hash' specifies the hash value of the key.
+   The return value is true if the record matches, else, it is false. */
+static bool tchdbrcrecmatch(HDBRCREC *rec, const char *kbuf, int ksiz, uint64_t hash){
+  return rec->hash == hash && rec->ksiz == ksiz && !memcmp(rec->buf, kbuf, ksiz);
+}
+
+
+/* Search a shard of a record cache for a key.
+   `shard' specifies the shard locked by the caller.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `hash' specifies the hash value of the key.
+   `pp' specifies the pointer to the variable into which the pointer to the link referring to
+   the slot is assigned.
+   The return value is the index of the slot of the key or -1 if it is not cached. */
+static int32_t tchdbrcsearch(HDBRCSHARD *shard, const char *kbuf, int ksiz, uint64_t hash,
+                             int32_t **pp){
+  int32_t *lp = shard->heads + (hash & shard->hmask);
+  while(*lp >= 0){
+    HDBRCSLOT *slot = shard->slots + *lp;
+    if(tchdbrcrecmatch(slot->rec, kbuf, ksiz, hash)){
+      if(pp) *pp = lp;
+      return *lp;
+    }
+    lp = &slot->next;
+  }
+  return -1;
+}
+
+
+/* Release a reference of a cached record.
+   `rec' specifies the cached record. */
+static void tchdbrcrelease(HDBRCREC *rec){
+  assert(rec);
+  if(__sync_sub_and_fetch(&rec->ref, 1) == 0) TCFREE(rec);
+}
+
+
+/* Retrieve a record from the record cache of a hash database object.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `recp' specifies the pointer to the variable into which the cached record is assigned.  A
+   reference of it is held for the caller, who should release it with `tchdbrcrelease'.
+   The return value is 1 if the record is cached, 0 if the key is cached as missing, or -1 if
+   the key is not cached.
+   The shard is locked only while the reference is taken, so that the value is copied by the
+   caller without blocking other threads. */
+static int tchdbrcget(TCHDB *hdb, const char *kbuf, int ksiz, HDBRCREC **recp){
+  assert(hdb && kbuf && ksiz >= 0 && recp);
+  uint64_t hash = tchdbxhash(kbuf, ksiz);
+  HDBRCSHARD *shard = &((HDBRCACHE *)hdb->recc)[(hash>>32)&(HDBRCSHARDS-1)].s;
+  if(pthread_mutex_lock(&shard->mutex) != 0) tcmyfatal("pthread_mutex_lock failed");
+  int rv = -1;
+  int32_t idx = tchdbrcsearch(shard, kbuf, ksiz, hash, NULL);
+  if(idx >= 0){
+    HDBRCSLOT *slot = shard->slots + idx;
+    slot->hot = true;
+    __sync_fetch_and_add(&slot->rec->ref, 1);
+    *recp = slot->rec;
+    rv = 1;
+  } else {
+    HDBRCREC *neg = shard->negs[(hash>>16)&shard->nmask];
+    if(neg && tchdbrcrecmatch(neg, kbuf, ksiz, hash)) rv = 0;
+  }
+  pthread_mutex_unlock(&shard->mutex);
+  return rv;
+}
+
+
+/* Store a record into the record cache of a hash database object.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `vbuf' specifies the pointer to the region of the value.
+   `vsiz' specifies the size of the region of the value.
+   The caller should hold the lock of the record so that a stale value is never stored. */
+static void tchdbrcput(TCHDB *hdb, const char *kbuf, int ksiz, const char *vbuf, int vsiz){
+  assert(hdb && kbuf && ksiz >= 0 && vbuf && vsiz >= 0);
+  uint64_t hash = tchdbxhash(kbuf, ksiz);
+  HDBRCSHARD *shard = &((HDBRCACHE *)hdb->recc)[(hash>>32)&(HDBRCSHARDS-1)].s;
+  if(pthread_mutex_lock(&shard->mutex) != 0) tcmyfatal("pthread_mutex_lock failed");
+  HDBRCREC **negp = shard->negs + ((hash>>16)&shard->nmask);
+  if(*negp && tchdbrcrecmatch(*negp, kbuf, ksiz, hash)){
+    tchdbrcrelease(*negp);
+    *negp = NULL;
+  }
+  if(tchdbrcsearch(shard, kbuf, ksiz, hash, NULL) >= 0){
+    pthread_mutex_unlock(&shard->mutex);
+    return;
+  }
+  int32_t idx;
+  if(shard->free >= 0){
+    idx = shard->free;
+    shard->free = shard->slots[idx].next;
+  } else if(shard->used < shard->cap){
+    idx = shard->used++;
+  } else {
+    uint64_t *wp = shard->door + (((hash>>8)&shard->dmask) >> 6);
+    uint64_t mask = 1ULL << ((hash>>8) & 63);
+    if(!(*wp & mask)){
+      *wp |= mask;
+      if(++shard->dnum > shard->cap){
+        memset(shard->door, 0, (shard->dmask + 1) / 8);
+        shard->dnum = 0;
+      }
+      pthread_mutex_unlock(&shard->mutex);
+      return;
+    }
+    HDBRCSLOT *slots = shard->slots;
+    while(slots[shard->hand].hot){
+      slots[shard->hand].hot = false;
+      if(++shard->hand >= shard->cap) shard->hand = 0;
+    }
+    idx = shard->hand;
+    if(++shard->hand >= shard->cap) shard->hand = 0;
+    HDBRCREC *victim = slots[idx].rec;
+    int32_t *lp;
+    tchdbrcsearch(shard, victim->buf, victim->ksiz, victim->hash, &lp);
+    *lp = slots[idx].next;
+    tchdbrcrelease(victim);
+    shard->num--;
+    TCDODEBUG(hdb->cnt_adjrecc++);
+  }
+  HDBRCSLOT *slot = shard->slots + idx;
+  slot->rec = tchdbrcrecnew(kbuf, ksiz, vbuf, vsiz, hash);
+  slot->hot = false;
+  int32_t *hp = shard->heads + (hash & shard->hmask);
+  slot->next = *hp;
+  *hp = idx;
+  shard->num++;
+  pthread_mutex_unlock(&shard->mutex);
+}
+
+
+/* Store a missing key into the record cache of a hash database object.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key. */
+static void tchdbrcputneg(TCHDB *hdb, const char *kbuf, int ksiz){
+  assert(hdb && kbuf && ksiz >= 0);
+  uint64_t hash = tchdbxhash(kbuf, ksiz);
+  HDBRCSHARD *shard = &((HDBRCACHE *)hdb->recc)[(hash>>32)&(HDBRCSHARDS-1)].s;
+  HDBRCREC *neg = tchdbrcrecnew(kbuf, ksiz, NULL, 0, hash);
+  if(pthread_mutex_lock(&shard->mutex) != 0) tcmyfatal("pthread_mutex_lock failed");
+  HDBRCREC **negp = shard->negs + ((hash>>16)&shard->nmask);
+  HDBRCREC *old = *negp;
+  *negp = neg;
+  pthread_mutex_unlock(&shard->mutex);
+  if(old) tchdbrcrelease(old);
+}
+
+
+/* Remove a key from the record cache of a hash database object.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key. */
+static void tchdbrcout(TCHDB *hdb, const char *kbuf, int ksiz){
+  assert(hdb && kbuf && ksiz >= 0);
+  uint64_t hash = tchdbxhash(kbuf, ksiz);
+  HDBRCSHARD *shard = &((HDBRCACHE *)hdb->recc)[(hash>>32)&(HDBRCSHARDS-1)].s;
+  HDBRCREC *rec = NULL;
+  HDBRCREC *neg = NULL;
+  if(pthread_mutex_lock(&shard->mutex) != 0) tcmyfatal("pthread_mutex_lock failed");
+  int32_t *lp;
+  int32_t idx = tchdbrcsearch(shard, kbuf, ksiz, hash, &lp);
+  if(idx >= 0){
+    HDBRCSLOT *slot = shard->slots + idx;
+    *lp = slot->next;
+    rec = slot->rec;
+    slot->rec = NULL;
+    slot->hot = false;
+    slot->next = shard->free;
+    shard->free = idx;
+    shard->num--;
+  }
+  HDBRCREC **negp = shard->negs + ((hash>>16)&shard->nmask);
+  if(*negp && tchdbrcrecmatch(*negp, kbuf, ksiz, hash)){
+    neg = *negp;
+    *negp = NULL;
+  }
+  pthread_mutex_unlock(&shard->mutex);
+  if(rec) tchdbrcrelease(rec);
+  if(neg) tchdbrcrelease(neg);
 }
 
 
@@ -3155,6 +4916,11 @@ static bool tchdbwalwrite(TCHDB *hdb, uint64_t off, int64_t size){
     return false;
   }
   wp += size;
+  if(hdb->wcnd && (hdb->omode & HDBOTSYNC)){
+    bool rv = tchdbwalgroup(hdb, buf, wp - buf);
+    if(buf != stack) TCFREE(buf);
+    return rv;
+  }
   if(!HDBLOCKWAL(hdb)) return false;
   if(!tcwrite(hdb->walfd, buf, wp - buf)){
     tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
@@ -3173,6 +4939,62 @@ static bool tchdbwalwrite(TCHDB *hdb, uint64_t off, int64_t size){
 }
 
 
+/* Write an event into the write ahead logging file by group commit.
+   `hdb' specifies the hash database object.
+   `buf' specifies the pointer to the region of the serialized event.
+   `size' specifies the size of the region.
+   If successful, the return value is true, else, it is false.
+   The event is appended to the queue.  The first thread which finds no leader becomes the
+   leader, writes every queued event at once and synchronizes the file once, while the other
+   threads wait until their events are covered by a synchronization. */
+static bool tchdbwalgroup(TCHDB *hdb, const char *buf, int size){
+  assert(hdb && buf && size >= 0);
+  if(!HDBLOCKWAL(hdb)) return false;
+  if(!hdb->walque) hdb->walque = tcxstrnew3(HDBIOBUFSIZ);
+  TCXSTRCAT(hdb->walque, buf, size);
+  uint64_t seq = ++hdb->walqnum;
+  while(hdb->walsnum < seq && !hdb->fatal){
+    if(!hdb->walsync){
+      hdb->walsync = true;
+      TCXSTR *que = hdb->walque;
+      hdb->walque = tcxstrnew3(HDBIOBUFSIZ);
+      uint64_t qnum = hdb->walqnum;
+      HDBUNLOCKWAL(hdb);
+      bool err = false;
+      if(!tcwrite(hdb->walfd, TCXSTRPTR(que), TCXSTRSIZE(que))){
+        tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+        err = true;
+      }
+#if defined(_SYS_LINUX_)
+      if(!err && fdatasync(hdb->walfd) == -1){
+#else
+      if(!err && fsync(hdb->walfd) == -1){
+#endif
+        tchdbsetecode(hdb, TCESYNC, __FILE__, __LINE__, __func__);
+        err = true;
+      }
+      tcxstrdel(que);
+      if(!HDBLOCKWAL(hdb)) return false;
+      if(!err) hdb->walsnum = qnum;
+      hdb->walsync = false;
+      pthread_cond_broadcast(hdb->wcnd);
+      if(err){
+        HDBUNLOCKWAL(hdb);
+        return false;
+      }
+    } else if(pthread_cond_wait(hdb->wcnd, hdb->wmtx) != 0){
+      tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
+      HDBUNLOCKWAL(hdb);
+      return false;
+    }
+  }
+  bool rv = hdb->walsnum >= seq;
+  if(!rv) tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+  HDBUNLOCKWAL(hdb);
+  return rv;
+}
+
+
 /* Restore the database from the write ahead logging file.
    `hdb' specifies the hash database object.
    `path' specifies the path of the database file.
@@ -3211,69 +5033,80 @@ static int tchdbwalrestore(TCHDB *hdb, const char *path){
       }
     }
     uint64_t fsiz = 0;
-    if(tcread(walfd, &fsiz, sizeof(fsiz))){
-      fsiz = TCITOHLL(fsiz);
-    } else {
-      tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
+    char *wmap = mmap(0, walsiz, PROT_READ, MAP_SHARED, walfd, 0);
+    if(wmap == MAP_FAILED){
+      tchdbsetecode(hdb, TCEMMAP, __FILE__, __LINE__, __func__);
+      wmap = NULL;
       err = true;
+    } else {
+      memcpy(&fsiz, wmap, sizeof(fsiz));
+      fsiz = TCITOHLL(fsiz);
     }
-    TCLIST *list = tclistnew();
-    uint64_t waloff = sizeof(fsiz);
-    char stack[HDBIOBUFSIZ];
-    while(waloff < walsiz){
-      uint64_t off;
-      uint32_t size;
-      if(!tcread(walfd, stack, sizeof(off) + sizeof(size))){
-        tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
-        err = true;
-        break;
-      }
-      memcpy(&off, stack, sizeof(off));
-      off = TCITOHLL(off);
-      memcpy(&size, stack + sizeof(off), sizeof(size));
-      size = TCITOHL(size);
-      char *buf;
-      if(sizeof(off) + size <= HDBIOBUFSIZ){
-        buf = stack;
-      } else {
-        TCMALLOC(buf, sizeof(off) + size);
-      }
-      *(uint64_t *)buf = off;
-      if(!tcread(walfd, buf + sizeof(off), size)){
-        tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
-        err = true;
-        if(buf != stack) TCFREE(buf);
-        break;
+    uint64_t *ary = NULL;
+    int anum = 0;
+    if(wmap){
+      int asiz = HDBIOBUFSIZ / sizeof(*ary);
+      TCMALLOC(ary, asiz * sizeof(*ary));
+      uint64_t waloff = sizeof(fsiz);
+      while(waloff < walsiz){
+        uint32_t size;
+        if(walsiz - waloff < sizeof(uint64_t) + sizeof(size)){
+          tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
+          err = true;
+          break;
+        }
+        memcpy(&size, wmap + waloff + sizeof(uint64_t), sizeof(size));
+        size = TCITOHL(size);
+        if(walsiz - waloff - sizeof(uint64_t) - sizeof(size) < size){
+          tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
+          err = true;
+          break;
+        }
+        if(anum >= asiz){
+          asiz *= 2;
+          TCREALLOC(ary, ary, asiz * sizeof(*ary));
+        }
+        ary[anum++] = waloff;
+        waloff += sizeof(uint64_t) + sizeof(size) + size;
       }
-      TCLISTPUSH(list, buf, sizeof(off) + size);
-      if(buf != stack) TCFREE(buf);
-      waloff += sizeof(off) + sizeof(size) + size;
     }
     size_t xmsiz = 0;
     if(hdb->fd >= 0 && hdb->map) xmsiz = (hdb->xmsiz > hdb->msiz) ? hdb->xmsiz : hdb->msiz;
-    for(int i = TCLISTNUM(list) - 1; i >= 0; i--){
-      const char *rec;
-      int size;
-      TCLISTVAL(rec, list, i, size);
-      uint64_t off = *(uint64_t *)rec;
-      rec += sizeof(off);
-      size -= sizeof(off);
+    uint64_t done = 0;
+    uint64_t mark = HDBWALPROGUNIT;
+    for(int i = anum - 1; i >= 0; i--){
+      const char *rp = wmap + ary[i];
+      uint64_t off;
+      memcpy(&off, rp, sizeof(off));
+      off = TCITOHLL(off);
+      rp += sizeof(off);
+      uint32_t size;
+      memcpy(&size, rp, sizeof(size));
+      size = TCITOHL(size);
+      rp += sizeof(size);
       if(lseek(dbfd, off, SEEK_SET) == -1){
         tchdbsetecode(hdb, TCESEEK, __FILE__, __LINE__, __func__);
         err = true;
         break;
       }
-      if(!tcwrite(dbfd, rec, size)){
+      if(!tcwrite(dbfd, rp, size)){
         tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
         err = true;
         break;
       }
       if(!TCUBCACHE && off < xmsiz){
-        size = (size <= xmsiz - off) ? size : xmsiz - off;
-        memcpy(hdb->map + off, rec, size);
+        size_t msiz = (size <= xmsiz - off) ? size : xmsiz - off;
+        memcpy(hdb->map + off, rp, msiz);
+      }
+      done += sizeof(off) + sizeof(size) + size;
+      if(hdb->rcvproc && done >= mark){
+        hdb->rcvproc(done, walsiz, hdb->rcvop);
+        mark = done + HDBWALPROGUNIT;
       }
     }
-    tclistdel(list);
+    if(hdb->rcvproc) hdb->rcvproc(walsiz, walsiz, hdb->rcvop);
+    TCFREE(ary);
+    if(wmap) munmap(wmap, walsiz);
     if(ftruncate(dbfd, fsiz) == -1){
       tchdbsetecode(hdb, TCETRUNC, __FILE__, __LINE__, __func__);
       err = true;
@@ -3314,6 +5147,210 @@ static bool tchdbwalremove(TCHDB *hdb, const char *path){
 }
 
 
+/* Add a key to the Bloom filter of a hash database object.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   All bits of a key are in one block of a cache line.  They are set atomically because writers
+   of different buckets share the blocks. */
+static void tchdbbloomadd(TCHDB *hdb, const char *kbuf, int ksiz){
+  assert(hdb && kbuf && ksiz >= 0);
+  uint64_t hash = tchdbxhash(kbuf, ksiz);
+  uint64_t *block = hdb->bloom + ((hash >> 32) * hdb->bfbnum >> 32) * HDBBFBWORDS;
+  uint32_t pos = hash;
+  uint32_t step = (pos >> 9) | 1;
+  for(int i = 0; i < HDBBFPROBE; i++){
+    uint64_t *wp = block + ((pos >> 6) & (HDBBFBWORDS - 1));
+    uint64_t mask = 1ULL << (pos & 63);
+    if(!(*wp & mask)) __sync_fetch_and_or(wp, mask);
+    pos += step;
+  }
+}
+
+
+/* Check whether a key may exist by the Bloom filter of a hash database object.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   The return value is false if the key does not exist surely, else, it is true. */
+static bool tchdbbloomcheck(TCHDB *hdb, const char *kbuf, int ksiz){
+  assert(hdb && kbuf && ksiz >= 0);
+  uint64_t hash = tchdbxhash(kbuf, ksiz);
+  const uint64_t *block = hdb->bloom + ((hash >> 32) * hdb->bfbnum >> 32) * HDBBFBWORDS;
+  uint32_t pos = hash;
+  uint32_t step = (pos >> 9) | 1;
+  for(int i = 0; i < HDBBFPROBE; i++){
+    if(!(block[(pos>>6)&(HDBBFBWORDS-1)] & (1ULL << (pos & 63)))) return false;
+    pos += step;
+  }
+  return true;
+}
+
+
+/* Set up the Bloom filter of a hash database object after the database file is opened.
+   `hdb' specifies the hash database object.
+   If successful, the return value is true, else, it is false.
+   A writer removes the sidecar file at once so that a crash or a writer without the filter can
+   never leave a stale one behind.  It is written again when the writer closes the database,
+   before the file and its lock are released. */
+static bool tchdbbloomopen(TCHDB *hdb){
+  assert(hdb);
+  char *tpath = tcsprintf("%s%c%s", hdb->path, MYEXTCHR, HDBBFSUFFIX);
+  bool err = false;
+  if(hdb->bfnum > 0 && !(hdb->omode & HDBONOLCK)){
+    if(((hdb->omode & HDBOWRITER) && (hdb->omode & HDBOTRUNC)) || !tchdbbloomload(hdb, tpath)){
+      if(!tchdbbloomrebuild(hdb)) err = true;
+    }
+  }
+  if(!err && (hdb->omode & HDBOWRITER) && unlink(tpath) == -1 && errno != ENOENT){
+    tchdbsetecode(hdb, TCEUNLINK, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  TCFREE(tpath);
+  if(err){
+    TCFREE(hdb->bloom);
+    hdb->bloom = NULL;
+    hdb->bfbnum = 0;
+  }
+  return !err;
+}
+
+
+/* Load the Bloom filter of a hash database object from the sidecar file.
+   `hdb' specifies the hash database object.
+   `path' specifies the path of the sidecar file.
+   The return value is true if a filter matching the database file was loaded, else, it is
+   false.  The generation number of the file tells updates which keep its size and the number of
+   records. */
+static bool tchdbbloomload(TCHDB *hdb, const char *path){
+  assert(hdb && path);
+  int fd = open(path, O_RDONLY, HDBFILEMODE);
+  if(fd < 0) return false;
+  char hbuf[HDBBFHEADSIZ];
+  struct stat sbuf;
+  if(fstat(fd, &sbuf) == -1 || !tcread(fd, hbuf, HDBBFHEADSIZ) ||
+     memcmp(hbuf, HDBBFMAGIC, sizeof(HDBBFMAGIC) - 1)){
+    close(fd);
+    return false;
+  }
+  uint64_t llnum;
+  uint64_t meta[5];
+  for(int i = 0; i < 5; i++){
+    memcpy(&llnum, hbuf + 16 + i * sizeof(llnum), sizeof(llnum));
+    meta[i] = TCITOHLL(llnum);
+  }
+  uint64_t bfbnum = meta[0];
+  if(bfbnum < 1 || bfbnum > UINT32_MAX || meta[1] != hdb->inode || meta[2] != hdb->fsiz ||
+     meta[3] != hdb->rnum || meta[4] != hdb->gen ||
+     sbuf.st_size != HDBBFHEADSIZ + bfbnum * HDBBFBWORDS * sizeof(uint64_t)){
+    close(fd);
+    return false;
+  }
+  uint64_t *bloom;
+  TCMALLOC(bloom, bfbnum * HDBBFBWORDS * sizeof(uint64_t));
+  if(!tcread(fd, bloom, bfbnum * HDBBFBWORDS * sizeof(uint64_t))){
+    TCFREE(bloom);
+    close(fd);
+    return false;
+  }
+  close(fd);
+  for(uint64_t i = 0; i < bfbnum * HDBBFBWORDS; i++){
+    bloom[i] = TCITOHLL(bloom[i]);
+  }
+  hdb->bloom = bloom;
+  hdb->bfbnum = bfbnum;
+  return true;
+}
+
+
+/* Rebuild the Bloom filter of a hash database object by scanning all records.
+   `hdb' specifies the hash database object.
+   If successful, the return value is true, else, it is false. */
+static bool tchdbbloomrebuild(TCHDB *hdb){
+  assert(hdb);
+  uint64_t bfbnum = (tclmax(hdb->bfnum, hdb->rnum) * HDBBFBITS) /
+    (HDBBFBWORDS * sizeof(uint64_t) * 8) + 1;
+  if(bfbnum > UINT32_MAX) bfbnum = UINT32_MAX;
+  TCFREE(hdb->bloom);
+  TCCALLOC(hdb->bloom, bfbnum * HDBBFBWORDS, sizeof(uint64_t));
+  hdb->bfbnum = bfbnum;
+  if(hdb->rnum < 1) return true;
+  bool err = false;
+  uint64_t off = hdb->frec;
+  TCHREC rec;
+  char rbuf[HDBIOBUFSIZ];
+  while(off < hdb->fsiz){
+    rec.off = off;
+    if(!tchdbreadrec(hdb, &rec, rbuf)){
+      err = true;
+      break;
+    }
+    off += rec.rsiz;
+    if(rec.magic == HDBMAGICREC){
+      if(!rec.kbuf && !tchdbreadrecbody(hdb, &rec)){
+        TCFREE(rec.bbuf);
+        err = true;
+        break;
+      }
+      tchdbbloomadd(hdb, rec.kbuf, rec.ksiz);
+      TCFREE(rec.bbuf);
+    }
+  }
+  return !err;
+}
+
+
+/* Save the Bloom filter of a hash database object into the sidecar file.
+   `hdb' specifies the hash database object.
+   If successful, the return value is true, else, it is false.
+   The file is written under a temporary name and renamed so that a reader never sees a partial
+   one. */
+static bool tchdbbloomsave(TCHDB *hdb){
+  assert(hdb && hdb->bloom);
+  char *path = tcsprintf("%s%c%s", hdb->path, MYEXTCHR, HDBBFSUFFIX);
+  char *tpath = tcsprintf("%s%ctmp", path, MYEXTCHR);
+  bool err = false;
+  int fd = open(tpath, O_WRONLY | O_CREAT | O_TRUNC, HDBFILEMODE);
+  if(fd < 0){
+    tchdbsetecode(hdb, TCEOPEN, __FILE__, __LINE__, __func__);
+    TCFREE(tpath);
+    TCFREE(path);
+    return false;
+  }
+  char hbuf[HDBBFHEADSIZ];
+  memset(hbuf, 0, HDBBFHEADSIZ);
+  memcpy(hbuf, HDBBFMAGIC, sizeof(HDBBFMAGIC) - 1);
+  uint64_t meta[5] = { hdb->bfbnum, hdb->inode, hdb->fsiz, hdb->rnum, hdb->gen };
+  for(int i = 0; i < 5; i++){
+    uint64_t llnum = TCHTOILL(meta[i]);
+    memcpy(hbuf + 16 + i * sizeof(llnum), &llnum, sizeof(llnum));
+  }
+  if(!tcwrite(fd, hbuf, HDBBFHEADSIZ)) err = true;
+  uint64_t wbuf[HDBIOBUFSIZ/sizeof(uint64_t)];
+  uint64_t wnum = hdb->bfbnum * HDBBFBWORDS;
+  for(uint64_t i = 0; !err && i < wnum; i += sizeof(wbuf) / sizeof(*wbuf)){
+    int num = tclmin(wnum - i, sizeof(wbuf) / sizeof(*wbuf));
+    for(int j = 0; j < num; j++){
+      wbuf[j] = TCHTOILL(hdb->bloom[i+j]);
+    }
+    if(!tcwrite(fd, wbuf, num * sizeof(*wbuf))) err = true;
+  }
+  if(err) tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+  if(close(fd) == -1 && !err){
+    tchdbsetecode(hdb, TCECLOSE, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  if(!err && rename(tpath, path) == -1){
+    tchdbsetecode(hdb, TCERENAME, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  if(err) unlink(tpath);
+  TCFREE(tpath);
+  TCFREE(path);
+  return !err;
+}
+
+
 /* Open a database file and connect a hash database object.
    `hdb' specifies the hash database object.
    `path' specifies the path of the database file.
@@ -3368,8 +5405,16 @@ static bool tchdbopenimpl(TCHDB *hdb, const char *path, int omode){
     uint32_t fbpmax = 1 << hdb->fpow;
     uint32_t fbpsiz = HDBFBPBSIZ + fbpmax * HDBFBPESIZ;
     int besiz = (hdb->opts & HDBTLARGE) ? sizeof(int64_t) : sizeof(int32_t);
+    if(hdb->lhmax > hdb->bnum){
+      hdb->lhbase = hdb->bnum;
+      hdb->lhspan = hdb->bnum;
+    } else {
+      hdb->lhbase = 0;
+      hdb->lhmax = 0;
+      hdb->lhspan = 0;
+    }
     hdb->align = 1 << hdb->apow;
-    hdb->fsiz = HDBHEADSIZ + besiz * hdb->bnum + fbpsiz;
+    hdb->fsiz = HDBHEADSIZ + besiz * (hdb->lhbase > 0 ? hdb->lhmax : hdb->bnum) + fbpsiz;
     hdb->fsiz += tchdbpadsize(hdb, hdb->fsiz);
     hdb->frec = hdb->fsiz;
     tchdbdumpmeta(hdb, hbuf);
@@ -3378,6 +5423,10 @@ static bool tchdbopenimpl(TCHDB *hdb, const char *path, int omode){
     char pbuf[HDBIOBUFSIZ];
     memset(pbuf, 0, HDBIOBUFSIZ);
     uint64_t psiz = hdb->fsiz - HDBHEADSIZ;
+    if(hdb->lhbase > 0){
+      if(ftruncate(fd, hdb->fsiz) == -1) err = true;
+      psiz = 0;
+    }
     while(psiz > 0){
       if(psiz > HDBIOBUFSIZ){
         if(!tcwrite(fd, pbuf, HDBIOBUFSIZ)) err = true;
@@ -3424,7 +5473,7 @@ static bool tchdbopenimpl(TCHDB *hdb, const char *path, int omode){
     }
   }
   int besiz = (hdb->opts & HDBTLARGE) ? sizeof(int64_t) : sizeof(int32_t);
-  size_t msiz = HDBHEADSIZ + hdb->bnum * besiz;
+  size_t msiz = HDBHEADSIZ + (hdb->lhbase > 0 ? hdb->lhmax : hdb->bnum) * besiz;
   if(!(omode & HDBONOLCK)){
     if(memcmp(hbuf, HDBMAGICDATA, strlen(HDBMAGICDATA)) || hdb->type != type ||
        hdb->frec < msiz + HDBFBPBSIZ || hdb->frec > hdb->fsiz || sbuf.st_size < hdb->fsiz){
@@ -3440,27 +5489,39 @@ static bool tchdbopenimpl(TCHDB *hdb, const char *path, int omode){
     return false;
   }
   size_t xmsiz = (hdb->xmsiz > msiz) ? hdb->xmsiz : msiz;
-  if(!(omode & HDBOWRITER) && xmsiz > hdb->fsiz) xmsiz = hdb->fsiz;
-  void *map = mmap(0, xmsiz, PROT_READ | ((omode & HDBOWRITER) ? PROT_WRITE : 0),
-                   MAP_SHARED, fd, 0);
+  size_t xmlen = xmsiz;
+  if(hdb->xmmax > xmsiz){
+    xmsiz = tclmin(tclmax(xmsiz, tcpagealign(hdb->fsiz)), hdb->xmmax);
+    xmlen = (omode & HDBOWRITER) ? hdb->xmmax : xmsiz;
+  }
+  if(!(omode & HDBOWRITER) && xmsiz > hdb->fsiz) xmlen = xmsiz = hdb->fsiz;
+  int mprot = PROT_READ | ((omode & HDBOWRITER) ? PROT_WRITE : 0);
+  void *map = mmap(0, xmlen, mprot, MAP_SHARED, fd, 0);
+  if(map == MAP_FAILED && xmlen > xmsiz){
+    xmlen = xmsiz;
+    map = mmap(0, xmlen, mprot, MAP_SHARED, fd, 0);
+  }
   if(map == MAP_FAILED){
     tchdbsetecode(hdb, TCEMMAP, __FILE__, __LINE__, __func__);
     close(fd);
     return false;
   }
+  if(hdb->xmmax > 0) hdb->xmsiz = xmsiz;
   hdb->fbpmax = 1 << hdb->fpow;
   if(omode & HDBOWRITER){
-    TCMALLOC(hdb->fbpool, hdb->fbpmax * HDBFBPALWRAT * sizeof(HDBFB));
+    hdb->fbpool = tchdbfbpnew();
   } else {
     hdb->fbpool = NULL;
   }
   hdb->fbpnum = 0;
   hdb->fbpmis = 0;
+  hdb->fbplazy = false;
   hdb->async = false;
   hdb->drpool = NULL;
   hdb->drpdef = NULL;
   hdb->drpoff = 0;
-  hdb->recc = (hdb->rcnum > 0) ? tcmdbnew2(hdb->rcnum * 2 + 1) : NULL;
+  uint64_t nodes = (hdb->mopts & HDBMINTERLEAVE) ? tchdbnumanodes() : 0;
+  hdb->recc = (hdb->rcnum > 0) ? tchdbrcnew(hdb->rcnum, nodes) : NULL;
   hdb->path = tcstrdup(path);
   hdb->fd = fd;
   hdb->omode = omode;
@@ -3469,6 +5530,7 @@ static bool tchdbopenimpl(TCHDB *hdb, const char *path, int omode){
   hdb->map = map;
   hdb->msiz = msiz;
   hdb->xfsiz = 0;
+  hdb->xmlen = xmlen;
   if(hdb->opts & HDBTLARGE){
     hdb->ba32 = NULL;
     hdb->ba64 = (uint64_t *)((char *)map + HDBHEADSIZ);
@@ -3476,10 +5538,13 @@ static bool tchdbopenimpl(TCHDB *hdb, const char *path, int omode){
     hdb->ba32 = (uint32_t *)((char *)map + HDBHEADSIZ);
     hdb->ba64 = NULL;
   }
+  hdb->bamirror = NULL;
+  hdb->bmsiz = 0;
+  if(hdb->mopts) tchdbmapadvise(hdb, nodes);
   hdb->align = 1 << hdb->apow;
   hdb->runit = tclmin(tclmax(hdb->align, HDBMINRUNIT), HDBIOBUFSIZ);
   hdb->zmode = (hdb->opts & HDBTDEFLATE) || (hdb->opts & HDBTBZIP) ||
-    (hdb->opts & HDBTTCBS) || (hdb->opts & HDBTEXCODEC);
+    (hdb->opts & HDBTTCBS) || (hdb->opts & HDBTFAST) || (hdb->opts & HDBTEXCODEC);
   hdb->ecode = TCESUCCESS;
   hdb->fatal = false;
   hdb->inode = (uint64_t)sbuf.st_ino;
@@ -3488,20 +5553,38 @@ static bool tchdbopenimpl(TCHDB *hdb, const char *path, int omode){
   hdb->tran = false;
   hdb->walfd = -1;
   hdb->walend = 0;
+  if(hdb->walque) tcxstrclear(hdb->walque);
+  hdb->walsnum = hdb->walqnum;
+  hdb->walsync = false;
+  hdb->ring = (hdb->iodepth > 0) ? tchdbringnew(hdb->iodepth) : NULL;
   if(hdb->omode & HDBOWRITER){
     bool err = false;
-    if(!(hdb->flags & HDBFOPEN) && !tchdbloadfbp(hdb)) err = true;
-    memset(hbuf, 0, 2);
-    if(!tchdbseekwrite(hdb, hdb->msiz, hbuf, 2)) err = true;
+    hdb->genup = true;
+    if(hdb->flags & HDBFOPEN){
+      memset(hbuf, 0, 2);
+      if(!tchdbseekwrite(hdb, hdb->msiz, hbuf, 2)) err = true;
+    } else {
+      hdb->fbplazy = true;
+    }
     if(err){
       TCFREE(hdb->path);
-      TCFREE(hdb->fbpool);
-      munmap(hdb->map, xmsiz);
+      tchdbfbpdel(hdb->fbpool);
+      hdb->fbpool = NULL;
+      if(hdb->ring) tchdbringdel(hdb->ring);
+      hdb->ring = NULL;
+      munmap(hdb->map, xmlen);
       close(fd);
       hdb->fd = -1;
       return false;
     }
     tchdbsetflag(hdb, HDBFOPEN, true);
+    hdb->genup = false;
+  }
+  if(!tchdbbloomopen(hdb)){
+    int ecode = hdb->ecode;
+    tchdbcloseimpl(hdb);
+    hdb->ecode = ecode;
+    return false;
   }
   return true;
 }
@@ -3513,25 +5596,31 @@ static bool tchdbopenimpl(TCHDB *hdb, const char *path, int omode){
 static bool tchdbcloseimpl(TCHDB *hdb){
   assert(hdb);
   bool err = false;
+  bool tran = hdb->tran;
   if(hdb->recc){
-    tcmdbdel(hdb->recc);
+    tchdbrcdel(hdb->recc);
     hdb->recc = NULL;
   }
   if(hdb->omode & HDBOWRITER){
     if(!tchdbflushdrp(hdb)) err = true;
-    if(hdb->tran) hdb->fbpnum = 0;
+    if(hdb->tran) tchdbfbpclear(hdb);
     if(!tchdbsavefbp(hdb)) err = true;
-    TCFREE(hdb->fbpool);
+    tchdbfbpdel(hdb->fbpool);
+    hdb->fbpool = NULL;
     tchdbsetflag(hdb, HDBFOPEN, false);
+    if(hdb->bloom && !err && !tran && !hdb->fatal && !tchdbbloomsave(hdb)) err = true;
   }
   if((hdb->omode & HDBOWRITER) && !tchdbmemsync(hdb, false)) err = true;
-  size_t xmsiz = (hdb->xmsiz > hdb->msiz) ? hdb->xmsiz : hdb->msiz;
-  if(!(hdb->omode & HDBOWRITER) && xmsiz > hdb->fsiz) xmsiz = hdb->fsiz;
-  if(munmap(hdb->map, xmsiz) == -1){
+  if(munmap(hdb->map, hdb->xmlen) == -1){
     tchdbsetecode(hdb, TCEMMAP, __FILE__, __LINE__, __func__);
     err = true;
   }
   hdb->map = NULL;
+  if(hdb->bamirror){
+    munmap(hdb->bamirror, hdb->bmsiz);
+    hdb->bamirror = NULL;
+    hdb->bmsiz = 0;
+  }
   if((hdb->omode & HDBOWRITER) && ftruncate(hdb->fd, hdb->fsiz) == -1){
     tchdbsetecode(hdb, TCETRUNC, __FILE__, __LINE__, __func__);
     err = true;
@@ -3547,10 +5636,19 @@ static bool tchdbcloseimpl(TCHDB *hdb){
     }
     if(!hdb->fatal && !tchdbwalremove(hdb, hdb->path)) err = true;
   }
+  if(hdb->ring){
+    tchdbringdel(hdb->ring);
+    hdb->ring = NULL;
+  }
   if(close(hdb->fd) == -1){
     tchdbsetecode(hdb, TCECLOSE, __FILE__, __LINE__, __func__);
     err = true;
   }
+  if(hdb->bloom){
+    TCFREE(hdb->bloom);
+    hdb->bloom = NULL;
+    hdb->bfbnum = 0;
+  }
   TCFREE(hdb->path);
   hdb->path = NULL;
   hdb->fd = -1;
@@ -3558,6 +5656,65 @@ static bool tchdbcloseimpl(TCHDB *hdb){
 }
 
 
+/* Store a record with an absolute expiration time.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `vbuf' specifies the pointer to the region of the value.
+   `vsiz' specifies the size of the region of the value.
+   `xtime' specifies the expiration time.  If it is 0, the record does not expire.
+   If successful, the return value is true, else, it is false. */
+static bool tchdbputexpire(TCHDB *hdb, const char *kbuf, int ksiz, const char *vbuf, int vsiz,
+                           uint32_t xtime){
+  assert(hdb && kbuf && ksiz >= 0 && vbuf && vsiz >= 0);
+  if(!HDBLOCKMETHOD(hdb, false)) return false;
+  uint8_t hash;
+  uint64_t bidx = tchdbbidx(hdb, kbuf, ksiz, &hash);
+  if(hdb->fd < 0 || !(hdb->omode & HDBOWRITER)){
+    tchdbsetecode(hdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  if(!HDBLOCKRECORD(hdb, bidx, true)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  char *zbuf = NULL;
+  if(hdb->zmode){
+    if(hdb->opts & HDBTDEFLATE){
+      zbuf = _tc_deflate(vbuf, vsiz, &vsiz, _TCZMRAW);
+    } else if(hdb->opts & HDBTBZIP){
+      zbuf = _tc_bzcompress(vbuf, vsiz, &vsiz);
+    } else if(hdb->opts & HDBTTCBS){
+      zbuf = tcbsencode(vbuf, vsiz, &vsiz);
+    } else if(hdb->opts & HDBTFAST){
+      zbuf = tclzencode(vbuf, vsiz, &vsiz);
+    } else {
+      zbuf = hdb->enc(vbuf, vsiz, &vsiz, hdb->encop);
+    }
+    if(!zbuf){
+      tchdbsetecode(hdb, TCEMISC, __FILE__, __LINE__, __func__);
+      HDBUNLOCKRECORD(hdb, bidx);
+      HDBUNLOCKMETHOD(hdb);
+      return false;
+    }
+    vbuf = zbuf;
+  }
+  bool rv = tchdbputimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBPDOVER, xtime);
+  TCFREE(zbuf);
+  HDBUNLOCKRECORD(hdb, bidx);
+  HDBUNLOCKMETHOD(hdb);
+  if(hdb->dfunit > 0 && !hdb->dfworker && !hdb->snap && hdb->dfcnt > hdb->dfunit &&
+     !tchdbdefrag(hdb, hdb->dfunit * HDBDFRSRAT + 1)) rv = false;
+  if(HDBLHNEEDGROW(hdb) && !tchdbgrow(hdb, HDBLHSTEP)) rv = false;
+  return rv;
+}
+
+
 /* Store a record.
    `hdb' specifies the hash database object.
    `kbuf' specifies the pointer to the region of the key.
@@ -3567,11 +5724,15 @@ static bool tchdbcloseimpl(TCHDB *hdb){
    `vbuf' specifies the pointer to the region of the value.
    `vsiz' specifies the size of the region of the value.
    `dmode' specifies behavior when the key overlaps.
-   If successful, the return value is true, else, it is false. */
+   `xtime' specifies the expiration time of a new or overwritten record.  If it is `HDBXTKEEP',
+   an overwritten record keeps its expiration time.
+   If successful, the return value is true, else, it is false.
+   An expired record with the same key is treated as if it does not exist. */
 static bool tchdbputimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
-                         const char *vbuf, int vsiz, int dmode){
+                         const char *vbuf, int vsiz, int dmode, uint32_t xtime){
   assert(hdb && kbuf && ksiz >= 0);
-  if(hdb->recc) tcmdbout(hdb->recc, kbuf, ksiz);
+  if(hdb->bloom) tchdbbloomadd(hdb, kbuf, ksiz);
+  if(hdb->recc) tchdbrcout(hdb, kbuf, ksiz);
   off_t off = tchdbgetbucket(hdb, bidx);
   off_t entoff = 0;
   TCHREC rec;
@@ -3607,6 +5768,16 @@ static bool tchdbputimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
         int nvsiz;
         char *nvbuf;
         HDBPDPROCOP *procptr;
+        if(tchdbexpired(hdb, rec.xtime)){
+          if(!vbuf){
+            TCFREE(rec.bbuf);
+            if(!tchdbremoverec(hdb, &rec, rbuf, bidx, entoff)) return false;
+            tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+            return false;
+          }
+          dmode = HDBPDOVER;
+          if(xtime == HDBXTKEEP) xtime = 0;
+        }
         switch(dmode){
         case HDBPDKEEP:
           tchdbsetecode(hdb, TCEKEEP, __FILE__, __LINE__, __func__);
@@ -3713,6 +5884,7 @@ static bool tchdbputimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
         rec.vsiz = vsiz;
         rec.kbuf = kbuf;
         rec.vbuf = vbuf;
+        if(xtime != HDBXTKEEP) rec.xtime = xtime;
         return tchdbwriterec(hdb, &rec, bidx, entoff);
       }
     }
@@ -3723,22 +5895,22 @@ static bool tchdbputimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
   }
   if(!HDBLOCKDB(hdb)) return false;
   rec.rsiz = HDBMAXHSIZ + ksiz + vsiz;
-  if(!tchdbfbpsearch(hdb, &rec)){
+  if(!tchdbfbpsearch(hdb, &rec) || (rec.rsiz < 1 && !tchdbreserverec(hdb, &rec, ksiz, vsiz))){
     HDBUNLOCKDB(hdb);
     return false;
   }
+  HDBUNLOCKDB(hdb);
   rec.hash = hash;
   rec.left = 0;
   rec.right = 0;
   rec.ksiz = ksiz;
   rec.vsiz = vsiz;
   rec.psiz = 0;
+  rec.xtime = (xtime != HDBXTKEEP) ? xtime : 0;
   rec.kbuf = kbuf;
   rec.vbuf = vbuf;
-  if(!tchdbwriterec(hdb, &rec, bidx, entoff)){
-    HDBUNLOCKDB(hdb);
-    return false;
-  }
+  if(!tchdbwriterec(hdb, &rec, bidx, entoff)) return false;
+  if(!HDBLOCKDB(hdb)) return false;
   hdb->rnum++;
   uint64_t llnum = hdb->rnum;
   llnum = TCHTOILL(llnum);
@@ -3778,6 +5950,10 @@ static void tchdbdrpappend(TCHDB *hdb, const char *kbuf, int ksiz, const char *v
   wp += step;
   TCSETVNUMBUF(step, wp, vsiz);
   wp += step;
+  if(hdb->opts & HDBTTTL){
+    memset(wp, 0, sizeof(uint32_t));
+    wp += sizeof(uint32_t);
+  }
   int32_t hsiz = wp - rbuf;
   int32_t rsiz = hsiz + ksiz + vsiz;
   uint16_t psiz = tchdbpadsize(hdb, hdb->fsiz + rsiz);
@@ -3804,11 +5980,13 @@ static void tchdbdrpappend(TCHDB *hdb, const char *kbuf, int ksiz, const char *v
    `hash' specifies the hash value for the collision tree.
    `vbuf' specifies the pointer to the region of the value.
    `vsiz' specifies the size of the region of the value.
+   `unit' specifies the size of the pool to be flushed.
    If successful, the return value is true, else, it is false. */
 static bool tchdbputasyncimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
-                              const char *vbuf, int vsiz){
+                              const char *vbuf, int vsiz, int64_t unit){
   assert(hdb && kbuf && ksiz >= 0 && vbuf && vsiz >= 0);
-  if(hdb->recc) tcmdbout(hdb->recc, kbuf, ksiz);
+  if(hdb->recc) tchdbrcout(hdb, kbuf, ksiz);
+  if(hdb->bloom) tchdbbloomadd(hdb, kbuf, ksiz);
   if(!hdb->drpool){
     hdb->drpool = tcxstrnew3(HDBDRPUNIT + HDBDRPLAT);
     hdb->drpdef = tcxstrnew3(HDBDRPUNIT);
@@ -3826,7 +6004,7 @@ static bool tchdbputasyncimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t b
       TCXSTRCAT(drpdef, &vsiz, sizeof(vsiz));
       TCXSTRCAT(drpdef, kbuf, ksiz);
       TCXSTRCAT(drpdef, vbuf, vsiz);
-      if(TCXSTRSIZE(hdb->drpdef) > HDBDRPUNIT && !tchdbflushdrp(hdb)) return false;
+      if(TCXSTRSIZE(hdb->drpdef) > unit && !tchdbflushdrp(hdb)) return false;
       return true;
     }
     rec.off = off;
@@ -3845,7 +6023,7 @@ static bool tchdbputasyncimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t b
       TCXSTRCAT(drpdef, &vsiz, sizeof(vsiz));
       TCXSTRCAT(drpdef, kbuf, ksiz);
       TCXSTRCAT(drpdef, vbuf, vsiz);
-      if(TCXSTRSIZE(hdb->drpdef) > HDBDRPUNIT && !tchdbflushdrp(hdb)) return false;
+      if(TCXSTRSIZE(hdb->drpdef) > unit && !tchdbflushdrp(hdb)) return false;
       return true;
     }
   }
@@ -3864,11 +6042,79 @@ static bool tchdbputasyncimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t b
   }
   tchdbdrpappend(hdb, kbuf, ksiz, vbuf, vsiz, hash);
   hdb->rnum++;
-  if(TCXSTRSIZE(hdb->drpool) > HDBDRPUNIT && !tchdbflushdrp(hdb)) return false;
+  if(TCXSTRSIZE(hdb->drpool) > unit && !tchdbflushdrp(hdb)) return false;
   return true;
 }
 
 
+/* Store multiple records of a hash database object at once.
+   `hdb' specifies the hash database object.
+   `recs' specifies a list object containing keys and values alternately.
+   If successful, the return value is true, else, it is false.
+   The file is extended once for all of the records, and their bodies are appended to the tail
+   through the delayed record pool, which is flushed by large sequential writes.  Records whose
+   keys already exist are deferred and overwritten in place when the pool is flushed. */
+static bool tchdbputbatchimpl(TCHDB *hdb, const TCLIST *recs){
+  assert(hdb && recs);
+  int rnum = TCLISTNUM(recs) / 2;
+  if(rnum < 1) return true;
+  uint64_t size = 0;
+  for(int i = 0; i < rnum * 2; i++){
+    size += TCLISTVALSIZ(recs, i);
+  }
+  size += (uint64_t)rnum * (HDBMAXHSIZ + (1 << hdb->apow));
+  uint64_t end = hdb->fsiz + size;
+  if(end > hdb->xmsiz && end <= hdb->xmlen && !tchdbgrowmap(hdb, end)) return false;
+  if(end <= hdb->xmsiz && end > hdb->xfsiz){
+    if(!HDBLOCKDB(hdb)) return false;
+    if(end > hdb->xfsiz && !tchdbextendfile(hdb, end)){
+      HDBUNLOCKDB(hdb);
+      return false;
+    }
+    HDBUNLOCKDB(hdb);
+  }
+  if(!hdb->drpool){
+    hdb->drpool = tcxstrnew3(tclmin(size, HDBBATCHUNIT) + HDBDRPLAT);
+    hdb->drpdef = tcxstrnew3(HDBDRPUNIT);
+    hdb->drpoff = hdb->fsiz;
+  }
+  bool err = false;
+  for(int i = 0; !err && i < rnum; i++){
+    const char *kbuf, *vbuf;
+    int ksiz, vsiz;
+    TCLISTVAL(kbuf, recs, i * 2, ksiz);
+    TCLISTVAL(vbuf, recs, i * 2 + 1, vsiz);
+    uint8_t hash;
+    uint64_t bidx = tchdbbidx(hdb, kbuf, ksiz, &hash);
+    if(hdb->zmode){
+      char *zbuf;
+      if(hdb->opts & HDBTDEFLATE){
+        zbuf = _tc_deflate(vbuf, vsiz, &vsiz, _TCZMRAW);
+      } else if(hdb->opts & HDBTBZIP){
+        zbuf = _tc_bzcompress(vbuf, vsiz, &vsiz);
+      } else if(hdb->opts & HDBTTCBS){
+        zbuf = tcbsencode(vbuf, vsiz, &vsiz);
+      } else if(hdb->opts & HDBTFAST){
+        zbuf = tclzencode(vbuf, vsiz, &vsiz);
+      } else {
+        zbuf = hdb->enc(vbuf, vsiz, &vsiz, hdb->encop);
+      }
+      if(!zbuf){
+        tchdbsetecode(hdb, TCEMISC, __FILE__, __LINE__, __func__);
+        err = true;
+        break;
+      }
+      if(!tchdbputasyncimpl(hdb, kbuf, ksiz, bidx, hash, zbuf, vsiz, HDBBATCHUNIT)) err = true;
+      TCFREE(zbuf);
+    } else {
+      if(!tchdbputasyncimpl(hdb, kbuf, ksiz, bidx, hash, vbuf, vsiz, HDBBATCHUNIT)) err = true;
+    }
+  }
+  if(!tchdbflushdrp(hdb)) err = true;
+  return !err;
+}
+
+
 /* Remove a record of a hash database object.
    `hdb' specifies the hash database object.
    `kbuf' specifies the pointer to the region of the key.
@@ -3878,7 +6124,11 @@ static bool tchdbputasyncimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t b
    If successful, the return value is true, else, it is false. */
 static bool tchdboutimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash){
   assert(hdb && kbuf && ksiz >= 0);
-  if(hdb->recc) tcmdbout(hdb->recc, kbuf, ksiz);
+  if(hdb->recc) tchdbrcout(hdb, kbuf, ksiz);
+  if(hdb->bloom && !tchdbbloomcheck(hdb, kbuf, ksiz)){
+    tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+    return false;
+  }
   off_t off = tchdbgetbucket(hdb, bidx);
   off_t entoff = 0;
   TCHREC rec;
@@ -3912,6 +6162,11 @@ static bool tchdboutimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
       } else {
         TCFREE(rec.bbuf);
         rec.bbuf = NULL;
+        if(tchdbexpired(hdb, rec.xtime)){
+          if(!tchdbremoverec(hdb, &rec, rbuf, bidx, entoff)) return false;
+          tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+          return false;
+        }
         return tchdbremoverec(hdb, &rec, rbuf, bidx, entoff);
       }
     }
@@ -3934,18 +6189,42 @@ static bool tchdboutimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
 static char *tchdbgetimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
                           int *sp){
   assert(hdb && kbuf && ksiz >= 0 && sp);
+  return tchdbgetpreimpl(hdb, kbuf, ksiz, bidx, hash, NULL, 0, sp);
+}
+
+
+/* Retrieve a record in a hash database object with the prefetched head of the bucket.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `bidx' specifies the index of the bucket array.
+   `hash' specifies the hash value for the collision tree.
+   `hbuf' specifies the buffer holding the leading region of the first record of the bucket.  If
+   it is `NULL', the first record is read from the file.
+   `hsiz' specifies the size of the region in the buffer.
+   `sp' specifies the pointer to the variable into which the size of the region of the return
+   value is assigned.
+   If successful, the return value is the pointer to the region of the value of the corresponding
+   record. */
+static char *tchdbgetpreimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
+                             const char *hbuf, int hsiz, int *sp){
+  assert(hdb && kbuf && ksiz >= 0 && sp);
+  if(hdb->bloom && !tchdbbloomcheck(hdb, kbuf, ksiz)){
+    tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+    return NULL;
+  }
   if(hdb->recc){
-    int tvsiz;
-    char *tvbuf = tcmdbget(hdb->recc, kbuf, ksiz, &tvsiz);
-    if(tvbuf){
-      if(*tvbuf == '*'){
-        tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
-        TCFREE(tvbuf);
-        return NULL;
-      }
-      *sp = tvsiz - 1;
-      memmove(tvbuf, tvbuf + 1, tvsiz);
-      return tvbuf;
+    HDBRCREC *crec;
+    int crv = tchdbrcget(hdb, kbuf, ksiz, &crec);
+    if(crv == 0){
+      tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+      return NULL;
+    } else if(crv > 0){
+      char *rv;
+      TCMEMDUP(rv, crec->buf + crec->ksiz, crec->vsiz);
+      *sp = crec->vsiz;
+      tchdbrcrelease(crec);
+      return rv;
     }
   }
   off_t off = tchdbgetbucket(hdb, bidx);
@@ -3953,7 +6232,12 @@ static char *tchdbgetimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
   char rbuf[HDBIOBUFSIZ];
   while(off > 0){
     rec.off = off;
-    if(!tchdbreadrec(hdb, &rec, rbuf)) return NULL;
+    if(hbuf){
+      if(!tchdbparserec(hdb, &rec, hbuf, hsiz)) return NULL;
+      hbuf = NULL;
+    } else if(!tchdbreadrec(hdb, &rec, rbuf)){
+      return NULL;
+    }
     if(hash > rec.hash){
       off = rec.left;
     } else if(hash < rec.hash){
@@ -3972,6 +6256,10 @@ static char *tchdbgetimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
         rec.kbuf = NULL;
         rec.bbuf = NULL;
       } else {
+        if(tchdbexpired(hdb, rec.xtime)){
+          TCFREE(rec.bbuf);
+          break;
+        }
         if(!rec.vbuf && !tchdbreadrecbody(hdb, &rec)) return NULL;
         if(hdb->zmode){
           int zsiz;
@@ -3982,6 +6270,8 @@ static char *tchdbgetimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
             zbuf = _tc_bzdecompress(rec.vbuf, rec.vsiz, &zsiz);
           } else if(hdb->opts & HDBTTCBS){
             zbuf = tcbsdecode(rec.vbuf, rec.vsiz, &zsiz);
+          } else if(hdb->opts & HDBTFAST){
+            zbuf = tclzdecode(rec.vbuf, rec.vsiz, &zsiz);
           } else {
             zbuf = hdb->dec(rec.vbuf, rec.vsiz, &zsiz, hdb->decop);
           }
@@ -3990,17 +6280,11 @@ static char *tchdbgetimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
             tchdbsetecode(hdb, TCEMISC, __FILE__, __LINE__, __func__);
             return NULL;
           }
-          if(hdb->recc){
-            if(tcmdbrnum(hdb->recc) >= hdb->rcnum) tchdbcacheadjust(hdb);
-            tcmdbput4(hdb->recc, kbuf, ksiz, "=", 1, zbuf, zsiz);
-          }
+          if(hdb->recc && rec.xtime < 1) tchdbrcput(hdb, kbuf, ksiz, zbuf, zsiz);
           *sp = zsiz;
           return zbuf;
         }
-        if(hdb->recc){
-          if(tcmdbrnum(hdb->recc) >= hdb->rcnum) tchdbcacheadjust(hdb);
-          tcmdbput4(hdb->recc, kbuf, ksiz, "=", 1, rec.vbuf, rec.vsiz);
-        }
+        if(hdb->recc && rec.xtime < 1) tchdbrcput(hdb, kbuf, ksiz, rec.vbuf, rec.vsiz);
         if(rec.bbuf){
           memmove(rec.bbuf, rec.vbuf, rec.vsiz);
           rec.bbuf[rec.vsiz] = '\0';
@@ -4014,19 +6298,118 @@ static char *tchdbgetimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
       }
     }
   }
-  if(hdb->recc){
-    if(tcmdbrnum(hdb->recc) >= hdb->rcnum) tchdbcacheadjust(hdb);
-    tcmdbput(hdb->recc, kbuf, ksiz, "*", 1);
-  }
+  if(hdb->recc) tchdbrcputneg(hdb, kbuf, ksiz);
   tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
   return NULL;
 }
 
 
-/* Retrieve a record in a hash database object and write the value into a buffer.
+/* Retrieve multiple records through the asynchronous I/O ring.
    `hdb' specifies the hash database object.
-   `kbuf' specifies the pointer to the region of the key.
-   `ksiz' specifies the size of the region of the key.
+   `keys' specifies a list object containing the keys.
+   `recs' specifies a map object into which the retrieved records are stored.
+   If successful, the return value is true, else, it is false.
+   The caller should hold the mutex of the ring.  The first records of the buckets are read in
+   batches of the depth of the ring into its slots.  Only the record locks of the buckets of a
+   batch are held while it is read and parsed, so that the heads are not changed before they are
+   parsed.  They are taken in ascending order of the lock and released before the next batch,
+   so that writers to other buckets are not blocked during the whole call. */
+static bool tchdbgetmultiring(TCHDB *hdb, const TCLIST *keys, TCMAP *recs){
+  assert(hdb && keys && recs);
+  HDBRING *ring = hdb->ring;
+  int knum = TCLISTNUM(keys);
+  HDBPROBE *probes;
+  TCMALLOC(probes, sizeof(*probes) * knum + 1);
+  for(int i = 0; i < knum; i++){
+    const char *kbuf;
+    int ksiz;
+    TCLISTVAL(kbuf, keys, i, ksiz);
+    HDBPROBE *probe = probes + i;
+    probe->bidx = tchdbbidx(hdb, kbuf, ksiz, &probe->hash);
+    probe->off = tchdbgetbucket(hdb, probe->bidx);
+    probe->kidx = i;
+  }
+  qsort(probes, knum, sizeof(*probes), tchdbprobecmp);
+  uint32_t *lidxs;
+  TCMALLOC(lidxs, sizeof(*lidxs) * ring->depth + 1);
+  uint32_t lmask = (hdb->rmtxnum > 0) ? hdb->rmtxnum - 1 : 0;
+  bool err = false;
+  for(int base = 0; !err && base < knum; base += ring->depth){
+    int pnum = tclmin(knum - base, ring->depth);
+    int lnum = 0;
+    for(int i = 0; i < pnum; i++){
+      uint32_t lidx = probes[base+i].bidx & lmask;
+      int pos = lnum;
+      while(pos > 0 && lidxs[pos-1] > lidx){
+        pos--;
+      }
+      if(pos > 0 && lidxs[pos-1] == lidx) continue;
+      memmove(lidxs + pos + 1, lidxs + pos, sizeof(*lidxs) * (lnum - pos));
+      lidxs[pos] = lidx;
+      lnum++;
+    }
+    int lcnt = 0;
+    while(lcnt < lnum && HDBLOCKRECORD(hdb, lidxs[lcnt], false)){
+      lcnt++;
+    }
+    if(lcnt < lnum){
+      while(--lcnt >= 0){
+        HDBUNLOCKRECORD(hdb, lidxs[lcnt]);
+      }
+      err = true;
+      break;
+    }
+    int rnum = 0;
+    for(int i = 0; i < pnum; i++){
+      HDBPROBE *probe = probes + base + i;
+      probe->off = tchdbgetbucket(hdb, probe->bidx);
+      if(probe->off < 1 || probe->off + hdb->runit <= hdb->xmsiz ||
+         probe->off + hdb->runit > hdb->fsiz) continue;
+      HDBIOREQ *req = ring->reqs + rnum++;
+      req->off = probe->off;
+      req->buf = ring->bufs + i * HDBIOBUFSIZ;
+      req->size = hdb->runit;
+    }
+    if(rnum > 0 && !tchdbringio(hdb, ring->reqs, rnum, false)) err = true;
+    HDBIOREQ *req = ring->reqs;
+    for(int i = 0; !err && i < pnum; i++){
+      HDBPROBE *probe = probes + base + i;
+      const char *kbuf;
+      int ksiz;
+      TCLISTVAL(kbuf, keys, probe->kidx, ksiz);
+      const char *hbuf = NULL;
+      int hsiz = 0;
+      if(req < ring->reqs + rnum && req->off == probe->off &&
+         req->buf == ring->bufs + i * HDBIOBUFSIZ){
+        if(req->done >= req->size){
+          hbuf = req->buf;
+          hsiz = req->done;
+        }
+        req++;
+      }
+      int vsiz;
+      char *vbuf = tchdbgetpreimpl(hdb, kbuf, ksiz, probe->bidx, probe->hash, hbuf, hsiz, &vsiz);
+      if(vbuf){
+        tcmapput(recs, kbuf, ksiz, vbuf, vsiz);
+        TCFREE(vbuf);
+      } else if(tchdbecode(hdb) != TCENOREC){
+        err = true;
+      }
+    }
+    for(int i = lnum - 1; i >= 0; i--){
+      if(!HDBUNLOCKRECORD(hdb, lidxs[i])) err = true;
+    }
+  }
+  TCFREE(lidxs);
+  TCFREE(probes);
+  return !err;
+}
+
+
+/* Retrieve a record in a hash database object and write the value into a buffer.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
    `bidx' specifies the index of the bucket array.
    `hash' specifies the hash value for the collision tree.
    `vbuf' specifies the pointer to the buffer into which the value of the corresponding record is
@@ -4036,19 +6419,21 @@ static char *tchdbgetimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
 static int tchdbgetintobuf(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
                            char *vbuf, int max){
   assert(hdb && kbuf && ksiz >= 0 && vbuf && max >= 0);
+  if(hdb->bloom && !tchdbbloomcheck(hdb, kbuf, ksiz)){
+    tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+    return -1;
+  }
   if(hdb->recc){
-    int tvsiz;
-    char *tvbuf = tcmdbget(hdb->recc, kbuf, ksiz, &tvsiz);
-    if(tvbuf){
-      if(*tvbuf == '*'){
-        tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
-        TCFREE(tvbuf);
-        return -1;
-      }
-      tvsiz = tclmin(tvsiz - 1, max);
-      memcpy(vbuf, tvbuf + 1, tvsiz);
-      TCFREE(tvbuf);
-      return tvsiz;
+    HDBRCREC *crec;
+    int crv = tchdbrcget(hdb, kbuf, ksiz, &crec);
+    if(crv == 0){
+      tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+      return -1;
+    } else if(crv > 0){
+      int rv = tclmin(crec->vsiz, max);
+      memcpy(vbuf, crec->buf + crec->ksiz, rv);
+      tchdbrcrelease(crec);
+      return rv;
     }
   }
   off_t off = tchdbgetbucket(hdb, bidx);
@@ -4075,6 +6460,10 @@ static int tchdbgetintobuf(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx
         rec.kbuf = NULL;
         rec.bbuf = NULL;
       } else {
+        if(tchdbexpired(hdb, rec.xtime)){
+          TCFREE(rec.bbuf);
+          break;
+        }
         if(!rec.vbuf && !tchdbreadrecbody(hdb, &rec)) return -1;
         if(hdb->zmode){
           int zsiz;
@@ -4085,6 +6474,8 @@ static int tchdbgetintobuf(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx
             zbuf = _tc_bzdecompress(rec.vbuf, rec.vsiz, &zsiz);
           } else if(hdb->opts & HDBTTCBS){
             zbuf = tcbsdecode(rec.vbuf, rec.vsiz, &zsiz);
+          } else if(hdb->opts & HDBTFAST){
+            zbuf = tclzdecode(rec.vbuf, rec.vsiz, &zsiz);
           } else {
             zbuf = hdb->dec(rec.vbuf, rec.vsiz, &zsiz, hdb->decop);
           }
@@ -4093,19 +6484,13 @@ static int tchdbgetintobuf(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx
             tchdbsetecode(hdb, TCEMISC, __FILE__, __LINE__, __func__);
             return -1;
           }
-          if(hdb->recc){
-            if(tcmdbrnum(hdb->recc) >= hdb->rcnum) tchdbcacheadjust(hdb);
-            tcmdbput4(hdb->recc, kbuf, ksiz, "=", 1, zbuf, zsiz);
-          }
+          if(hdb->recc && rec.xtime < 1) tchdbrcput(hdb, kbuf, ksiz, zbuf, zsiz);
           zsiz = tclmin(zsiz, max);
           memcpy(vbuf, zbuf, zsiz);
           TCFREE(zbuf);
           return zsiz;
         }
-        if(hdb->recc){
-          if(tcmdbrnum(hdb->recc) >= hdb->rcnum) tchdbcacheadjust(hdb);
-          tcmdbput4(hdb->recc, kbuf, ksiz, "=", 1, rec.vbuf, rec.vsiz);
-        }
+        if(hdb->recc && rec.xtime < 1) tchdbrcput(hdb, kbuf, ksiz, rec.vbuf, rec.vsiz);
         int vsiz = tclmin(rec.vsiz, max);
         memcpy(vbuf, rec.vbuf, vsiz);
         TCFREE(rec.bbuf);
@@ -4113,15 +6498,208 @@ static int tchdbgetintobuf(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx
       }
     }
   }
-  if(hdb->recc){
-    if(tcmdbrnum(hdb->recc) >= hdb->rcnum) tchdbcacheadjust(hdb);
-    tcmdbput(hdb->recc, kbuf, ksiz, "*", 1);
-  }
+  if(hdb->recc) tchdbrcputneg(hdb, kbuf, ksiz);
   tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
   return -1;
 }
 
 
+/* Retrieve a record in a hash database object without locking.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `vbp' specifies the pointer to the variable into which the pointer to the value is assigned.
+   `sp' specifies the pointer to the variable into which the size of the value is assigned.
+   The return value is 1 if the record was found, 0 if it does not exist, or -1 if the caller
+   should fall back on the locking path.
+   The bucket tree is scanned straight out of the mapped region and the result is validated
+   with the sequence number of the record lock; exclusive methods are kept out by the reader
+   count of the slot of the calling thread.  Only the first few record locks serve as the slots,
+   so that an exclusive method does not wait on every stripe. */
+static int tchdbgetoptimistic(TCHDB *hdb, const char *kbuf, int ksiz, char **vbp, int *sp){
+  assert(hdb && kbuf && ksiz >= 0 && vbp && sp);
+  HDBRLOCK *rmtxs = hdb->rmtxs;
+  uintptr_t tid = (uintptr_t)&rmtxs;
+  int snum = tclmin(hdb->rmtxnum, HDBOPTRDSLOT);
+  HDBRLOCKBODY *slot = &rmtxs[((tid >> 12) ^ (tid >> 20))&(snum-1)].b;
+  __sync_fetch_and_add(&slot->rdnum, 1);
+  if((hdb->mseq & 1) || hdb->fd < 0){
+    __sync_fetch_and_sub(&slot->rdnum, 1);
+    return -1;
+  }
+  if(hdb->bloom && !tchdbbloomcheck(hdb, kbuf, ksiz)){
+    __sync_fetch_and_sub(&slot->rdnum, 1);
+    return 0;
+  }
+  if(hdb->async){
+    __sync_fetch_and_sub(&slot->rdnum, 1);
+    return -1;
+  }
+  if(hdb->recc){
+    HDBRCREC *crec;
+    int crv = tchdbrcget(hdb, kbuf, ksiz, &crec);
+    __sync_fetch_and_sub(&slot->rdnum, 1);
+    if(crv > 0){
+      TCMEMDUP(*vbp, crec->buf + crec->ksiz, crec->vsiz);
+      *sp = crec->vsiz;
+      tchdbrcrelease(crec);
+    }
+    return crv;
+  }
+  uint8_t hash;
+  uint64_t bidx = tchdbbidx(hdb, kbuf, ksiz, &hash);
+  HDBRLOCKBODY *rlock = &rmtxs[bidx&(hdb->rmtxnum-1)].b;
+  int rv = -1;
+  for(int i = 0; i < HDBOPTRETRY && rv < 0; i++){
+    uint32_t seq = rlock->seq;
+    __sync_synchronize();
+    if(seq & 1){
+      sched_yield();
+      continue;
+    }
+    char *vbuf = NULL;
+    int vsiz = 0;
+    rv = tchdbgetoptscan(hdb, kbuf, ksiz, bidx, hash, &vbuf, &vsiz);
+    __sync_synchronize();
+    if(rlock->seq != seq){
+      TCFREE(vbuf);
+      rv = -1;
+    } else if(rv > 0){
+      *vbp = vbuf;
+      *sp = vsiz;
+    }
+  }
+  __sync_fetch_and_sub(&slot->rdnum, 1);
+  if(rv > 0 && hdb->zmode){
+    int zsiz;
+    char *zbuf;
+    if(hdb->opts & HDBTDEFLATE){
+      zbuf = _tc_inflate(*vbp, *sp, &zsiz, _TCZMRAW);
+    } else if(hdb->opts & HDBTBZIP){
+      zbuf = _tc_bzdecompress(*vbp, *sp, &zsiz);
+    } else if(hdb->opts & HDBTTCBS){
+      zbuf = tcbsdecode(*vbp, *sp, &zsiz);
+    } else if(hdb->opts & HDBTFAST){
+      zbuf = tclzdecode(*vbp, *sp, &zsiz);
+    } else {
+      zbuf = hdb->dec(*vbp, *sp, &zsiz, hdb->decop);
+    }
+    TCFREE(*vbp);
+    if(!zbuf){
+      tchdbsetecode(hdb, TCEMISC, __FILE__, __LINE__, __func__);
+      return -1;
+    }
+    *vbp = zbuf;
+    *sp = zsiz;
+  }
+  return rv;
+}
+
+
+/* Compare two probes of multiple retrieval by the offset.
+   `a' specifies the pointer to one probe.
+   `b' specifies the pointer to the other probe.
+   The return value is positive if the former is big, negative if the latter is big, 0 if both
+   are equivalent. */
+static int tchdbprobecmp(const void *a, const void *b){
+  assert(a && b);
+  uint64_t aoff = ((HDBPROBE *)a)->off;
+  uint64_t boff = ((HDBPROBE *)b)->off;
+  return (aoff > boff) ? 1 : ((aoff < boff) ? -1 : 0);
+}
+
+
+/* Scan the bucket tree of a record in the mapped region without locking.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `bidx' specifies the index of the bucket.
+   `hash' specifies the hash value for the collision tree.
+   `vbp' specifies the pointer to the variable into which the pointer to the value is assigned.
+   `sp' specifies the pointer to the variable into which the size of the value is assigned.
+   The return value is 1 if the record was found, 0 if it does not exist, or -1 if the tree
+   leaves the mapped region or looks inconsistent.
+   Concurrent writers may change anything under the scan, so every offset and size is checked
+   against the mapped region before it is followed and the result is only trusted after the
+   caller has validated the sequence number. */
+static int tchdbgetoptscan(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash,
+                           char **vbp, int *sp){
+  assert(hdb && kbuf && ksiz >= 0 && vbp && sp);
+  uint64_t limit = tclmin(hdb->fsiz, hdb->xmsiz);
+  uint64_t step = hdb->rnum + 1;
+  uint64_t off = tchdbgetbucket(hdb, bidx);
+  char rbuf[HDBMAXHSIZ+1];
+  while(off > 0){
+    if(off >= limit || step-- < 1) return -1;
+    int rsiz = tclmin(limit - off, HDBMAXHSIZ);
+    memcpy(rbuf, hdb->map + off, rsiz);
+    memset(rbuf + rsiz, 0, sizeof(rbuf) - rsiz);
+    const char *rp = rbuf;
+    if(*(uint8_t *)(rp++) != HDBMAGICREC) return -1;
+    uint8_t rhash = *(uint8_t *)(rp++);
+    uint64_t left, right;
+    if(hdb->ba64){
+      uint64_t llnum;
+      memcpy(&llnum, rp, sizeof(llnum));
+      left = TCITOHLL(llnum) << hdb->apow;
+      rp += sizeof(llnum);
+      memcpy(&llnum, rp, sizeof(llnum));
+      right = TCITOHLL(llnum) << hdb->apow;
+      rp += sizeof(llnum);
+    } else {
+      uint32_t lnum;
+      memcpy(&lnum, rp, sizeof(lnum));
+      left = (uint64_t)TCITOHL(lnum) << hdb->apow;
+      rp += sizeof(lnum);
+      memcpy(&lnum, rp, sizeof(lnum));
+      right = (uint64_t)TCITOHL(lnum) << hdb->apow;
+      rp += sizeof(lnum);
+    }
+    if(hash > rhash){
+      off = left;
+      continue;
+    } else if(hash < rhash){
+      off = right;
+      continue;
+    }
+    rp += sizeof(uint16_t);
+    uint32_t lnum;
+    int vstep;
+    TCREADVNUMBUF(rp, lnum, vstep);
+    uint64_t rksiz = lnum;
+    rp += vstep;
+    TCREADVNUMBUF(rp, lnum, vstep);
+    uint64_t rvsiz = lnum;
+    rp += vstep;
+    uint32_t xtime = 0;
+    if(hdb->opts & HDBTTTL){
+      memcpy(&lnum, rp, sizeof(lnum));
+      xtime = TCITOHL(lnum);
+      rp += sizeof(lnum);
+    }
+    if(rp - rbuf > rsiz) return -1;
+    uint64_t koff = off + (rp - rbuf);
+    if(rksiz > INT_MAX || rvsiz > INT_MAX || koff + rksiz + rvsiz > limit) return -1;
+    int kcmp = tcreckeycmp(kbuf, ksiz, hdb->map + koff, rksiz);
+    if(kcmp > 0){
+      off = left;
+    } else if(kcmp < 0){
+      off = right;
+    } else {
+      if(tchdbexpired(hdb, xtime)) return 0;
+      char *vbuf;
+      TCMALLOC(vbuf, rvsiz + 1);
+      memcpy(vbuf, hdb->map + koff + rksiz, rvsiz);
+      vbuf[rvsiz] = '\0';
+      *vbp = vbuf;
+      *sp = rvsiz;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+
 /* Retrieve the next record of a record in a hash database object.
    `hdb' specifies the hash database object.
    `kbuf' specifies the pointer to the region of the key.
@@ -4143,7 +6721,7 @@ static char *tchdbgetnextimpl(TCHDB *hdb, const char *kbuf, int ksiz, int *sp,
       rec.off = iter;
       if(!tchdbreadrec(hdb, &rec, rbuf)) return NULL;
       iter += rec.rsiz;
-      if(rec.magic == HDBMAGICREC){
+      if(rec.magic == HDBMAGICREC && !tchdbexpired(hdb, rec.xtime)){
         if(vbp){
           if(hdb->zmode){
             if(!tchdbreadrecbody(hdb, &rec)) return NULL;
@@ -4155,6 +6733,8 @@ static char *tchdbgetnextimpl(TCHDB *hdb, const char *kbuf, int ksiz, int *sp,
               zbuf = _tc_bzdecompress(rec.vbuf, rec.vsiz, &zsiz);
             } else if(hdb->opts & HDBTTCBS){
               zbuf = tcbsdecode(rec.vbuf, rec.vsiz, &zsiz);
+            } else if(hdb->opts & HDBTFAST){
+              zbuf = tclzdecode(rec.vbuf, rec.vsiz, &zsiz);
             } else {
               zbuf = hdb->dec(rec.vbuf, rec.vsiz, &zsiz, hdb->decop);
             }
@@ -4239,7 +6819,7 @@ static char *tchdbgetnextimpl(TCHDB *hdb, const char *kbuf, int ksiz, int *sp,
           rec.off = iter;
           if(!tchdbreadrec(hdb, &rec, rbuf)) return NULL;
           iter += rec.rsiz;
-          if(rec.magic == HDBMAGICREC){
+          if(rec.magic == HDBMAGICREC && !tchdbexpired(hdb, rec.xtime)){
             if(vbp){
               if(hdb->zmode){
                 if(!tchdbreadrecbody(hdb, &rec)) return NULL;
@@ -4251,6 +6831,8 @@ static char *tchdbgetnextimpl(TCHDB *hdb, const char *kbuf, int ksiz, int *sp,
                   zbuf = _tc_bzdecompress(rec.vbuf, rec.vsiz, &zsiz);
                 } else if(hdb->opts & HDBTTCBS){
                   zbuf = tcbsdecode(rec.vbuf, rec.vsiz, &zsiz);
+                } else if(hdb->opts & HDBTFAST){
+                  zbuf = tclzdecode(rec.vbuf, rec.vsiz, &zsiz);
                 } else {
                   zbuf = hdb->dec(rec.vbuf, rec.vsiz, &zsiz, hdb->decop);
                 }
@@ -4318,17 +6900,20 @@ static char *tchdbgetnextimpl(TCHDB *hdb, const char *kbuf, int ksiz, int *sp,
    it is -1. */
 static int tchdbvsizimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash){
   assert(hdb && kbuf && ksiz >= 0);
+  if(hdb->bloom && !tchdbbloomcheck(hdb, kbuf, ksiz)){
+    tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+    return -1;
+  }
   if(hdb->recc){
-    int tvsiz;
-    char *tvbuf = tcmdbget(hdb->recc, kbuf, ksiz, &tvsiz);
-    if(tvbuf){
-      if(*tvbuf == '*'){
-        tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
-        TCFREE(tvbuf);
-        return -1;
-      }
-      TCFREE(tvbuf);
-      return tvsiz - 1;
+    HDBRCREC *crec;
+    int crv = tchdbrcget(hdb, kbuf, ksiz, &crec);
+    if(crv == 0){
+      tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+      return -1;
+    } else if(crv > 0){
+      int rv = crec->vsiz;
+      tchdbrcrelease(crec);
+      return rv;
     }
   }
   off_t off = tchdbgetbucket(hdb, bidx);
@@ -4355,6 +6940,10 @@ static int tchdbvsizimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
         rec.kbuf = NULL;
         rec.bbuf = NULL;
       } else {
+        if(tchdbexpired(hdb, rec.xtime)){
+          TCFREE(rec.bbuf);
+          break;
+        }
         if(hdb->zmode){
           if(!rec.vbuf && !tchdbreadrecbody(hdb, &rec)) return -1;
           int zsiz;
@@ -4365,6 +6954,8 @@ static int tchdbvsizimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
             zbuf = _tc_bzdecompress(rec.vbuf, rec.vsiz, &zsiz);
           } else if(hdb->opts & HDBTTCBS){
             zbuf = tcbsdecode(rec.vbuf, rec.vsiz, &zsiz);
+          } else if(hdb->opts & HDBTFAST){
+            zbuf = tclzdecode(rec.vbuf, rec.vsiz, &zsiz);
           } else {
             zbuf = hdb->dec(rec.vbuf, rec.vsiz, &zsiz, hdb->decop);
           }
@@ -4373,31 +6964,176 @@ static int tchdbvsizimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx,
             tchdbsetecode(hdb, TCEMISC, __FILE__, __LINE__, __func__);
             return -1;
           }
-          if(hdb->recc){
-            if(tcmdbrnum(hdb->recc) >= hdb->rcnum) tchdbcacheadjust(hdb);
-            tcmdbput4(hdb->recc, kbuf, ksiz, "=", 1, zbuf, zsiz);
-          }
+          if(hdb->recc && rec.xtime < 1) tchdbrcput(hdb, kbuf, ksiz, zbuf, zsiz);
           TCFREE(zbuf);
           return zsiz;
         }
-        if(hdb->recc && rec.vbuf){
-          if(tcmdbrnum(hdb->recc) >= hdb->rcnum) tchdbcacheadjust(hdb);
-          tcmdbput4(hdb->recc, kbuf, ksiz, "=", 1, rec.vbuf, rec.vsiz);
-        }
+        if(hdb->recc && rec.vbuf && rec.xtime < 1) tchdbrcput(hdb, kbuf, ksiz, rec.vbuf, rec.vsiz);
         TCFREE(rec.bbuf);
         return rec.vsiz;
       }
     }
   }
-  if(hdb->recc){
-    if(tcmdbrnum(hdb->recc) >= hdb->rcnum) tchdbcacheadjust(hdb);
-    tcmdbput(hdb->recc, kbuf, ksiz, "*", 1);
-  }
+  if(hdb->recc) tchdbrcputneg(hdb, kbuf, ksiz);
   tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
   return -1;
 }
 
 
+/* Advise the operating system to read ahead a record of a hash database object.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `bidx' specifies the index of the bucket array.
+   `hash' specifies the hash value for the collision tree.
+   If successful, the return value is true, else, it is false. */
+static bool tchdbprefetchimpl(TCHDB *hdb, const char *kbuf, int ksiz, uint64_t bidx, uint8_t hash){
+  assert(hdb && kbuf && ksiz >= 0);
+  if(hdb->bloom && !tchdbbloomcheck(hdb, kbuf, ksiz)){
+    tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  off_t off = tchdbgetbucket(hdb, bidx);
+  TCHREC rec;
+  char rbuf[HDBIOBUFSIZ];
+  while(off > 0){
+    rec.off = off;
+    if(!tchdbreadrec(hdb, &rec, rbuf)) return false;
+    if(hash > rec.hash){
+      off = rec.left;
+    } else if(hash < rec.hash){
+      off = rec.right;
+    } else {
+      if(!rec.kbuf && !tchdbreadrecbody(hdb, &rec)) return false;
+      int kcmp = tcreckeycmp(kbuf, ksiz, rec.kbuf, rec.ksiz);
+      TCFREE(rec.bbuf);
+      if(kcmp > 0){
+        off = rec.left;
+      } else if(kcmp < 0){
+        off = rec.right;
+      } else {
+        if(!rec.vbuf) tchdbwillneed(hdb, rec.boff + rec.ksiz, rec.vsiz);
+        return true;
+      }
+    }
+  }
+  tchdbsetecode(hdb, TCENOREC, __FILE__, __LINE__, __func__);
+  return false;
+}
+
+
+/* Issue the read-ahead hint of a region of the database file.
+   `hdb' specifies the hash database object.
+   `off' specifies the offset of the region.
+   `size' specifies the size of the region. */
+static void tchdbwillneed(TCHDB *hdb, uint64_t off, int64_t size){
+  assert(hdb);
+  if(size < 1) return;
+  uint64_t end = off + size;
+  if(end <= hdb->xmsiz){
+#if defined(MADV_WILLNEED)
+    int ps = sysconf(_SC_PAGESIZE);
+    uint64_t base = off & ~((uint64_t)ps - 1);
+    madvise(hdb->map + base, end - base, MADV_WILLNEED);
+#endif
+  } else {
+#if defined(POSIX_FADV_WILLNEED)
+    posix_fadvise(hdb->fd, off, size, POSIX_FADV_WILLNEED);
+#endif
+  }
+}
+
+
+/* Get the online nodes of NUMA.
+   The return value is the bit mask of the online nodes, or 0 if there are not multiple nodes. */
+static uint64_t tchdbnumanodes(void){
+#if TCUSEMPOL
+  char *str = tcreadfile("/sys/devices/system/node/online", TCNUMBUFSIZ * 4, NULL);
+  if(!str) return 0;
+  uint64_t nodes = 0;
+  int nnum = 0;
+  char *rp = str;
+  while(*rp >= '0' && *rp <= '9'){
+    int lo = strtol(rp, &rp, 10);
+    int hi = lo;
+    if(*rp == '-') hi = strtol(rp + 1, &rp, 10);
+    for(int i = lo; i <= hi && i < sizeof(nodes) * 8; i++){
+      nodes |= 1ULL << i;
+      nnum++;
+    }
+    if(*rp != ',') break;
+    rp++;
+  }
+  TCFREE(str);
+  return (nnum > 1) ? nodes : 0;
+#else
+  return 0;
+#endif
+}
+
+
+/* Advise the kernel of the memory options of a region.
+   `ptr' specifies the pointer to the region aligned to a page.
+   `size' specifies the size of the region.
+   `huge' specifies whether the region should be backed by huge pages.
+   `nodes' specifies the bit mask of NUMA nodes over which the pages are interleaved.  If it is
+   0, the pages are placed by the default policy. */
+static void tchdbmemadvise(void *ptr, size_t size, bool huge, uint64_t nodes){
+  assert(ptr);
+#if defined(MADV_HUGEPAGE)
+  if(huge) madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+#if TCUSEMPOL
+  if(nodes){
+    unsigned long mask[(sizeof(nodes)-1)/sizeof(unsigned long)+1];
+    for(int i = 0; i < sizeof(mask) / sizeof(*mask); i++){
+      mask[i] = (unsigned long)(nodes >> (i * sizeof(*mask) * 8));
+    }
+    syscall(SYS_mbind, ptr, size, MPOL_INTERLEAVE, mask, sizeof(mask) * 8, 0);
+  }
+#endif
+}
+
+
+/* Map an anonymous region with memory options.
+   `size' specifies the size of the region.
+   `huge' specifies whether the region should be backed by huge pages.
+   `nodes' specifies the bit mask of NUMA nodes over which the pages are interleaved.
+   The return value is the pointer to the region filled with zero, or `NULL' on failure. */
+static void *tchdbmemmap(size_t size, bool huge, uint64_t nodes){
+  void *ptr = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if(ptr == MAP_FAILED) return NULL;
+  tchdbmemadvise(ptr, size, huge, nodes);
+  return ptr;
+}
+
+
+/* Apply the memory options to the bucket array of a hash database object.
+   `hdb' specifies the hash database object.
+   `nodes' specifies the bit mask of NUMA nodes over which the mirror is interleaved.
+   The region of the bucket array in the mapped memory is advised to be backed by huge pages, and
+   the bucket array of a reader is copied into the mirror which is referred to instead. */
+static void tchdbmapadvise(TCHDB *hdb, uint64_t nodes){
+  assert(hdb);
+  size_t basiz = hdb->bnum * (hdb->ba64 ? sizeof(uint64_t) : sizeof(uint32_t));
+  if(hdb->mopts & HDBMHUGE){
+    tchdbmemadvise(hdb->map, tclmin(tcpagealign(HDBHEADSIZ + basiz), hdb->xmlen), true, 0);
+  }
+  if(!(hdb->mopts & HDBMMIRROR) || (hdb->omode & HDBOWRITER) || basiz < 1) return;
+  size_t bmsiz = ((basiz - 1) / HDBHUGEUNIT + 1) * HDBHUGEUNIT;
+  void *mirror = tchdbmemmap(bmsiz, true, nodes);
+  if(!mirror) return;
+  memcpy(mirror, hdb->map + HDBHEADSIZ, basiz);
+  if(hdb->ba64){
+    hdb->ba64 = mirror;
+  } else {
+    hdb->ba32 = mirror;
+  }
+  hdb->bamirror = mirror;
+  hdb->bmsiz = bmsiz;
+}
+
+
 /* Initialize the iterator of a hash database object.
    `hdb' specifies the hash database object.
    If successful, the return value is true, else, it is false. */
@@ -4422,7 +7158,7 @@ static char *tchdbiternextimpl(TCHDB *hdb, int *sp){
     rec.off = hdb->iter;
     if(!tchdbreadrec(hdb, &rec, rbuf)) return NULL;
     hdb->iter += rec.rsiz;
-    if(rec.magic == HDBMAGICREC){
+    if(rec.magic == HDBMAGICREC && !tchdbexpired(hdb, rec.xtime)){
       if(rec.kbuf){
         *sp = rec.ksiz;
         char *rv;
@@ -4449,7 +7185,7 @@ static bool tchdbiternextintoxstr(TCHDB *hdb, TCXSTR *kxstr, TCXSTR *vxstr){
     rec.off = hdb->iter;
     if(!tchdbreadrec(hdb, &rec, rbuf)) return false;
     hdb->iter += rec.rsiz;
-    if(rec.magic == HDBMAGICREC){
+    if(rec.magic == HDBMAGICREC && !tchdbexpired(hdb, rec.xtime)){
       if(!rec.vbuf && !tchdbreadrecbody(hdb, &rec)) return false;
       tcxstrclear(kxstr);
       TCXSTRCAT(kxstr, rec.kbuf, rec.ksiz);
@@ -4463,6 +7199,8 @@ static bool tchdbiternextintoxstr(TCHDB *hdb, TCXSTR *kxstr, TCXSTR *vxstr){
           zbuf = _tc_bzdecompress(rec.vbuf, rec.vsiz, &zsiz);
         } else if(hdb->opts & HDBTTCBS){
           zbuf = tcbsdecode(rec.vbuf, rec.vsiz, &zsiz);
+        } else if(hdb->opts & HDBTFAST){
+          zbuf = tclzdecode(rec.vbuf, rec.vsiz, &zsiz);
         } else {
           zbuf = hdb->dec(rec.vbuf, rec.vsiz, &zsiz, hdb->decop);
         }
@@ -4495,27 +7233,11 @@ static bool tchdbiternextintoxstr(TCHDB *hdb, TCXSTR *kxstr, TCXSTR *vxstr){
 static bool tchdboptimizeimpl(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts){
   assert(hdb);
   char *tpath = tcsprintf("%s%ctmp%c%llu", hdb->path, MYEXTCHR, MYEXTCHR, hdb->inode);
-  TCHDB *thdb = tchdbnew();
-  thdb->dbgfd = hdb->dbgfd;
-  thdb->enc = hdb->enc;
-  thdb->encop = hdb->encop;
-  thdb->dec = hdb->dec;
-  thdb->decop = hdb->decop;
-  if(bnum < 1){
-    bnum = hdb->rnum * 2 + 1;
-    if(bnum < HDBDEFBNUM) bnum = HDBDEFBNUM;
-  }
-  if(apow < 0) apow = hdb->apow;
-  if(fpow < 0) fpow = hdb->fpow;
-  if(opts == UINT8_MAX) opts = hdb->opts;
-  tchdbtune(thdb, bnum, apow, fpow, opts);
-  if(!tchdbopen(thdb, tpath, HDBOWRITER | HDBOCREAT | HDBOTRUNC)){
-    tchdbsetecode(hdb, thdb->ecode, __FILE__, __LINE__, __func__);
-    tchdbdel(thdb);
+  TCHDB *thdb = tchdboptopen(hdb, tpath, bnum, apow, fpow, opts, false);
+  if(!thdb){
     TCFREE(tpath);
     return false;
   }
-  memcpy(tchdbopaque(thdb), tchdbopaque(hdb), HDBHEADSIZ - HDBOPAQUEOFF);
   bool err = false;
   uint64_t off = hdb->frec;
   TCHREC rec;
@@ -4527,7 +7249,7 @@ static bool tchdboptimizeimpl(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow
       break;
     }
     off += rec.rsiz;
-    if(rec.magic == HDBMAGICREC){
+    if(rec.magic == HDBMAGICREC && !tchdbexpired(hdb, rec.xtime)){
       if(!rec.vbuf && !tchdbreadrecbody(hdb, &rec)){
         TCFREE(rec.bbuf);
         err = true;
@@ -4541,11 +7263,13 @@ static bool tchdboptimizeimpl(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow
             zbuf = _tc_bzdecompress(rec.vbuf, rec.vsiz, &zsiz);
           } else if(hdb->opts & HDBTTCBS){
             zbuf = tcbsdecode(rec.vbuf, rec.vsiz, &zsiz);
+          } else if(hdb->opts & HDBTFAST){
+            zbuf = tclzdecode(rec.vbuf, rec.vsiz, &zsiz);
           } else {
             zbuf = hdb->dec(rec.vbuf, rec.vsiz, &zsiz, hdb->decop);
           }
           if(zbuf){
-            if(!tchdbput(thdb, rec.kbuf, rec.ksiz, zbuf, zsiz)){
+            if(!tchdbputexpire(thdb, rec.kbuf, rec.ksiz, zbuf, zsiz, rec.xtime)){
               tchdbsetecode(hdb, thdb->ecode, __FILE__, __LINE__, __func__);
               err = true;
             }
@@ -4555,7 +7279,7 @@ static bool tchdboptimizeimpl(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow
             err = true;
           }
         } else {
-          if(!tchdbput(thdb, rec.kbuf, rec.ksiz, rec.vbuf, rec.vsiz)){
+          if(!tchdbputexpire(thdb, rec.kbuf, rec.ksiz, rec.vbuf, rec.vsiz, rec.xtime)){
             tchdbsetecode(hdb, thdb->ecode, __FILE__, __LINE__, __func__);
             err = true;
           }
@@ -4573,56 +7297,602 @@ static bool tchdboptimizeimpl(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow
     TCFREE(tpath);
     return false;
   }
-  if(unlink(hdb->path) == -1){
-    tchdbsetecode(hdb, TCEUNLINK, __FILE__, __LINE__, __func__);
-    err = true;
-  }
-  if(rename(tpath, hdb->path) == -1){
-    tchdbsetecode(hdb, TCERENAME, __FILE__, __LINE__, __func__);
-    err = true;
-  }
-  TCFREE(tpath);
-  if(err) return false;
-  tpath = tcstrdup(hdb->path);
-  int omode = (hdb->omode & ~HDBOCREAT) & ~HDBOTRUNC;
-  if(!tchdbcloseimpl(hdb)){
-    TCFREE(tpath);
-    return false;
-  }
-  bool rv = tchdbopenimpl(hdb, tpath, omode);
+  bool rv = tchdboptreplace(hdb, tpath);
   TCFREE(tpath);
   return rv;
 }
 
 
-/* Remove all records of a hash database object.
+/* Optimize the file of a hash database object by multiple threads.
    `hdb' specifies the hash database object.
-   If successful, the return value is true, else, it is false. */
-static bool tchdbvanishimpl(TCHDB *hdb){
+   `bnum' specifies the number of elements of the bucket array.
+   `apow' specifies the size of record alignment by power of 2.
+   `fpow' specifies the maximum number of elements of the free block pool by power of 2.
+   `opts' specifies options by bitwise-or.
+   `thnum' specifies the number of threads.
+   If successful, the return value is true, else, it is false.
+   Each worker copies the decoded records of its region into a run file and the progress is
+   saved into the checkpoint file.  When all runs are complete, the workers store the records of
+   the runs into the new database concurrently, and then the file is replaced. */
+static bool tchdboptimize2impl(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts,
+                               int thnum){
   assert(hdb);
-  char *path = tcstrdup(hdb->path);
-  int omode = hdb->omode;
+  char *tpath = tcsprintf("%s%ctmp%c%llu", hdb->path, MYEXTCHR, MYEXTCHR, hdb->inode);
+  HDBOPT opt;
+  opt.hdb = hdb;
+  opt.thdb = NULL;
+  opt.cpath = tcsprintf("%s%c%s", hdb->path, MYEXTCHR, HDBOPTSUFFIX);
+  opt.workers = NULL;
+  opt.wnum = 0;
+  opt.done = false;
+  if(pthread_mutex_init(&opt.mutex, NULL) != 0){
+    tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
+    TCFREE(opt.cpath);
+    TCFREE(tpath);
+    return false;
+  }
+  if(!tchdboptload(&opt, tpath)){
+    if(thnum < 1 || !TCUSEPTHREAD) thnum = 1;
+    if(thnum > HDBOPTMAXTH) thnum = HDBOPTMAXTH;
+    tchdboptsplit(&opt, tpath, thnum);
+  }
   bool err = false;
-  if(!tchdbcloseimpl(hdb)) err = true;
-  if(!tchdbopenimpl(hdb, path, HDBOTRUNC | omode)) err = true;
-  TCFREE(path);
+  if(!opt.done){
+    if(!tchdboptsave(&opt) || !tchdboptrun(&opt, tchdboptscan)) err = true;
+    if(!err){
+      opt.done = true;
+      if(!tchdboptsave(&opt)) err = true;
+    }
+  }
+  if(!err){
+    opt.thdb = tchdboptopen(hdb, tpath, bnum, apow, fpow, opts, opt.wnum > 1);
+    if(opt.thdb){
+      if(!tchdboptrun(&opt, tchdboptbuild)) err = true;
+      if(!tchdbclose(opt.thdb)){
+        tchdbsetecode(hdb, tchdbecode(opt.thdb), __FILE__, __LINE__, __func__);
+        err = true;
+      }
+      tchdbdel(opt.thdb);
+    } else {
+      err = true;
+    }
+  }
+  for(int i = 0; i < opt.wnum; i++){
+    if(!err) unlink(opt.workers[i].rpath);
+    TCFREE(opt.workers[i].rpath);
+  }
+  TCFREE(opt.workers);
+  if(!err) unlink(opt.cpath);
+  pthread_mutex_destroy(&opt.mutex);
+  TCFREE(opt.cpath);
+  if(!err && !tchdboptreplace(hdb, tpath)) err = true;
+  TCFREE(tpath);
   return !err;
 }
 
 
-/* Copy the database file of a hash database object.
+/* Open the destination database object of optimization.
    `hdb' specifies the hash database object.
-   `path' specifies the path of the destination file.
-   If successful, the return value is true, else, it is false. */
-static bool tchdbcopyimpl(TCHDB *hdb, const char *path){
-  assert(hdb && path);
-  bool err = false;
-  if(hdb->omode & HDBOWRITER){
-    if(!tchdbsavefbp(hdb)) err = true;
-    if(!tchdbmemsync(hdb, false)) err = true;
-    tchdbsetflag(hdb, HDBFOPEN, false);
+   `tpath' specifies the path of the destination file.
+   `bnum', `apow', `fpow', and `opts' specify the tuning parameters as with `tchdboptimize'.
+   `mt' specifies whether the destination object is shared by threads.
+   The return value is the destination database object or `NULL' on failure. */
+static TCHDB *tchdboptopen(TCHDB *hdb, const char *tpath, int64_t bnum, int8_t apow, int8_t fpow,
+                           uint8_t opts, bool mt){
+  assert(hdb && tpath);
+  TCHDB *thdb = tchdbnew();
+  if(mt) tchdbsetmutex(thdb);
+  thdb->dbgfd = hdb->dbgfd;
+  thdb->enc = hdb->enc;
+  thdb->encop = hdb->encop;
+  thdb->dec = hdb->dec;
+  thdb->decop = hdb->decop;
+  if(bnum < 1){
+    bnum = hdb->rnum * 2 + 1;
+    if(bnum < HDBDEFBNUM) bnum = HDBDEFBNUM;
   }
-  if(*path == '@'){
+  if(apow < 0) apow = hdb->apow;
+  if(fpow < 0) fpow = hdb->fpow;
+  if(opts == UINT8_MAX) opts = hdb->opts;
+  tchdbtune(thdb, bnum, apow, fpow, opts);
+  if(hdb->lhbase > 0) tchdbsetbmax(thdb, hdb->lhmax);
+  if(!tchdbopen(thdb, tpath, HDBOWRITER | HDBOCREAT | HDBOTRUNC)){
+    tchdbsetecode(hdb, tchdbecode(thdb), __FILE__, __LINE__, __func__);
+    tchdbdel(thdb);
+    return NULL;
+  }
+  memcpy(tchdbopaque(thdb), tchdbopaque(hdb), HDBHEADSIZ - HDBOPAQUEOFF);
+  return thdb;
+}
+
+
+/* Replace the database file of a hash database object with the optimized file.
+   `hdb' specifies the hash database object.
+   `tpath' specifies the path of the optimized file.
+   If successful, the return value is true, else, it is false. */
+static bool tchdboptreplace(TCHDB *hdb, const char *tpath){
+  assert(hdb && tpath);
+  bool err = false;
+  if(unlink(hdb->path) == -1){
+    tchdbsetecode(hdb, TCEUNLINK, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  if(rename(tpath, hdb->path) == -1){
+    tchdbsetecode(hdb, TCERENAME, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  if(err) return false;
+  char *path = tcstrdup(hdb->path);
+  int omode = (hdb->omode & ~HDBOCREAT) & ~HDBOTRUNC;
+  TCFREE(hdb->bloom);
+  hdb->bloom = NULL;
+  hdb->bfbnum = 0;
+  if(!tchdbcloseimpl(hdb)){
+    TCFREE(path);
+    return false;
+  }
+  bool rv = tchdbopenimpl(hdb, path, omode);
+  TCFREE(path);
+  return rv;
+}
+
+
+/* Split the region of the records of a hash database object at record boundaries.
+   `hdb' specifies the hash database object.
+   `bounds' specifies the array of `num' + 1 elements where the boundaries are stored.
+   `num' specifies the number of the ranges.
+   The boundaries of the ranges are the smallest offsets of records referred to by the bucket
+   array in the respective ranges, so that every range begins at a record. */
+static void tchdbsplitregion(TCHDB *hdb, uint64_t *bounds, int num){
+  assert(hdb && bounds && num > 0);
+  for(int i = 0; i <= num; i++){
+    bounds[i] = hdb->fsiz;
+  }
+  if(num > 1 && hdb->fsiz > hdb->frec){
+    uint64_t unit = (hdb->fsiz - hdb->frec) / num + 1;
+    for(uint64_t i = 0; i < hdb->bnum; i++){
+      uint64_t off = tchdbgetbucket(hdb, i);
+      if(off < hdb->frec || off >= hdb->fsiz) continue;
+      int idx = (off - hdb->frec) / unit;
+      if(off < bounds[idx]) bounds[idx] = off;
+    }
+  }
+  bounds[0] = hdb->frec;
+  for(int i = num - 1; i > 0; i--){
+    if(bounds[i] > bounds[i+1]) bounds[i] = bounds[i+1];
+  }
+}
+
+
+/* Split the file of a hash database object into the regions of the workers of optimization.
+   `opt' specifies the state of the optimization.
+   `tpath' specifies the path of the temporary file.
+   `wnum' specifies the number of the workers. */
+static void tchdboptsplit(HDBOPT *opt, const char *tpath, int wnum){
+  assert(opt && tpath && wnum > 0 && wnum <= HDBOPTMAXTH);
+  uint64_t bounds[HDBOPTMAXTH+1];
+  tchdbsplitregion(opt->hdb, bounds, wnum);
+  for(int i = 0; i < HDBOPTMAXTH; i++){
+    char *rpath = tcsprintf("%s%c%d", tpath, MYEXTCHR, i);
+    unlink(rpath);
+    TCFREE(rpath);
+  }
+  HDBOPTWORKER *workers;
+  TCMALLOC(workers, sizeof(*workers) * wnum);
+  for(int i = 0; i < wnum; i++){
+    HDBOPTWORKER *worker = workers + i;
+    worker->opt = opt;
+    worker->rpath = tcsprintf("%s%c%d", tpath, MYEXTCHR, i);
+    worker->begin = bounds[i];
+    worker->end = bounds[i+1];
+    worker->cur = worker->begin;
+    worker->rlen = 0;
+    worker->dcur = worker->begin;
+    worker->drlen = 0;
+    worker->ecode = TCESUCCESS;
+  }
+  opt->workers = workers;
+  opt->wnum = wnum;
+  opt->done = false;
+}
+
+
+/* Load the checkpoint file of optimization.
+   `opt' specifies the state of the optimization.
+   `tpath' specifies the path of the temporary file.
+   If successful, the return value is true, else, it is false.
+   The checkpoint is ignored unless it was saved for the current state of the database file and
+   every run file keeps the checkpointed size.  The generation number tells updates which keep
+   the size of the file and the number of records, such as overwriting a value in place. */
+static bool tchdboptload(HDBOPT *opt, const char *tpath){
+  assert(opt && tpath);
+  TCHDB *hdb = opt->hdb;
+  int size;
+  char *buf = tcreadfile(opt->cpath, 0, &size);
+  if(!buf) return false;
+  uint64_t llnum;
+  uint32_t lnum;
+  int wnum = 0;
+  bool ok = false;
+  if(size >= HDBOPTHEADSIZ && !memcmp(buf, HDBOPTMAGIC, strlen(HDBOPTMAGIC))){
+    memcpy(&llnum, buf + 16, sizeof(llnum));
+    uint64_t inode = TCITOHLL(llnum);
+    memcpy(&llnum, buf + 24, sizeof(llnum));
+    uint64_t fsiz = TCITOHLL(llnum);
+    memcpy(&llnum, buf + 32, sizeof(llnum));
+    uint64_t rnum = TCITOHLL(llnum);
+    memcpy(&lnum, buf + 40, sizeof(lnum));
+    wnum = TCITOHL(lnum);
+    memcpy(&llnum, buf + 48, sizeof(llnum));
+    uint64_t gen = TCITOHLL(llnum);
+    if(inode == hdb->inode && fsiz == hdb->fsiz && rnum == hdb->rnum && gen == hdb->gen &&
+       wnum > 0 && wnum <= HDBOPTMAXTH &&
+       size == HDBOPTHEADSIZ + wnum * sizeof(llnum) * 4) ok = true;
+  }
+  if(!ok){
+    TCFREE(buf);
+    return false;
+  }
+  memcpy(&lnum, buf + 44, sizeof(lnum));
+  bool done = TCITOHL(lnum) != 0;
+  HDBOPTWORKER *workers;
+  TCMALLOC(workers, sizeof(*workers) * wnum);
+  const char *rp = buf + HDBOPTHEADSIZ;
+  uint64_t bound = hdb->frec;
+  for(int i = 0; i < wnum; i++){
+    HDBOPTWORKER *worker = workers + i;
+    worker->opt = opt;
+    worker->rpath = tcsprintf("%s%c%d", tpath, MYEXTCHR, i);
+    memcpy(&llnum, rp, sizeof(llnum));
+    worker->begin = TCITOHLL(llnum);
+    rp += sizeof(llnum);
+    memcpy(&llnum, rp, sizeof(llnum));
+    worker->end = TCITOHLL(llnum);
+    rp += sizeof(llnum);
+    memcpy(&llnum, rp, sizeof(llnum));
+    worker->dcur = TCITOHLL(llnum);
+    rp += sizeof(llnum);
+    memcpy(&llnum, rp, sizeof(llnum));
+    worker->drlen = TCITOHLL(llnum);
+    rp += sizeof(llnum);
+    worker->cur = worker->dcur;
+    worker->rlen = worker->drlen;
+    worker->ecode = TCESUCCESS;
+    struct stat sbuf;
+    if(worker->begin != bound || worker->end < worker->begin || worker->dcur < worker->begin ||
+       worker->dcur > worker->end || (done && worker->dcur != worker->end) ||
+       (worker->drlen > 0 && (stat(worker->rpath, &sbuf) == -1 ||
+                              sbuf.st_size < worker->drlen))) ok = false;
+    bound = worker->end;
+  }
+  if(bound != hdb->fsiz) ok = false;
+  TCFREE(buf);
+  if(!ok){
+    for(int i = 0; i < wnum; i++){
+      TCFREE(workers[i].rpath);
+    }
+    TCFREE(workers);
+    return false;
+  }
+  opt->workers = workers;
+  opt->wnum = wnum;
+  opt->done = done;
+  return true;
+}
+
+
+/* Save the checkpoint file of optimization.
+   `opt' specifies the state of the optimization.
+   If successful, the return value is true, else, it is false.
+   The checkpoint is written into a temporary file which is renamed atomically. */
+static bool tchdboptsave(HDBOPT *opt){
+  assert(opt);
+  TCHDB *hdb = opt->hdb;
+  uint64_t llnum;
+  uint32_t lnum;
+  int size = HDBOPTHEADSIZ + opt->wnum * sizeof(llnum) * 4;
+  char *buf;
+  TCMALLOC(buf, size);
+  memset(buf, 0, HDBOPTHEADSIZ);
+  memcpy(buf, HDBOPTMAGIC, strlen(HDBOPTMAGIC));
+  llnum = TCHTOILL(hdb->inode);
+  memcpy(buf + 16, &llnum, sizeof(llnum));
+  llnum = TCHTOILL(hdb->fsiz);
+  memcpy(buf + 24, &llnum, sizeof(llnum));
+  llnum = TCHTOILL(hdb->rnum);
+  memcpy(buf + 32, &llnum, sizeof(llnum));
+  lnum = TCHTOIL(opt->wnum);
+  memcpy(buf + 40, &lnum, sizeof(lnum));
+  lnum = TCHTOIL(opt->done ? 1 : 0);
+  memcpy(buf + 44, &lnum, sizeof(lnum));
+  llnum = TCHTOILL(hdb->gen);
+  memcpy(buf + 48, &llnum, sizeof(llnum));
+  char *wp = buf + HDBOPTHEADSIZ;
+  for(int i = 0; i < opt->wnum; i++){
+    HDBOPTWORKER *worker = opt->workers + i;
+    llnum = TCHTOILL(worker->begin);
+    memcpy(wp, &llnum, sizeof(llnum));
+    wp += sizeof(llnum);
+    llnum = TCHTOILL(worker->end);
+    memcpy(wp, &llnum, sizeof(llnum));
+    wp += sizeof(llnum);
+    llnum = TCHTOILL(worker->dcur);
+    memcpy(wp, &llnum, sizeof(llnum));
+    wp += sizeof(llnum);
+    llnum = TCHTOILL(worker->drlen);
+    memcpy(wp, &llnum, sizeof(llnum));
+    wp += sizeof(llnum);
+  }
+  bool err = false;
+  char *spath = tcsprintf("%s%ctmp", opt->cpath, MYEXTCHR);
+  int fd = open(spath, O_WRONLY | O_CREAT | O_TRUNC, HDBFILEMODE);
+  if(fd != -1){
+    if(!tcwrite(fd, buf, size)){
+      tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+      err = true;
+    }
+    if(fsync(fd) == -1){
+      tchdbsetecode(hdb, TCESYNC, __FILE__, __LINE__, __func__);
+      err = true;
+    }
+    if(close(fd) == -1){
+      tchdbsetecode(hdb, TCECLOSE, __FILE__, __LINE__, __func__);
+      err = true;
+    }
+    if(!err && rename(spath, opt->cpath) == -1){
+      tchdbsetecode(hdb, TCERENAME, __FILE__, __LINE__, __func__);
+      err = true;
+    }
+  } else {
+    tchdbsetecode(hdb, TCEOPEN, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  TCFREE(spath);
+  TCFREE(buf);
+  return !err;
+}
+
+
+/* Run the workers of optimization.
+   `opt' specifies the state of the optimization.
+   `func' specifies the function of the workers.
+   If successful, the return value is true, else, it is false.
+   If a thread can not be created, the worker runs in the calling thread. */
+static bool tchdboptrun(HDBOPT *opt, void *(*func)(void *)){
+  assert(opt && func);
+  HDBOPTWORKER *workers = opt->workers;
+  int wnum = opt->wnum;
+  bool thds[HDBOPTMAXTH];
+  for(int i = 0; i < wnum; i++){
+    workers[i].ecode = TCESUCCESS;
+    thds[i] = false;
+    if(wnum > 1 && pthread_create(&workers[i].thid, NULL, func, workers + i) == 0){
+      thds[i] = true;
+    } else {
+      func(workers + i);
+    }
+  }
+  bool err = false;
+  for(int i = 0; i < wnum; i++){
+    if(thds[i] && pthread_join(workers[i].thid, NULL) != 0){
+      tchdbsetecode(opt->hdb, TCETHREAD, __FILE__, __LINE__, __func__);
+      err = true;
+    }
+    if(workers[i].ecode != TCESUCCESS){
+      tchdbsetecode(opt->hdb, workers[i].ecode, __FILE__, __LINE__, __func__);
+      err = true;
+    }
+  }
+  return !err;
+}
+
+
+/* Copy the records of the region of a worker of optimization into the run file.
+   `arg' specifies the worker.
+   The return value is `NULL'.
+   Each record is appended as the sizes of the key and the decoded value in variable length
+   format and their regions, and the progress is checkpointed after every some units. */
+static void *tchdboptscan(void *arg){
+  assert(arg);
+  HDBOPTWORKER *worker = arg;
+  HDBOPT *opt = worker->opt;
+  TCHDB *hdb = opt->hdb;
+  int fd = open(worker->rpath, O_WRONLY | O_CREAT, HDBFILEMODE);
+  if(fd == -1){
+    worker->ecode = TCEOPEN;
+    return NULL;
+  }
+  bool err = false;
+  if(ftruncate(fd, worker->drlen) == -1 || lseek(fd, worker->drlen, SEEK_SET) == -1){
+    tchdbsetecode(hdb, TCETRUNC, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  worker->cur = worker->dcur;
+  worker->rlen = worker->drlen;
+  TCXSTR *xstr = tcxstrnew3(HDBOPTUNIT + HDBIOBUFSIZ);
+  int unum = 0;
+  TCHREC rec;
+  char rbuf[HDBIOBUFSIZ];
+  while(!err && worker->cur < worker->end){
+    rec.off = worker->cur;
+    if(!tchdbreadrec(hdb, &rec, rbuf)){
+      err = true;
+      break;
+    }
+    worker->cur += rec.rsiz;
+    if(rec.magic == HDBMAGICREC && !tchdbexpired(hdb, rec.xtime)){
+      if(!rec.vbuf && !tchdbreadrecbody(hdb, &rec)){
+        TCFREE(rec.bbuf);
+        err = true;
+        break;
+      }
+      const char *vbuf = rec.vbuf;
+      int vsiz = rec.vsiz;
+      char *zbuf = NULL;
+      if(hdb->zmode){
+        if(hdb->opts & HDBTDEFLATE){
+          zbuf = _tc_inflate(rec.vbuf, rec.vsiz, &vsiz, _TCZMRAW);
+        } else if(hdb->opts & HDBTBZIP){
+          zbuf = _tc_bzdecompress(rec.vbuf, rec.vsiz, &vsiz);
+        } else if(hdb->opts & HDBTTCBS){
+          zbuf = tcbsdecode(rec.vbuf, rec.vsiz, &vsiz);
+        } else if(hdb->opts & HDBTFAST){
+          zbuf = tclzdecode(rec.vbuf, rec.vsiz, &vsiz);
+        } else {
+          zbuf = hdb->dec(rec.vbuf, rec.vsiz, &vsiz, hdb->decop);
+        }
+        if(!zbuf){
+          tchdbsetecode(hdb, TCEMISC, __FILE__, __LINE__, __func__);
+          TCFREE(rec.bbuf);
+          err = true;
+          break;
+        }
+        vbuf = zbuf;
+      }
+      char nbuf[sizeof(uint64_t)*3];
+      int nsiz, step;
+      TCSETVNUMBUF(step, nbuf, rec.ksiz);
+      nsiz = step;
+      TCSETVNUMBUF(step, nbuf + nsiz, vsiz);
+      nsiz += step;
+      if(hdb->opts & HDBTTTL){
+        uint32_t lnum = TCHTOIL(rec.xtime);
+        memcpy(nbuf + nsiz, &lnum, sizeof(lnum));
+        nsiz += sizeof(lnum);
+      }
+      TCXSTRCAT(xstr, nbuf, nsiz);
+      TCXSTRCAT(xstr, rec.kbuf, rec.ksiz);
+      TCXSTRCAT(xstr, vbuf, vsiz);
+      TCFREE(zbuf);
+      TCFREE(rec.bbuf);
+    }
+    if(TCXSTRSIZE(xstr) >= HDBOPTUNIT || worker->cur >= worker->end){
+      if(!tcwrite(fd, TCXSTRPTR(xstr), TCXSTRSIZE(xstr))){
+        tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+        err = true;
+        break;
+      }
+      worker->rlen += TCXSTRSIZE(xstr);
+      tcxstrclear(xstr);
+      if(++unum >= HDBOPTCKFREQ || worker->cur >= worker->end){
+        unum = 0;
+        if(fsync(fd) == -1){
+          tchdbsetecode(hdb, TCESYNC, __FILE__, __LINE__, __func__);
+          err = true;
+          break;
+        }
+        if(pthread_mutex_lock(&opt->mutex) != 0){
+          tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
+          err = true;
+          break;
+        }
+        worker->dcur = worker->cur;
+        worker->drlen = worker->rlen;
+        if(!tchdboptsave(opt)) err = true;
+        pthread_mutex_unlock(&opt->mutex);
+      }
+    }
+  }
+  tcxstrdel(xstr);
+  if(close(fd) == -1 && !err){
+    tchdbsetecode(hdb, TCECLOSE, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  if(err){
+    int ecode = tchdbecode(hdb);
+    worker->ecode = (ecode != TCESUCCESS) ? ecode : TCEMISC;
+  }
+  return NULL;
+}
+
+
+/* Store the records of the run file of a worker of optimization into the new database.
+   `arg' specifies the worker.
+   The return value is `NULL'. */
+static void *tchdboptbuild(void *arg){
+  assert(arg);
+  HDBOPTWORKER *worker = arg;
+  TCHDB *thdb = ((HDBOPT *)worker->opt)->thdb;
+  bool ttl = ((HDBOPT *)worker->opt)->hdb->opts & HDBTTTL;
+  if(worker->drlen < 1) return NULL;
+  int fd = open(worker->rpath, O_RDONLY, HDBFILEMODE);
+  if(fd == -1){
+    worker->ecode = TCEOPEN;
+    return NULL;
+  }
+  void *map = mmap(0, worker->drlen, PROT_READ, MAP_SHARED, fd, 0);
+  if(map == MAP_FAILED){
+    close(fd);
+    worker->ecode = TCEMMAP;
+    return NULL;
+  }
+  const char *rp = map;
+  const char *ep = rp + worker->drlen;
+  while(rp < ep){
+    int ksiz, vsiz, step;
+    TCREADVNUMBUF(rp, ksiz, step);
+    rp += step;
+    if(rp >= ep){
+      worker->ecode = TCEMISC;
+      break;
+    }
+    TCREADVNUMBUF(rp, vsiz, step);
+    rp += step;
+    uint32_t xtime = 0;
+    if(ttl){
+      if(ep - rp < (int)sizeof(xtime)){
+        worker->ecode = TCEMISC;
+        break;
+      }
+      memcpy(&xtime, rp, sizeof(xtime));
+      xtime = TCITOHL(xtime);
+      rp += sizeof(xtime);
+    }
+    if(ksiz < 0 || vsiz < 0 || ksiz > ep - rp || vsiz > ep - rp - ksiz){
+      worker->ecode = TCEMISC;
+      break;
+    }
+    if(!tchdbputexpire(thdb, rp, ksiz, rp + ksiz, vsiz, xtime)){
+      worker->ecode = tchdbecode(thdb);
+      if(worker->ecode == TCESUCCESS) worker->ecode = TCEMISC;
+      break;
+    }
+    rp += ksiz + vsiz;
+  }
+  if(munmap(map, worker->drlen) == -1 && worker->ecode == TCESUCCESS) worker->ecode = TCEMMAP;
+  if(close(fd) == -1 && worker->ecode == TCESUCCESS) worker->ecode = TCECLOSE;
+  return NULL;
+}
+
+
+/* Remove all records of a hash database object.
+   `hdb' specifies the hash database object.
+   If successful, the return value is true, else, it is false. */
+static bool tchdbvanishimpl(TCHDB *hdb){
+  assert(hdb);
+  char *path = tcstrdup(hdb->path);
+  int omode = hdb->omode;
+  bool err = false;
+  if(!tchdbcloseimpl(hdb)) err = true;
+  if(!tchdbopenimpl(hdb, path, HDBOTRUNC | omode)) err = true;
+  TCFREE(path);
+  return !err;
+}
+
+
+/* Copy the database file of a hash database object.
+   `hdb' specifies the hash database object.
+   `path' specifies the path of the destination file.
+   If successful, the return value is true, else, it is false. */
+static bool tchdbcopyimpl(TCHDB *hdb, const char *path){
+  assert(hdb && path);
+  bool err = false;
+  if(hdb->omode & HDBOWRITER){
+    if(!tchdbsavefbp(hdb)) err = true;
+    if(!tchdbmemsync(hdb, false)) err = true;
+    tchdbsetflag(hdb, HDBFOPEN, false);
+  }
+  if(*path == '@'){
     char tsbuf[TCNUMBUFSIZ];
     sprintf(tsbuf, "%llu", (unsigned long long)(tctime() * 1000000));
     const char *args[3];
@@ -4640,6 +7910,175 @@ static bool tchdbcopyimpl(TCHDB *hdb, const char *path){
   return !err;
 }
 
+/* Create a consistent snapshot of the database file of a hash database object online.
+   `hdb' specifies the hash database object connected as a writer.
+   `path' specifies the path of the destination file.
+   If successful, the return value is true, else, it is false.
+   The caller should hold the method lock as a reader and every record lock as a writer, and the
+   latter is released as soon as the state of the snapshot is set up.  Then the file is copied
+   by chunks while the pre-images of overwritten regions are appended to the log, which is
+   finally applied to the destination in the reverse order so that the oldest pre-image of each
+   region wins. */
+static bool tchdbsnapshotimpl(TCHDB *hdb, const char *path){
+  assert(hdb && path);
+  bool err = false;
+  if(!tchdbsavefbp(hdb)) err = true;
+  if(!tchdbmemsync(hdb, false)) err = true;
+  char hbuf[HDBHEADSIZ];
+  memcpy(hbuf, hdb->map, HDBHEADSIZ);
+  hbuf[HDBFLAGSOFF] &= ~HDBFOPEN;
+  int dfd = open(path, O_WRONLY | O_CREAT | O_TRUNC, HDBFILEMODE);
+  if(dfd == -1){
+    tchdbsetecode(hdb, TCEOPEN, __FILE__, __LINE__, __func__);
+    HDBUNLOCKALLRECORDS(hdb);
+    return false;
+  }
+  char *lpath = tcsprintf("%s%c%s", path, MYEXTCHR, HDBSNAPSUFFIX);
+  int lfd = open(lpath, O_RDWR | O_CREAT | O_TRUNC, HDBFILEMODE);
+  if(lfd == -1){
+    tchdbsetecode(hdb, TCEOPEN, __FILE__, __LINE__, __func__);
+    TCFREE(lpath);
+    close(dfd);
+    HDBUNLOCKALLRECORDS(hdb);
+    return false;
+  }
+  unlink(lpath);
+  TCFREE(lpath);
+  HDBSNAP snap;
+  snap.fd = lfd;
+  snap.end = hdb->fsiz;
+  snap.lsiz = 0;
+  hdb->snap = &snap;
+  HDBUNLOCKALLRECORDS(hdb);
+  char *buf;
+  TCMALLOC(buf, HDBSNAPUNIT);
+  for(uint64_t off = 0; !err && off < snap.end; off += HDBSNAPUNIT){
+    int size = tclmin(snap.end - off, HDBSNAPUNIT);
+    int rsiz = pread(hdb->fd, buf, size, off);
+    if(rsiz == -1){
+      tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
+      err = true;
+      break;
+    }
+    if(rsiz < size) memset(buf + rsiz, 0, size - rsiz);
+    if(lseek(dfd, off, SEEK_SET) == -1 || !tcwrite(dfd, buf, size)){
+      tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+      err = true;
+    }
+  }
+  if(HDBLOCKWAL(hdb)){
+    hdb->snap = NULL;
+    HDBUNLOCKWAL(hdb);
+  } else {
+    hdb->snap = NULL;
+    err = true;
+  }
+  if(!err && snap.lsiz > 0){
+    TCXSTR *offs = tcxstrnew3(HDBIOBUFSIZ);
+    uint64_t loff = 0;
+    while(loff < snap.lsiz){
+      char head[sizeof(uint64_t)+sizeof(uint32_t)];
+      if(pread(lfd, head, sizeof(head), loff) != sizeof(head)){
+        tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
+        err = true;
+        break;
+      }
+      TCXSTRCAT(offs, &loff, sizeof(loff));
+      uint32_t size;
+      memcpy(&size, head + sizeof(uint64_t), sizeof(size));
+      loff += sizeof(head) + size;
+    }
+    const uint64_t *lp = (uint64_t *)TCXSTRPTR(offs);
+    for(int i = TCXSTRSIZE(offs) / sizeof(*lp) - 1; !err && i >= 0; i--){
+      char head[sizeof(uint64_t)+sizeof(uint32_t)];
+      uint64_t off;
+      uint32_t size;
+      if(pread(lfd, head, sizeof(head), lp[i]) != sizeof(head)){
+        tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
+        err = true;
+        break;
+      }
+      memcpy(&off, head, sizeof(off));
+      memcpy(&size, head + sizeof(off), sizeof(size));
+      while(size > 0){
+        int rsiz = tclmin(size, HDBSNAPUNIT);
+        if(pread(lfd, buf, rsiz, lp[i] + sizeof(head)) != rsiz){
+          tchdbsetecode(hdb, TCEREAD, __FILE__, __LINE__, __func__);
+          err = true;
+          break;
+        }
+        if(lseek(dfd, off, SEEK_SET) == -1 || !tcwrite(dfd, buf, rsiz)){
+          tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+          err = true;
+          break;
+        }
+        off += rsiz;
+        size -= rsiz;
+      }
+    }
+    tcxstrdel(offs);
+  }
+  TCFREE(buf);
+  if(!err && (lseek(dfd, 0, SEEK_SET) == -1 || !tcwrite(dfd, hbuf, HDBHEADSIZ))){
+    tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  if(!err && ftruncate(dfd, snap.end) == -1){
+    tchdbsetecode(hdb, TCETRUNC, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  if(!err && fsync(dfd) == -1){
+    tchdbsetecode(hdb, TCESYNC, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  if(close(dfd) == -1){
+    tchdbsetecode(hdb, TCECLOSE, __FILE__, __LINE__, __func__);
+    err = true;
+  }
+  close(lfd);
+  return !err;
+}
+
+
+/* Log the pre-image of a region to be overwritten while a snapshot is running.
+   `hdb' specifies the hash database object.
+   `off' specifies the offset of the region.
+   `size' specifies the size of the region.
+   If successful, the return value is true, else, it is false. */
+static bool tchdbsnaplog(TCHDB *hdb, uint64_t off, int64_t size){
+  assert(hdb && off >= 0 && size >= 0);
+  if(!HDBLOCKWAL(hdb)) return false;
+  HDBSNAP *snap = hdb->snap;
+  if(!snap || off >= snap->end){
+    HDBUNLOCKWAL(hdb);
+    return true;
+  }
+  if(off + size > snap->end) size = snap->end - off;
+  char stack[HDBIOBUFSIZ];
+  char *buf;
+  int hsiz = sizeof(uint64_t) + sizeof(uint32_t);
+  if(size + hsiz <= HDBIOBUFSIZ){
+    buf = stack;
+  } else {
+    TCMALLOC(buf, size + hsiz);
+  }
+  uint32_t lnum = size;
+  memcpy(buf, &off, sizeof(off));
+  memcpy(buf + sizeof(off), &lnum, sizeof(lnum));
+  bool err = false;
+  if(!tchdbseekread(hdb, off, buf + hsiz, size)){
+    err = true;
+  } else if(pwrite(snap->fd, buf, size + hsiz, snap->lsiz) != size + hsiz){
+    tchdbsetecode(hdb, TCEWRITE, __FILE__, __LINE__, __func__);
+    err = true;
+  } else {
+    snap->lsiz += size + hsiz;
+  }
+  if(buf != stack) TCFREE(buf);
+  HDBUNLOCKWAL(hdb);
+  return !err;
+}
+
 
 /* Perform dynamic defragmentation of a hash database object.
    `hdb' specifies the hash database object connected.
@@ -4648,6 +8087,7 @@ static bool tchdbcopyimpl(TCHDB *hdb, const char *path){
 static bool tchdbdefragimpl(TCHDB *hdb, int64_t step){
   assert(hdb && step >= 0);
   TCDODEBUG(hdb->cnt_defrag++);
+  if(!tchdbfbpready(hdb)) return false;
   hdb->dfcnt = 0;
   TCHREC rec;
   char rbuf[HDBIOBUFSIZ];
@@ -4660,6 +8100,10 @@ static bool tchdbdefragimpl(TCHDB *hdb, int64_t step){
     rec.off = hdb->dfcur;
     if(!tchdbreadrec(hdb, &rec, rbuf)) return false;
     if(rec.magic == HDBMAGICFB) break;
+    if(rec.magic == HDBMAGICREC && tchdbexpired(hdb, rec.xtime)){
+      if(!tchdbexpirerec(hdb, &rec)) return false;
+      break;
+    }
     hdb->dfcur += rec.rsiz;
   }
   uint32_t align = hdb->align;
@@ -4674,7 +8118,11 @@ static bool tchdbdefragimpl(TCHDB *hdb, int64_t step){
     rec.off = cur;
     if(!tchdbreadrec(hdb, &rec, rbuf)) return false;
     uint32_t rsiz = rec.rsiz;
-    if(rec.magic == HDBMAGICREC){
+    if(rec.magic == HDBMAGICREC && tchdbexpired(hdb, rec.xtime)){
+      if(!tchdbexpirerec(hdb, &rec)) return false;
+      if(hdb->iter == cur) hdb->iter += rsiz;
+      fbsiz += rsiz;
+    } else if(rec.magic == HDBMAGICREC){
       if(rec.psiz >= align){
         int diff = rec.psiz - rec.psiz % align;
         rec.psiz -= diff;
@@ -4712,6 +8160,7 @@ static bool tchdbdefragimpl(TCHDB *hdb, int64_t step){
   } else {
     TCDODEBUG(hdb->cnt_trunc++);
     if(hdb->tran && !tchdbwalwrite(hdb, dest, fbsiz)) return false;
+    if(hdb->snap && !tchdbsnaplog(hdb, dest, fbsiz)) return false;
     tchdbfbptrim(hdb, base, cur, 0, 0);
     hdb->dfcur = hdb->frec;
     hdb->fsiz = dest;
@@ -4731,6 +8180,268 @@ static bool tchdbdefragimpl(TCHDB *hdb, int64_t step){
 }
 
 
+/* Start the worker of background defragmentation of a hash database object.
+   `hdb' specifies the hash database object.
+   If successful, the return value is true, else, it is false.
+   Nothing is done unless the object is for threading, the auto defragmentation is enabled, and
+   the database is opened as a writer. */
+static bool tchdbdfstart(TCHDB *hdb){
+  assert(hdb);
+  if(!hdb->mmtx || hdb->dfwmsec < 1 || hdb->dfunit < 1 || !(hdb->omode & HDBOWRITER))
+    return true;
+  HDBDFWORKER *worker;
+  TCMALLOC(worker, sizeof(*worker));
+  worker->stop = false;
+  bool err = false;
+  if(pthread_mutex_init(&worker->mutex, NULL) != 0){
+    err = true;
+  } else if(pthread_cond_init(&worker->cond, NULL) != 0){
+    pthread_mutex_destroy(&worker->mutex);
+    err = true;
+  }
+  if(err){
+    TCFREE(worker);
+    tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  hdb->dfworker = worker;
+  if(pthread_create(&worker->thid, NULL, tchdbdfworker, hdb) != 0){
+    hdb->dfworker = NULL;
+    pthread_cond_destroy(&worker->cond);
+    pthread_mutex_destroy(&worker->mutex);
+    TCFREE(worker);
+    tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  return true;
+}
+
+
+/* Stop the worker of background defragmentation of a hash database object.
+   `hdb' specifies the hash database object. */
+static void tchdbdfstop(TCHDB *hdb){
+  assert(hdb);
+  HDBDFWORKER *worker = hdb->dfworker;
+  if(!worker) return;
+  pthread_mutex_lock(&worker->mutex);
+  worker->stop = true;
+  pthread_cond_signal(&worker->cond);
+  pthread_mutex_unlock(&worker->mutex);
+  pthread_join(worker->thid, NULL);
+  hdb->dfworker = NULL;
+  pthread_cond_destroy(&worker->cond);
+  pthread_mutex_destroy(&worker->mutex);
+  TCFREE(worker);
+}
+
+
+/* Run the worker of background defragmentation.
+   `arg' specifies the hash database object.
+   The return value is always `NULL'.
+   The counter of auto defragmentation is checked at every interval, so the worker never runs
+   more often than that however fast records are updated. */
+static void *tchdbdfworker(void *arg){
+  assert(arg);
+  TCHDB *hdb = arg;
+  HDBDFWORKER *worker = hdb->dfworker;
+  while(true){
+    pthread_mutex_lock(&worker->mutex);
+    if(!worker->stop){
+      double etime = tctime() + hdb->dfwmsec / 1000.0;
+      struct timespec ts;
+      ts.tv_sec = etime;
+      ts.tv_nsec = (etime - ts.tv_sec) * 1000000000.0;
+      pthread_cond_timedwait(&worker->cond, &worker->mutex, &ts);
+    }
+    bool stop = worker->stop;
+    pthread_mutex_unlock(&worker->mutex);
+    if(stop) break;
+    if(hdb->dfcnt > hdb->dfunit) tchdbdfround(hdb);
+  }
+  return NULL;
+}
+
+
+/* Perform a round of background defragmentation of a hash database object.
+   `hdb' specifies the hash database object.
+   If successful, the return value is true, else, it is false.
+   Steps are repeated until the cursor goes around the file or the time budget of the round runs
+   out.  The record locks are released and the thread yields between steps so that foreground
+   operations are not kept waiting. */
+static bool tchdbdfround(TCHDB *hdb){
+  assert(hdb);
+  if(!HDBLOCKMETHOD(hdb, false)) return false;
+  if(hdb->fd < 0 || !(hdb->omode & HDBOWRITER)){
+    HDBUNLOCKMETHOD(hdb);
+    return true;
+  }
+  if(hdb->async && !tchdbflushdrp(hdb)){
+    HDBUNLOCKMETHOD(hdb);
+    return false;
+  }
+  double budget = hdb->dfwmsec / 1000.0 / HDBDFWDUTY;
+  double stime = tctime();
+  double etime = stime;
+  bool err = false;
+  bool stop = false;
+  while(!err && !stop && etime - stime < budget){
+    if(HDBLOCKALLRECORDS(hdb, true)){
+      double ltime = tctime();
+      uint64_t cur = hdb->dfcur;
+      if(!tchdbdefragimpl(hdb, hdb->dfwstep)) err = true;
+      if(hdb->dfcur <= cur) stop = true;
+      HDBUNLOCKALLRECORDS(hdb);
+      etime = tctime();
+      hdb->dfwsnum++;
+      hdb->dfwusec += (etime - ltime) * 1000000;
+      HDBTHREADYIELD(hdb);
+    } else {
+      err = true;
+    }
+  }
+  hdb->dfwrnum++;
+  HDBUNLOCKMETHOD(hdb);
+  return !err;
+}
+
+
+/* Grow the bucket array of a hash database object incrementally.
+   `hdb' specifies the hash database object.
+   `step' specifies the number of buckets to be split.
+   If successful, the return value is true, else, it is false. */
+static bool tchdbgrowimpl(TCHDB *hdb, int64_t step){
+  assert(hdb);
+  if(hdb->lhbase < 1) return true;
+  uint64_t bnum = hdb->bnum;
+  bool err = false;
+  while(hdb->bnum < hdb->lhmax){
+    if(step > 0){
+      if(step-- < 1) break;
+    } else if(hdb->rnum <= hdb->bnum * HDBLHLOAD){
+      break;
+    }
+    if(!tchdbsplitbucket(hdb)){
+      err = true;
+      break;
+    }
+  }
+  if(hdb->bnum != bnum){
+    uint64_t llnum = hdb->bnum;
+    llnum = TCHTOILL(llnum);
+    memcpy(hdb->map + HDBBNUMOFF, &llnum, sizeof(llnum));
+  }
+  return !err;
+}
+
+
+/* Split the bucket at the split pointer of linear hashing.
+   `hdb' specifies the hash database object.
+   If successful, the return value is true, else, it is false.
+   The records of the bucket are collected, distributed between the bucket and the new one at
+   the end of the bucket array, and linked into fresh collision trees in place. */
+static bool tchdbsplitbucket(TCHDB *hdb){
+  assert(hdb && hdb->lhbase > 0);
+  uint64_t sidx = hdb->bnum - hdb->lhspan;
+  uint64_t didx = hdb->bnum;
+  int anum = 8;
+  int rnum = 0;
+  HDBLHREC *recs;
+  TCMALLOC(recs, sizeof(*recs) * anum);
+  uint64_t off = tchdbgetbucket(hdb, sidx);
+  if(off > 0){
+    recs[rnum++].off = off;
+  }
+  TCHREC rec;
+  char rbuf[HDBIOBUFSIZ];
+  bool err = false;
+  for(int i = 0; i < rnum; i++){
+    rec.off = recs[i].off;
+    if(!tchdbreadrec(hdb, &rec, rbuf)){
+      err = true;
+      rnum = i;
+      break;
+    }
+    if(rec.magic != HDBMAGICREC || (!rec.kbuf && !tchdbreadrecbody(hdb, &rec))){
+      if(rec.magic != HDBMAGICREC) tchdbsetecode(hdb, TCERHEAD, __FILE__, __LINE__, __func__);
+      err = true;
+      rnum = i;
+      break;
+    }
+    TCMEMDUP(recs[i].kbuf, rec.kbuf, rec.ksiz);
+    recs[i].ksiz = rec.ksiz;
+    recs[i].hash = rec.hash;
+    TCFREE(rec.bbuf);
+    if(rnum + 2 > anum){
+      anum *= 2;
+      TCREALLOC(recs, recs, sizeof(*recs) * anum);
+    }
+    if(rec.left > 0) recs[rnum++].off = rec.left;
+    if(rec.right > 0) recs[rnum++].off = rec.right;
+  }
+  if(!err){
+    hdb->bnum++;
+    if(hdb->bnum >= hdb->lhspan * 2) hdb->lhspan *= 2;
+    int roots[2] = { -1, -1 };
+    for(int i = 0; i < rnum; i++){
+      HDBLHREC *lrec = recs + i;
+      lrec->left = -1;
+      lrec->right = -1;
+      uint8_t hash;
+      uint64_t bidx = tchdblhaddr(hdb, tchdbhashidx(hdb, lrec->kbuf, lrec->ksiz, &hash));
+      if(bidx != sidx && bidx != didx){
+        tchdbsetecode(hdb, TCEMETA, __FILE__, __LINE__, __func__);
+        err = true;
+        break;
+      }
+      int *entp = roots + (bidx == didx);
+      while(*entp >= 0){
+        HDBLHREC *prec = recs + *entp;
+        if(lrec->hash > prec->hash){
+          entp = &prec->left;
+        } else if(lrec->hash < prec->hash){
+          entp = &prec->right;
+        } else if(tcreckeycmp(lrec->kbuf, lrec->ksiz, prec->kbuf, prec->ksiz) > 0){
+          entp = &prec->left;
+        } else {
+          entp = &prec->right;
+        }
+      }
+      *entp = i;
+    }
+    for(int i = 0; !err && i < rnum; i++){
+      HDBLHREC *lrec = recs + i;
+      uint64_t left = (lrec->left >= 0) ? recs[lrec->left].off >> hdb->apow : 0;
+      uint64_t right = (lrec->right >= 0) ? recs[lrec->right].off >> hdb->apow : 0;
+      char ebuf[sizeof(uint64_t)*2];
+      int esiz;
+      if(hdb->ba64){
+        uint64_t llnum = TCHTOILL(left);
+        memcpy(ebuf, &llnum, sizeof(llnum));
+        llnum = TCHTOILL(right);
+        memcpy(ebuf + sizeof(llnum), &llnum, sizeof(llnum));
+        esiz = sizeof(llnum) * 2;
+      } else {
+        uint32_t lnum = TCHTOIL((uint32_t)left);
+        memcpy(ebuf, &lnum, sizeof(lnum));
+        lnum = TCHTOIL((uint32_t)right);
+        memcpy(ebuf + sizeof(lnum), &lnum, sizeof(lnum));
+        esiz = sizeof(lnum) * 2;
+      }
+      if(!tchdbseekwrite(hdb, lrec->off + sizeof(uint8_t) * 2, ebuf, esiz)) err = true;
+    }
+    if(!err){
+      tchdbsetbucket(hdb, sidx, (roots[0] >= 0) ? recs[roots[0]].off : 0);
+      tchdbsetbucket(hdb, didx, (roots[1] >= 0) ? recs[roots[1]].off : 0);
+    }
+  }
+  for(int i = 0; i < rnum; i++){
+    TCFREE(recs[i].kbuf);
+  }
+  TCFREE(recs);
+  return !err;
+}
+
+
 /* Move the iterator to the record corresponding a key of a hash database object.
    `hdb' specifies the hash database object.
    `kbuf' specifies the pointer to the region of the key.
@@ -4764,6 +8475,8 @@ static bool tchdbiterjumpimpl(TCHDB *hdb, const char *kbuf, int ksiz){
         rec.kbuf = NULL;
         rec.bbuf = NULL;
       } else {
+        TCFREE(rec.bbuf);
+        if(tchdbexpired(hdb, rec.xtime)) break;
         hdb->iter = off;
         return true;
       }
@@ -4774,26 +8487,62 @@ static bool tchdbiterjumpimpl(TCHDB *hdb, const char *kbuf, int ksiz){
 }
 
 
-/* Process each record atomically of a hash database object.
+/* Process each record atomically in a range of a hash database object.
    `hdb' specifies the hash database object.
+   `begin' specifies the offset of the first record of the range.
+   `end' specifies the offset of the end of the range.
    `func' specifies the pointer to the iterator function called for each record.
    `op' specifies an arbitrary pointer to be given as a parameter of the iterator function.
    If successful, the return value is true, else, it is false. */
-static bool tchdbforeachimpl(TCHDB *hdb, TCITER iter, void *op){
-  assert(hdb && iter);
+static bool tchdbforeachimpl(TCHDB *hdb, uint64_t begin, uint64_t end, TCITER iter, void *op){
+  assert(hdb && begin >= hdb->frec && end <= hdb->fsiz && iter);
   bool err = false;
-  uint64_t off = hdb->frec;
+  uint64_t off = begin;
   TCHREC rec;
   char rbuf[HDBIOBUFSIZ];
+  HDBRING *ring = hdb->ring;
+  if(ring && pthread_mutex_trylock(&ring->mutex) != 0) ring = NULL;
+  uint64_t woff = 0;
+  int64_t wsiz = 0;
   bool cont = true;
-  while(cont && off < hdb->fsiz){
+  while(cont && off < end){
     rec.off = off;
-    if(!tchdbreadrec(hdb, &rec, rbuf)){
+    if(ring && off + hdb->runit > hdb->xmsiz && off + hdb->runit <= hdb->fsiz){
+      if(off < woff || off + hdb->runit > woff + wsiz){
+        int num = 0;
+        for(uint64_t roff = off; num < ring->depth && roff < end; roff += HDBIOBUFSIZ){
+          HDBIOREQ *req = ring->reqs + num;
+          req->off = roff;
+          req->buf = ring->bufs + num * HDBIOBUFSIZ;
+          req->size = tclmin(HDBIOBUFSIZ, hdb->fsiz - roff);
+          num++;
+        }
+        if(!tchdbringio(hdb, ring->reqs, num, false)){
+          err = true;
+          break;
+        }
+        woff = off;
+        wsiz = 0;
+        for(int i = 0; i < num; i++){
+          wsiz += ring->reqs[i].done;
+          if(ring->reqs[i].done < ring->reqs[i].size) break;
+        }
+      }
+      if(off + hdb->runit <= woff + wsiz){
+        if(!tchdbparserec(hdb, &rec, ring->bufs + (off - woff), woff + wsiz - off)){
+          err = true;
+          break;
+        }
+      } else if(!tchdbreadrec(hdb, &rec, rbuf)){
+        err = true;
+        break;
+      }
+    } else if(!tchdbreadrec(hdb, &rec, rbuf)){
       err = true;
       break;
     }
     off += rec.rsiz;
-    if(rec.magic == HDBMAGICREC){
+    if(rec.magic == HDBMAGICREC && !tchdbexpired(hdb, rec.xtime)){
       if(!rec.vbuf && !tchdbreadrecbody(hdb, &rec)){
         TCFREE(rec.bbuf);
         err = true;
@@ -4807,6 +8556,8 @@ static bool tchdbforeachimpl(TCHDB *hdb, TCITER iter, void *op){
             zbuf = _tc_bzdecompress(rec.vbuf, rec.vsiz, &zsiz);
           } else if(hdb->opts & HDBTTCBS){
             zbuf = tcbsdecode(rec.vbuf, rec.vsiz, &zsiz);
+          } else if(hdb->opts & HDBTFAST){
+            zbuf = tclzdecode(rec.vbuf, rec.vsiz, &zsiz);
           } else {
             zbuf = hdb->dec(rec.vbuf, rec.vsiz, &zsiz, hdb->decop);
           }
@@ -4824,10 +8575,99 @@ static bool tchdbforeachimpl(TCHDB *hdb, TCITER iter, void *op){
       TCFREE(rec.bbuf);
     }
   }
+  if(ring) pthread_mutex_unlock(&ring->mutex);
   return !err;
 }
 
 
+/* Process each record of a hash database object with multiple threads.
+   `hdb' specifies the hash database object.
+   `iter' specifies the pointer to the iterator function called for each record.
+   `op' specifies an arbitrary pointer to be given as a parameter of the iterator function.
+   `thnum' specifies the number of threads.
+   If successful, the return value is true, else, it is false.
+   The caller should hold the locks of all records, so that the boundaries of the ranges stay at
+   records while the workers scan them. */
+static bool tchdbforeachmt(TCHDB *hdb, TCITER iter, void *op, int thnum){
+  assert(hdb && iter);
+  if(thnum < 2 || !TCUSEPTHREAD) return tchdbforeachimpl(hdb, hdb->frec, hdb->fsiz, iter, op);
+  uint64_t *bounds;
+  TCMALLOC(bounds, sizeof(*bounds) * (thnum + 1));
+  tchdbsplitregion(hdb, bounds, thnum);
+  volatile bool stop = false;
+  HDBFEWORKER *workers;
+  TCMALLOC(workers, sizeof(*workers) * thnum);
+  bool *thds;
+  TCMALLOC(thds, sizeof(*thds) * thnum);
+  for(int i = 0; i < thnum; i++){
+    HDBFEWORKER *worker = workers + i;
+    worker->hdb = hdb;
+    worker->begin = bounds[i];
+    worker->end = bounds[i+1];
+    worker->iter = iter;
+    worker->op = op;
+    worker->stop = &stop;
+    worker->ecode = TCESUCCESS;
+    thds[i] = false;
+    if(worker->begin >= worker->end) continue;
+    if(pthread_create(&worker->thid, NULL, tchdbforeachworker, worker) == 0){
+      thds[i] = true;
+    } else {
+      tchdbforeachworker(worker);
+    }
+  }
+  bool err = false;
+  for(int i = 0; i < thnum; i++){
+    if(thds[i] && pthread_join(workers[i].thid, NULL) != 0){
+      tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
+      err = true;
+    }
+    if(workers[i].ecode != TCESUCCESS){
+      tchdbsetecode(hdb, workers[i].ecode, __FILE__, __LINE__, __func__);
+      err = true;
+    }
+  }
+  TCFREE(thds);
+  TCFREE(workers);
+  TCFREE(bounds);
+  return !err;
+}
+
+
+/* Call the iterator function of parallel iteration for a record.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `vbuf' specifies the pointer to the region of the value.
+   `vsiz' specifies the size of the region of the value.
+   `op' specifies the pointer to the worker.
+   The return value is true to continue iteration or false to stop iteration. */
+static bool tchdbforeachiter(const void *kbuf, int ksiz, const void *vbuf, int vsiz, void *op){
+  assert(kbuf && ksiz >= 0 && vbuf && vsiz >= 0 && op);
+  HDBFEWORKER *worker = op;
+  if(*worker->stop) return false;
+  if(!worker->iter(kbuf, ksiz, vbuf, vsiz, worker->op)){
+    *worker->stop = true;
+    return false;
+  }
+  return true;
+}
+
+
+/* Process the records of the range of a worker of parallel iteration.
+   `arg' specifies the worker.
+   The return value is `NULL'. */
+static void *tchdbforeachworker(void *arg){
+  assert(arg);
+  HDBFEWORKER *worker = arg;
+  TCHDB *hdb = worker->hdb;
+  if(!tchdbforeachimpl(hdb, worker->begin, worker->end, tchdbforeachiter, worker)){
+    int ecode = tchdbecode(hdb);
+    worker->ecode = (ecode != TCESUCCESS) ? ecode : TCEMISC;
+  }
+  return NULL;
+}
+
+
 /* Lock a method of the hash database object.
    `hdb' specifies the hash database object.
    `wr' specifies whether the lock is writer or not.
@@ -4838,6 +8678,17 @@ static bool tchdblockmethod(TCHDB *hdb, bool wr){
     tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
     return false;
   }
+  if(wr){
+    hdb->mseq++;
+    __sync_synchronize();
+    HDBRLOCK *rmtxs = hdb->rmtxs;
+    int snum = tclmin(hdb->rmtxnum, HDBOPTRDSLOT);
+    for(int i = 0; i < snum; i++){
+      while(rmtxs[i].b.rdnum > 0){
+        sched_yield();
+      }
+    }
+  }
   TCTESTYIELD();
   return true;
 }
@@ -4848,6 +8699,10 @@ static bool tchdblockmethod(TCHDB *hdb, bool wr){
    If successful, the return value is true, else, it is false. */
 static bool tchdbunlockmethod(TCHDB *hdb){
   assert(hdb);
+  if(hdb->mseq & 1){
+    __sync_synchronize();
+    hdb->mseq++;
+  }
   if(pthread_rwlock_unlock(hdb->mmtx) != 0){
     tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
     return false;
@@ -4862,13 +8717,18 @@ static bool tchdbunlockmethod(TCHDB *hdb){
    `bidx' specifies the bucket index of the record.
    `wr' specifies whether the lock is writer or not.
    If successful, the return value is true, else, it is false. */
-static bool tchdblockrecord(TCHDB *hdb, uint8_t bidx, bool wr){
+static bool tchdblockrecord(TCHDB *hdb, uint64_t bidx, bool wr){
   assert(hdb);
-  if(wr ? pthread_rwlock_wrlock((pthread_rwlock_t *)hdb->rmtxs + bidx) != 0 :
-     pthread_rwlock_rdlock((pthread_rwlock_t *)hdb->rmtxs + bidx) != 0){
+  HDBRLOCKBODY *rlock = &((HDBRLOCK *)hdb->rmtxs)[bidx&(hdb->rmtxnum-1)].b;
+  if(wr ? pthread_rwlock_wrlock(&rlock->rwlock) != 0 :
+     pthread_rwlock_rdlock(&rlock->rwlock) != 0){
     tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
     return false;
   }
+  if(wr){
+    rlock->seq++;
+    __sync_synchronize();
+  }
   TCTESTYIELD();
   return true;
 }
@@ -4878,9 +8738,14 @@ static bool tchdblockrecord(TCHDB *hdb, uint8_t bidx, bool wr){
    `hdb' specifies the hash database object.
    `bidx' specifies the bucket index of the record.
    If successful, the return value is true, else, it is false. */
-static bool tchdbunlockrecord(TCHDB *hdb, uint8_t bidx){
+static bool tchdbunlockrecord(TCHDB *hdb, uint64_t bidx){
   assert(hdb);
-  if(pthread_rwlock_unlock((pthread_rwlock_t *)hdb->rmtxs + bidx) != 0){
+  HDBRLOCKBODY *rlock = &((HDBRLOCK *)hdb->rmtxs)[bidx&(hdb->rmtxnum-1)].b;
+  if(rlock->seq & 1){
+    __sync_synchronize();
+    rlock->seq++;
+  }
+  if(pthread_rwlock_unlock(&rlock->rwlock) != 0){
     tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
     return false;
   }
@@ -4895,16 +8760,20 @@ static bool tchdbunlockrecord(TCHDB *hdb, uint8_t bidx){
    If successful, the return value is true, else, it is false. */
 static bool tchdblockallrecords(TCHDB *hdb, bool wr){
   assert(hdb);
-  for(int i = 0; i <= UINT8_MAX; i++){
-    if(wr ? pthread_rwlock_wrlock((pthread_rwlock_t *)hdb->rmtxs + i) != 0 :
-       pthread_rwlock_rdlock((pthread_rwlock_t *)hdb->rmtxs + i) != 0){
+  HDBRLOCK *rmtxs = hdb->rmtxs;
+  for(int i = 0; i < hdb->rmtxnum; i++){
+    if(wr ? pthread_rwlock_wrlock(&rmtxs[i].b.rwlock) != 0 :
+       pthread_rwlock_rdlock(&rmtxs[i].b.rwlock) != 0){
       tchdbsetecode(hdb, TCETHREAD, __FILE__, __LINE__, __func__);
       while(--i >= 0){
-        pthread_rwlock_unlock((pthread_rwlock_t *)hdb->rmtxs + i);
+        if(wr) rmtxs[i].b.seq++;
+        pthread_rwlock_unlock(&rmtxs[i].b.rwlock);
       }
       return false;
     }
+    if(wr) rmtxs[i].b.seq++;
   }
+  if(wr) __sync_synchronize();
   TCTESTYIELD();
   return true;
 }
@@ -4916,8 +8785,11 @@ static bool tchdblockallrecords(TCHDB *hdb, bool wr){
 static bool tchdbunlockallrecords(TCHDB *hdb){
   assert(hdb);
   bool err = false;
-  for(int i = UINT8_MAX; i >= 0; i--){
-    if(pthread_rwlock_unlock((pthread_rwlock_t *)hdb->rmtxs + i)) err = true;
+  HDBRLOCK *rmtxs = hdb->rmtxs;
+  __sync_synchronize();
+  for(int i = hdb->rmtxnum - 1; i >= 0; i--){
+    if(rmtxs[i].b.seq & 1) rmtxs[i].b.seq++;
+    if(pthread_rwlock_unlock(&rmtxs[i].b.rwlock)) err = true;
   }
   TCTESTYIELD();
   if(err){
@@ -39,14 +39,20 @@ __TCHDB_CLINKAGEBEGIN
 typedef struct {                         /* type of structure for a hash database */
   void *mmtx;                            /* mutex for method */
   void *rmtxs;                           /* mutexes for records */
+  uint32_t rmtxnum;                      /* number of the mutexes for records */
+  volatile uint32_t mseq;                /* sequence number of exclusive methods */
   void *dmtx;                            /* mutex for the while database */
   void *tmtx;                            /* mutex for transaction */
   void *wmtx;                            /* mutex for write ahead logging */
+  void *wcnd;                            /* condition variable for write ahead logging */
   void *eckey;                           /* key for thread specific error code */
   char *rpath;                           /* real path for locking */
   uint8_t type;                          /* database type */
   uint8_t flags;                         /* additional flags */
   uint64_t bnum;                         /* number of the bucket array */
+  uint64_t lhbase;                       /* base number of the bucket array of linear hashing */
+  uint64_t lhmax;                        /* maximum number of the bucket array */
+  uint64_t lhspan;                       /* number of the buckets of the current round */
   uint8_t apow;                          /* power of record alignment */
   uint8_t fpow;                          /* power of free block pool number */
   uint8_t opts;                          /* options */
@@ -62,6 +68,8 @@ typedef struct {                         /* type of structure for a hash databas
   uint64_t msiz;                         /* size of the mapped memory */
   uint64_t xmsiz;                        /* size of the extra mapped memory */
   uint64_t xfsiz;                        /* extra size of the file for mapped memory */
+  uint64_t xmmax;                        /* maximum size of the growable mapped memory */
+  uint64_t xmlen;                        /* size of the reserved mapped region */
   uint32_t *ba32;                        /* 32-bit bucket array */
   uint64_t *ba64;                        /* 64-bit bucket array */
   uint32_t align;                        /* record alignment */
@@ -71,25 +79,49 @@ typedef struct {                         /* type of structure for a hash databas
   void *fbpool;                          /* free block pool */
   int32_t fbpnum;                        /* number of the free block pool */
   int32_t fbpmis;                        /* number of missing retrieval of the free block pool */
+  bool fbplazy;                          /* whether loading of the free block pool is deferred */
   bool async;                            /* whether asynchronous storing is called */
   TCXSTR *drpool;                        /* delayed record pool */
   TCXSTR *drpdef;                        /* deferred records of the delayed record pool */
   uint64_t drpoff;                       /* offset of the delayed record pool */
-  TCMDB *recc;                           /* cache for records */
+  void *recc;                            /* cache for records */
   uint32_t rcnum;                        /* maximum number of cached records */
   TCCODEC enc;                           /* pointer to the encoding function */
   void *encop;                           /* opaque object for the encoding functions */
   TCCODEC dec;                           /* pointer to the decoding function */
   void *decop;                           /* opaque object for the decoding functions */
+  void (*rcvproc)(uint64_t, uint64_t, void *);  /* pointer to the progress function of recovery */
+  void *rcvop;                           /* opaque object for the progress function */
   int ecode;                             /* last happened error code */
   bool fatal;                            /* whether a fatal error occured */
   uint64_t inode;                        /* inode number */
   time_t mtime;                          /* modification time */
+  uint64_t gen;                          /* generation number of updates */
+  bool genup;                            /* whether the generation was advanced by the connection */
   uint32_t dfunit;                       /* unit step number of auto defragmentation */
   uint32_t dfcnt;                        /* counter of auto defragmentation */
+  int64_t bfnum;                         /* expected number of records of the Bloom filter */
+  uint64_t *bloom;                       /* blocks of the Bloom filter */
+  uint64_t bfbnum;                       /* number of the blocks of the Bloom filter */
+  int32_t dfwstep;                       /* step number of background defragmentation */
+  int32_t dfwmsec;                       /* interval of background defragmentation */
+  void *dfworker;                        /* worker of background defragmentation */
+  uint64_t dfwrnum;                      /* number of rounds of background defragmentation */
+  uint64_t dfwsnum;                      /* number of steps of background defragmentation */
+  uint64_t dfwusec;                      /* microseconds spent by background defragmentation */
   bool tran;                             /* whether in the transaction */
   int walfd;                             /* file descriptor of write ahead logging */
   uint64_t walend;                       /* end offset of write ahead logging */
+  TCXSTR *walque;                        /* queue of events of write ahead logging */
+  uint64_t walqnum;                      /* number of the queued events */
+  uint64_t walsnum;                      /* number of the synchronized events */
+  bool walsync;                          /* whether a leader is synchronizing */
+  void *snap;                            /* state of the running snapshot */
+  int32_t iodepth;                       /* depth of the ring of asynchronous I/O */
+  void *ring;                            /* ring of asynchronous I/O */
+  uint8_t mopts;                         /* memory options */
+  void *bamirror;                        /* mirror of the bucket array */
+  uint64_t bmsiz;                        /* size of the mirror of the bucket array */
   int dbgfd;                             /* file descriptor for debugging */
   int64_t cnt_writerec;                  /* tesing counter for record write times */
   int64_t cnt_reuserec;                  /* tesing counter for record reuse times */
@@ -120,7 +152,16 @@ enum {                                   /* enumeration for tuning options */
   HDBTDEFLATE = 1 << 1,                  /* compress each record with Deflate */
   HDBTBZIP = 1 << 2,                     /* compress each record with BZIP2 */
   HDBTTCBS = 1 << 3,                     /* compress each record with TCBS */
-  HDBTEXCODEC = 1 << 4                   /* compress each record with custom functions */
+  HDBTEXCODEC = 1 << 4,                  /* compress each record with custom functions */
+  HDBTXHASH = 1 << 5,                    /* use the word-at-a-time hash function */
+  HDBTFAST = 1 << 6,                     /* compress each record with LZ */
+  HDBTTTL = 1 << 7                       /* give each record an expiration time */
+};
+
+enum {                                   /* enumeration for memory options */
+  HDBMHUGE = 1 << 0,                     /* back the bucket array with huge pages */
+  HDBMMIRROR = 1 << 1,                   /* mirror the bucket array of a reader */
+  HDBMINTERLEAVE = 1 << 2                /* interleave memory over NUMA nodes */
 };
 
 enum {                                   /* enumeration for open modes */
@@ -187,9 +228,21 @@ bool tchdbsetmutex(TCHDB *hdb);
    `opts' specifies options by bitwise-or: `HDBTLARGE' specifies that the size of the database
    can be larger than 2GB by using 64-bit bucket array, `HDBTDEFLATE' specifies that each record
    is compressed with Deflate encoding, `HDBTBZIP' specifies that each record is compressed with
-   BZIP2 encoding, `HDBTTCBS' specifies that each record is compressed with TCBS encoding.
+   BZIP2 encoding, `HDBTTCBS' specifies that each record is compressed with TCBS encoding,
+   `HDBTFAST' specifies that each record is compressed with LZ encoding, which is much faster
+   than the others at the cost of the ratio, `HDBTXHASH' specifies that the bucket index is
+   calculated with the word-at-a-time hash function, which is faster for long keys and spreads
+   records more evenly, `HDBTTTL' specifies that each record has an expiration time, which is
+   set by `tchdbputttl'.
    If successful, the return value is true, else, it is false.
-   Note that the tuning parameters should be set before the database is opened. */
+   Note that the tuning parameters should be set before the database is opened.  The hash
+   function is recorded in the database file, so that files created without `HDBTXHASH' keep
+   the legacy one.  Files created with `HDBTFAST', `HDBTXHASH', or `HDBTTTL' are marked so that
+   older versions of the library refuse to open them, and the mark is removed only by optimizing
+   the file without the options.  As `HDBTTTL' takes the last bit of the options, the value with
+   every bit set coincides with `UINT8_MAX', which means the current setting for the optimizing
+   functions.  It is never a valid combination, because the compression options are exclusive
+   of each other. */
 bool tchdbtune(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts);
 
 
@@ -198,7 +251,9 @@ bool tchdbtune(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts)
    `rcnum' specifies the maximum number of records to be cached.  If it is not more than 0, the
    record cache is disabled.  It is disabled by default.
    If successful, the return value is true, else, it is false.
-   Note that the caching parameters should be set before the database is opened. */
+   Note that the caching parameters should be set before the database is opened.  A key read
+   only once is not admitted while the cache is full, so that a scan does not flush the records
+   read repeatedly. */
 bool tchdbsetcache(TCHDB *hdb, int32_t rcnum);
 
 
@@ -211,6 +266,17 @@ bool tchdbsetcache(TCHDB *hdb, int32_t rcnum);
 bool tchdbsetxmsiz(TCHDB *hdb, int64_t xmsiz);
 
 
+/* Set the maximum size of the growable mapped memory of a hash database object.
+   `hdb' specifies the hash database object which is not opened.
+   `xmmax' specifies the maximum size of the mapped memory.  If it is more than the size of the
+   extra mapped memory, a region of this size is reserved when the database is opened as a
+   writer and the mapped window grows with the file up to it, and a reader maps the whole file up
+   to it.  If it is not more than 0, the window is fixed.  It is fixed by default.
+   If successful, the return value is true, else, it is false.
+   Note that the mapping parameters should be set before the database is opened. */
+bool tchdbsetxmmax(TCHDB *hdb, int64_t xmmax);
+
+
 /* Set the unit step number of auto defragmentation of a hash database object.
    `hdb' specifies the hash database object which is not opened.
    `dfunit' specifie the unit step number.  If it is not more than 0, the auto defragmentation
@@ -220,6 +286,77 @@ bool tchdbsetxmsiz(TCHDB *hdb, int64_t xmsiz);
 bool tchdbsetdfunit(TCHDB *hdb, int32_t dfunit);
 
 
+/* Set the maximum number of elements of the bucket array of a hash database object.
+   `hdb' specifies the hash database object which is not opened.
+   `bmax' specifies the maximum number of elements of the bucket array.  If it is more than the
+   number specified by `tchdbtune', the region of the bucket array is reserved for it when a new
+   database file is created and the bucket array grows by linear hashing as records are stored.
+   If it is not more than 0, the bucket array is fixed.  It is fixed by default.
+   If successful, the return value is true, else, it is false.
+   Note that the setting is recorded in a new database file and is ignored when an existing one
+   is opened.  A file whose bucket array can grow is marked so that older versions of the
+   library, which would look up records in wrong buckets, refuse to open it.  The upgrade is
+   one-way, as optimization keeps the growable bucket array. */
+bool tchdbsetbmax(TCHDB *hdb, int64_t bmax);
+
+
+/* Set the Bloom filter of a hash database object.
+   `hdb' specifies the hash database object which is not opened.
+   `bfnum' specifies the expected number of records.  If it is not more than 0, the Bloom filter
+   is disabled.  It is disabled by default.
+   If successful, the return value is true, else, it is false.
+   The filter is kept on memory and answers lookups of missing keys without reading the bucket
+   tree.  It is saved into a sidecar file with the suffix ".bf" when a writer closes the
+   database, and loaded when the database is opened again.  If the sidecar is missing or does
+   not match the database file, including its generation of updates, the filter is rebuilt by
+   scanning all records.  Removed records
+   are not dropped from the filter until it is rebuilt by optimization.
+   Note that the filter is not used when the database is opened without file locking. */
+bool tchdbsetbloom(TCHDB *hdb, int64_t bfnum);
+
+
+/* Set the background defragmentation of a hash database object.
+   `hdb' specifies the hash database object which is not opened.
+   `step' specifies the number of records moved while the records are locked at once.  If it is
+   not more than 0, the default value is specified.  The default value is 32.
+   `msec' specifies the interval of rounds in milliseconds.  If it is not more than 0, the
+   background defragmentation is disabled.  It is disabled by default.
+   If successful, the return value is true, else, it is false.
+   If the background defragmentation is enabled and the object is set for threading by
+   `tchdbsetmutex' and opened as a writer with the unit step number set by `tchdbsetdfunit', the
+   auto defragmentation is performed by a worker thread instead of the thread storing records.
+   Each round runs no longer than a tenth of the interval and releases the locks between steps.
+   Note that the defragmentation parameters should be set before the database is opened. */
+bool tchdbsetdfthread(TCHDB *hdb, int32_t step, int32_t msec);
+
+
+/* Set the asynchronous I/O ring of a hash database object.
+   `hdb' specifies the hash database object which is not opened.
+   `depth' specifies the number of requests kept in flight at once.  If it is not more than 0,
+   the ring is disabled.  It is disabled by default.
+   If successful, the return value is true, else, it is false.
+   The ring is used for the region of the file out of the mapped memory.  Multiple retrieval
+   reads the first records of the buckets of all keys in batches, iteration by `tchdbforeach'
+   reads ahead by a window of the same depth, and the delayed record pool is written in units in
+   flight at once.  If the platform does not support io_uring or the kernel refuses it, the
+   setting is ignored and the usual system calls are used. */
+bool tchdbsetiodepth(TCHDB *hdb, int32_t depth);
+
+
+/* Set the memory options of a hash database object.
+   `hdb' specifies the hash database object which is not opened.
+   `mopts' specifies memory options by bitwise-or: `HDBMHUGE' advises the kernel to back the
+   region of the bucket array with transparent huge pages, `HDBMMIRROR' copies the bucket array
+   of a reader into an anonymous region backed by huge pages, and `HDBMINTERLEAVE' interleaves
+   the pages of the mirror and the index of the record cache over the online NUMA nodes.  No
+   option is set by default.
+   If successful, the return value is true, else, it is false.
+   The mirror is used only by a reader and does not reflect updates by other processes.  Pages
+   of the mapped file are placed by the kernel regardless of the interleaving.  Options not
+   supported by the platform are ignored. */
+bool tchdbsetmemopts(TCHDB *hdb, uint8_t mopts);
+
+
 /* Open a database file and connect a hash database object.
    `hdb' specifies the hash database object which is not opened.
    `path' specifies the path of the database file.
@@ -230,7 +367,10 @@ bool tchdbsetdfunit(TCHDB *hdb, int32_t dfunit);
    updated contents with the device.  Both of `HDBOREADER' and `HDBOWRITER' can be added to by
    bitwise-or: `HDBONOLCK', which means it opens the database file without file locking, or
    `HDBOLCKNB', which means locking is performed without blocking.
-   If successful, the return value is true, else, it is false. */
+   If successful, the return value is true, else, it is false.
+   If `HDBOTSYNC' is specified for an object with mutual exclusion control, threads updating
+   records in a transaction concurrently share one write and one synchronization of the write
+   ahead logging file. */
 bool tchdbopen(TCHDB *hdb, const char *path, int omode);
 
 
@@ -262,6 +402,24 @@ bool tchdbput(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int vsiz
 bool tchdbput2(TCHDB *hdb, const char *kstr, const char *vstr);
 
 
+/* Store a record with an expiration time into a hash database object.
+   `hdb' specifies the hash database object connected as a writer.  It should be tuned with the
+   option `HDBTTTL'.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   `vbuf' specifies the pointer to the region of the value.
+   `vsiz' specifies the size of the region of the value.
+   `ttl' specifies the lifetime of the record in seconds.  If it is not more than 0, the record
+   does not expire.
+   If successful, the return value is true, else, it is false.
+   If a record with the same key exists in the database, it is overwritten.  An expired record is
+   treated as if it does not exist by every function, and its region is reclaimed when the record
+   is overwritten or removed, or by defragmentation.  Records stored by the other functions do
+   not expire, and updating functions except for overwriting keep the expiration time.  Expired
+   records are counted by `tchdbrnum' until they are reclaimed. */
+bool tchdbputttl(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int vsiz, int64_t ttl);
+
+
 /* Store a new record into a hash database object.
    `hdb' specifies the hash database object connected as a writer.
    `kbuf' specifies the pointer to the region of the key.
@@ -324,6 +482,16 @@ bool tchdbputasync(TCHDB *hdb, const void *kbuf, int ksiz, const void *vbuf, int
 bool tchdbputasync2(TCHDB *hdb, const char *kstr, const char *vstr);
 
 
+/* Store multiple records into a hash database object at once.
+   `hdb' specifies the hash database object connected as a writer.
+   `recs' specifies a list object containing keys and values alternately.
+   If successful, the return value is true, else, it is false.
+   If a record with the same key exists in the database, it is overwritten.  The file is
+   extended once for the whole batch and the new records are written at the tail by large
+   sequential writes, so this is much faster than `tchdbput' for bulk loading. */
+bool tchdbputbatch(TCHDB *hdb, const TCLIST *recs);
+
+
 /* Remove a record of a hash database object.
    `hdb' specifies the hash database object connected as a writer.
    `kbuf' specifies the pointer to the region of the key.
@@ -378,6 +546,18 @@ char *tchdbget2(TCHDB *hdb, const char *kstr);
 int tchdbget3(TCHDB *hdb, const void *kbuf, int ksiz, void *vbuf, int max);
 
 
+/* Retrieve multiple records in a hash database object at once.
+   `hdb' specifies the hash database object.
+   `keys' specifies a list object of the keys.
+   `recs' specifies a map object into which the keys and the values of the corresponding records
+   are stored.  Keys with no corresponding record are ignored.
+   If successful, the return value is true, else, it is false.
+   The records are read in ascending order of their offsets in the database file while the
+   method is locked only once, and read-ahead is requested for records outside the mapped
+   region. */
+bool tchdbgetmulti(TCHDB *hdb, const TCLIST *keys, TCMAP *recs);
+
+
 /* Get the size of the value of a record in a hash database object.
    `hdb' specifies the hash database object.
    `kbuf' specifies the pointer to the region of the key.
@@ -508,14 +688,38 @@ bool tchdbsync(TCHDB *hdb);
    `opts' specifies options by bitwise-or: `HDBTLARGE' specifies that the size of the database
    can be larger than 2GB by using 64-bit bucket array, `HDBTDEFLATE' specifies that each record
    is compressed with Deflate encoding, `HDBTBZIP' specifies that each record is compressed with
-   BZIP2 encoding, `HDBTTCBS' specifies that each record is compressed with TCBS encoding.  If it
-   is `UINT8_MAX', the current setting is not changed.
+   BZIP2 encoding, `HDBTTCBS' specifies that each record is compressed with TCBS encoding,
+   `HDBTFAST' specifies that each record is compressed with LZ encoding, `HDBTXHASH' specifies
+   that the word-at-a-time hash function is used, `HDBTTTL' specifies that each record has an
+   expiration time.  If it is `UINT8_MAX', the current setting is not changed.  No valid
+   combination of the options is `UINT8_MAX'.
    If successful, the return value is true, else, it is false.
    This function is useful to reduce the size of the database file with data fragmentation by
-   successive updating. */
+   successive updating.  It can also convert an existing database to the other hash function.
+   Expired records are not copied. */
 bool tchdboptimize(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts);
 
 
+/* Optimize the file of a hash database object by multiple threads.
+   `hdb' specifies the hash database object connected as a writer.
+   `bnum' specifies the number of elements of the bucket array.
+   `apow' specifies the size of record alignment by power of 2.
+   `fpow' specifies the maximum number of elements of the free block pool by power of 2.
+   `opts' specifies options by bitwise-or.
+   `thnum' specifies the number of threads.  If it is not more than 0, one thread is used.
+   If successful, the return value is true, else, it is false.
+   The parameters are the same as `tchdboptimize'.  The file is split into regions at the
+   offsets of records, and each thread copies the records of its region into a run file with the
+   suffix of the temporary file and the index of the thread.  Then the threads store the records
+   of the runs into the new database file.  The progress of copying is saved into a checkpoint
+   file with the suffix ".opt" periodically, and if the function fails or the process is killed,
+   calling this function again for the same database file resumes copying from the checkpoint.
+   The checkpoint is discarded if the file has been updated since it was saved.  Note that the
+   codec functions of the object should be thread-safe. */
+bool tchdboptimize2(TCHDB *hdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts,
+                    int thnum);
+
+
 /* Remove all records of a hash database object.
    `hdb' specifies the hash database object connected as a writer.
    If successful, the return value is true, else, it is false. */
@@ -534,6 +738,19 @@ bool tchdbvanish(TCHDB *hdb);
 bool tchdbcopy(TCHDB *hdb, const char *path);
 
 
+/* Create a consistent snapshot of the database file of a hash database object online.
+   `hdb' specifies the hash database object.
+   `path' specifies the path of the destination file.
+   If successful, the return value is true, else, it is false.
+   Unlike `tchdbcopy', other threads can keep storing and removing records while the file is
+   copied.  The pre-images of the regions they overwrite are logged and applied to the copy at
+   the end, so that the destination reflects the database at the time this function was called.
+   Methods which need the whole database exclusively, including the asynchronous storing and the
+   transaction, wait until the copying finishes.  If a transaction or another snapshot is
+   running, this function waits until it finishes. */
+bool tchdbsnapshot(TCHDB *hdb, const char *path);
+
+
 /* Begin the transaction of a hash database object.
    `hdb' specifies the hash database object connected as a writer.
    If successful, the return value is true, else, it is false.
@@ -620,6 +837,19 @@ int tchdbdbgfd(TCHDB *hdb);
 bool tchdbhasmutex(TCHDB *hdb);
 
 
+/* Set mutual exclusion control of a hash database object with the number of record locks.
+   `hdb' specifies the hash database object which is not opened.
+   `rlnum' specifies the number of locks for records.  It is rounded up to a power of 2 and
+   limited to 65536.  If it is not more than 0, the default value 256 is specified.
+   If successful, the return value is true, else, it is false.
+   Each lock is padded to a cache line so that neighboring locks do not share one.  More locks
+   reduce contention among threads updating different records at the cost of memory and of
+   operations locking all records.  While mutual exclusion control is set, `tchdbget' and
+   `tchdbget3' read records inside the mapped region without taking locks and retry with locks
+   only when a writer of the same lock intervenes. */
+bool tchdbsetmutex2(TCHDB *hdb, int32_t rlnum);
+
+
 /* Synchronize updating contents on memory of a hash database object.
    `hdb' specifies the hash database object connected as a writer.
    `phys' specifies whether to synchronize physically.
@@ -731,6 +961,23 @@ uint64_t tchdbbnumused(TCHDB *hdb);
 bool tchdbsetcodecfunc(TCHDB *hdb, TCCODEC enc, void *encop, TCCODEC dec, void *decop);
 
 
+/* Set the progress function of recovery of a hash database object.
+   `hdb' specifies the hash database object which is not opened.
+   `proc' specifies the pointer to the function called while the database file is restored from
+   the write ahead logging file.  It receives three parameters.  The first parameter is the size
+   of the processed part of the log.  The second parameter is the size of the whole log.  The
+   third parameter is the pointer to the optional opaque object.  If it is `NULL', the progress
+   is not reported.
+   `op' specifies an arbitrary pointer to be given as a parameter of the progress function.  If
+   it is not needed, `NULL' can be specified.
+   If successful, the return value is true, else, it is false.
+   Recovery is performed when a database whose transaction was interrupted is opened.  The log is
+   mapped and the pre-images are applied from the newest one without loading the whole log into
+   memory.  The function is called every time a unit of the log is processed and once when the
+   recovery is completed. */
+bool tchdbsetrcvfunc(TCHDB *hdb, void (*proc)(uint64_t done, uint64_t total, void *op), void *op);
+
+
 /* Get the custom codec functions of a hash database object.
    `hdb' specifies the hash database object.
    `ep' specifies the pointer to a variable into which the pointer to the custom encoding
@@ -750,6 +997,16 @@ void tchdbcodecfunc(TCHDB *hdb, TCCODEC *ep, void **eop, TCCODEC *dp, void **dop
 uint32_t tchdbdfunit(TCHDB *hdb);
 
 
+/* Get the statistics of the background defragmentation of a hash database object.
+   `hdb' specifies the hash database object.
+   `rnp' specifies the pointer to the variable into which the number of rounds is assigned.
+   `snp' specifies the pointer to the variable into which the number of steps is assigned.
+   `usp' specifies the pointer to the variable into which the time spent holding the record
+   locks in microseconds is assigned.
+   The return value is the offset of the cursor of defragmentation. */
+uint64_t tchdbdfstat(TCHDB *hdb, uint64_t *rnp, uint64_t *snp, uint64_t *usp);
+
+
 /* Perform dynamic defragmentation of a hash database object.
    `hdb' specifies the hash database object connected as a writer.
    `step' specifie the number of steps.  If it is not more than 0, the whole file is defragmented
@@ -758,6 +1015,29 @@ uint32_t tchdbdfunit(TCHDB *hdb);
 bool tchdbdefrag(TCHDB *hdb, int64_t step);
 
 
+/* Perform defragmentation of a region of a hash database object.
+   `hdb' specifies the hash database object connected as a writer.
+   `size' specifies the size of the region.  If it is not more than 0, the region reaches the
+   end of the file.
+   If successful, the return value is true, else, it is false.
+   The region begins at the cursor of defragmentation and records are compacted without keeping
+   a continuous lock until the cursor advances by the size or reaches the end of the file.  The
+   cursor is kept for the next call, so successive calls compact the file incrementally. */
+bool tchdbdefrag2(TCHDB *hdb, int64_t size);
+
+
+/* Grow the bucket array of a hash database object incrementally.
+   `hdb' specifies the hash database object connected as a writer.
+   `step' specifies the number of buckets to be split.  If it is not more than 0, buckets are
+   split until the number of records does not exceed the number of buckets.
+   If successful, the return value is true, else, it is false.
+   This is performed automatically while records are stored if the maximum number of elements
+   of the bucket array was set when the database file was created.  Otherwise, nothing is done.
+   Splitting relinks the records of a bucket without moving them, so it is not atomic against a
+   crash unless it is performed in a transaction. */
+bool tchdbgrow(TCHDB *hdb, int64_t step);
+
+
 /* Store a record into a hash database object with a duplication handler.
    `hdb' specifies the hash database object connected as a writer.
    `kbuf' specifies the pointer to the region of the key.
@@ -856,6 +1136,52 @@ bool tchdbiterinit3(TCHDB *hdb, const char *kstr);
 bool tchdbforeach(TCHDB *hdb, TCITER iter, void *op);
 
 
+/* Split the record region of a hash database object into ranges for partitioned iteration.
+   `hdb' specifies the hash database object.
+   `bounds' specifies the pointer to an array of `num' + 1 elements where the offsets of the
+   boundaries are stored.  The `i'-th range begins at `bounds[i]' and ends at `bounds[i+1]'.
+   `num' specifies the number of the ranges.
+   If successful, the return value is true, else, it is false.
+   Every range begins at a record and the ranges are of roughly the same size, although some of
+   them may be empty.  The boundaries are found in the bucket array without reading the record
+   region, and they are valid only until the database is updated.  `tchdbforeach2' should be
+   used instead if other threads may update the database. */
+bool tchdbforeachsplit(TCHDB *hdb, uint64_t *bounds, int num);
+
+
+/* Process each record atomically in a range of a hash database object.
+   `hdb' specifies the hash database object.
+   `begin' specifies the offset of the beginning of the range.  It should be a boundary given by
+   `tchdbforeachsplit'.
+   `end' specifies the offset of the end of the range.
+   `iter' specifies the pointer to the iterator function called for each record.  Its
+   parameters are the same as those of `tchdbforeach'.
+   `op' specifies an arbitrary pointer to be given as a parameter of the iterator function.  If
+   it is not needed, `NULL' can be specified.
+   If successful, the return value is true, else, it is false.
+   Each record whose header begins in the range is processed.  Ranges are read sequentially and
+   independently, so several threads of a database object opened with `tchdbsetmutex' can
+   process distinct ranges at the same time.  In that case, the iterator function should be
+   thread-safe.  Note that the callback function can not perform any database operation. */
+bool tchdbforeachrange(TCHDB *hdb, uint64_t begin, uint64_t end, TCITER iter, void *op);
+
+
+/* Process each record of a hash database object with multiple threads.
+   `hdb' specifies the hash database object.
+   `iter' specifies the pointer to the iterator function called for each record.  Its
+   parameters are the same as those of `tchdbforeach'.  It should be thread-safe.
+   `op' specifies an arbitrary pointer to be given as a parameter of the iterator function.  If
+   it is not needed, `NULL' can be specified.
+   `thnum' specifies the number of threads.
+   If successful, the return value is true, else, it is false.
+   The record region is split as with `tchdbforeachsplit' and each range is processed by its own
+   thread as with `tchdbforeachrange'.  The locks are held from splitting until every range is
+   processed, so that no update can move a boundary off a record.  If the iterator function
+   returns false, all threads stop soon after.  Note that the callback function can not perform
+   any database operation. */
+bool tchdbforeach2(TCHDB *hdb, TCITER iter, void *op, int thnum);
+
+
 /* Void the transaction of a hash database object.
    `hdb' specifies the hash database object connected as a writer.
    If successful, the return value is true, else, it is false.
@@ -863,6 +1189,28 @@ bool tchdbforeach(TCHDB *hdb, TCITER iter, void *op);
 bool tchdbtranvoid(TCHDB *hdb);
 
 
+/* Advise the operating system to read ahead a record of a hash database object.
+   `hdb' specifies the hash database object.
+   `kbuf' specifies the pointer to the region of the key.
+   `ksiz' specifies the size of the region of the key.
+   If successful, the return value is true, else, it is false.  False is returned if no record
+   corresponds to the specified key.
+   The collision tree of the bucket is read synchronously to find the record, and only the value
+   of the record is hinted so that the function returns without waiting for it.  It is useful to
+   overlap the latency of reading several large records which will be retrieved soon. */
+bool tchdbprefetch(TCHDB *hdb, const void *kbuf, int ksiz);
+
+
+/* Advise the operating system to read ahead multiple records of a hash database object.
+   `hdb' specifies the hash database object.
+   `keys' specifies a list object of the keys of the target records.
+   If successful, the return value is true, else, it is false.  Keys of no record are ignored.
+   The heads of the buckets of all keys are hinted at once before any of them is parsed, so that
+   their reads are overlapped, and then the value of each record is hinted as `tchdbprefetch'
+   does. */
+bool tchdbprefetchmulti(TCHDB *hdb, const TCLIST *keys);
+
+
 
 __TCHDB_CLINKAGEEND
 #endif                                   /* duplication check */
@@ -39,7 +39,7 @@ static int runlist(int argc, char **argv);
 static int runoptimize(int argc, char **argv);
 static int runimporttsv(int argc, char **argv);
 static int runversion(int argc, char **argv);
-static int proccreate(const char *path, int bnum, int apow, int fpow, int opts);
+static int proccreate(const char *path, int bnum, int apow, int fpow, int opts, int64_t bmax);
 static int procinform(const char *path, int omode);
 static int procput(const char *path, const char *kbuf, int ksiz, const char *vbuf, int vsiz,
                    int omode, int dmode);
@@ -47,7 +47,7 @@ static int procout(const char *path, const char *kbuf, int ksiz, int omode);
 static int procget(const char *path, const char *kbuf, int ksiz, int omode, bool px, bool pz);
 static int proclist(const char *path, int omode, int max, bool pv, bool px, const char *fmstr);
 static int procoptimize(const char *path, int bnum, int apow, int fpow, int opts, int omode,
-                        bool df);
+                        bool df, int tnum, int64_t dsiz);
 static int procimporttsv(const char *path, const char *file, int omode, bool sc);
 static int procversion(void);
 
@@ -90,14 +90,15 @@ static void usage(void){
   fprintf(stderr, "%s: the command line utility of the hash database API\n", g_progname);
   fprintf(stderr, "\n");
   fprintf(stderr, "usage:\n");
-  fprintf(stderr, "  %s create [-tl] [-td|-tb|-tt|-tx] path [bnum [apow [fpow]]]\n", g_progname);
+  fprintf(stderr, "  %s create [-tl] [-th] [-te] [-td|-tb|-tt|-tf|-tx] [-bm num]"
+          " path [bnum [apow [fpow]]]\n", g_progname);
   fprintf(stderr, "  %s inform [-nl|-nb] path\n", g_progname);
   fprintf(stderr, "  %s put [-nl|-nb] [-sx] [-dk|-dc|-dai|-dad] path key value\n", g_progname);
   fprintf(stderr, "  %s out [-nl|-nb] [-sx] path key\n", g_progname);
   fprintf(stderr, "  %s get [-nl|-nb] [-sx] [-px] [-pz] path key\n", g_progname);
   fprintf(stderr, "  %s list [-nl|-nb] [-m num] [-pv] [-px] [-fm str] path\n", g_progname);
-  fprintf(stderr, "  %s optimize [-tl] [-td|-tb|-tt|-tx] [-tz] [-nl|-nb] [-df]"
-          " path [bnum [apow [fpow]]]\n", g_progname);
+  fprintf(stderr, "  %s optimize [-tl] [-th] [-te] [-td|-tb|-tt|-tf|-tx] [-tz] [-nl|-nb] [-df]"
+          " [-tn num] [-ds num] path [bnum [apow [fpow]]]\n", g_progname);
   fprintf(stderr, "  %s importtsv [-nl|-nb] [-sc] path [file]\n", g_progname);
   fprintf(stderr, "  %s version\n", g_progname);
   fprintf(stderr, "\n");
@@ -164,6 +165,7 @@ static int runcreate(int argc, char **argv){
   char *astr = NULL;
   char *fstr = NULL;
   int opts = 0;
+  int64_t bmax = 0;
   for(int i = 2; i < argc; i++){
     if(!path && argv[i][0] == '-'){
       if(!strcmp(argv[i], "-tl")){
@@ -174,8 +176,17 @@ static int runcreate(int argc, char **argv){
         opts |= HDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= HDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= HDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        opts |= HDBTXHASH;
+      } else if(!strcmp(argv[i], "-te")){
+        opts |= HDBTTTL;
+      } else if(!strcmp(argv[i], "-bm")){
+        if(++i >= argc) usage();
+        bmax = tcatoix(argv[i]);
       } else {
         usage();
       }
@@ -195,7 +206,7 @@ static int runcreate(int argc, char **argv){
   int bnum = bstr ? tcatoix(bstr) : -1;
   int apow = astr ? tcatoix(astr) : -1;
   int fpow = fstr ? tcatoix(fstr) : -1;
-  int rv = proccreate(path, bnum, apow, fpow, opts);
+  int rv = proccreate(path, bnum, apow, fpow, opts, bmax);
   return rv;
 }
 
@@ -415,6 +426,8 @@ static int runoptimize(int argc, char **argv){
   int opts = UINT8_MAX;
   int omode = 0;
   bool df = false;
+  int tnum = 0;
+  int64_t dsiz = 0;
   for(int i = 2; i < argc; i++){
     if(!path && argv[i][0] == '-'){
       if(!strcmp(argv[i], "-tl")){
@@ -432,6 +445,12 @@ static int runoptimize(int argc, char **argv){
       } else if(!strcmp(argv[i], "-tx")){
         if(opts == UINT8_MAX) opts = 0;
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        if(opts == UINT8_MAX) opts = 0;
+        opts |= HDBTXHASH;
+      } else if(!strcmp(argv[i], "-te")){
+        if(opts == UINT8_MAX) opts = 0;
+        opts |= HDBTTTL;
       } else if(!strcmp(argv[i], "-tz")){
         if(opts == UINT8_MAX) opts = 0;
       } else if(!strcmp(argv[i], "-nl")){
@@ -440,6 +459,12 @@ static int runoptimize(int argc, char **argv){
         omode |= HDBOLCKNB;
       } else if(!strcmp(argv[i], "-df")){
         df = true;
+      } else if(!strcmp(argv[i], "-tn")){
+        if(++i >= argc) usage();
+        tnum = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-ds")){
+        if(++i >= argc) usage();
+        dsiz = tcatoix(argv[i]);
       } else {
         usage();
       }
@@ -459,7 +484,7 @@ static int runoptimize(int argc, char **argv){
   int bnum = bstr ? tcatoix(bstr) : -1;
   int apow = astr ? tcatoix(astr) : -1;
   int fpow = fstr ? tcatoix(fstr) : -1;
-  int rv = procoptimize(path, bnum, apow, fpow, opts, omode, df);
+  int rv = procoptimize(path, bnum, apow, fpow, opts, omode, df, tnum, dsiz);
   return rv;
 }
 
@@ -503,11 +528,11 @@ static int runversion(int argc, char **argv){
 
 
 /* perform create command */
-static int proccreate(const char *path, int bnum, int apow, int fpow, int opts){
+static int proccreate(const char *path, int bnum, int apow, int fpow, int opts, int64_t bmax){
   TCHDB *hdb = tchdbnew();
   if(g_dbgfd >= 0) tchdbsetdbgfd(hdb, g_dbgfd);
   if(!tchdbsetcodecfunc(hdb, _tc_recencode, NULL, _tc_recdecode, NULL)) printerr(hdb);
-  if(!tchdbtune(hdb, bnum, apow, fpow, opts)){
+  if(!tchdbtune(hdb, bnum, apow, fpow, opts) || !tchdbsetbmax(hdb, bmax)){
     printerr(hdb);
     tchdbdel(hdb);
     return 1;
@@ -556,6 +581,8 @@ static int procinform(const char *path, int omode){
   if(flags & HDBFFATAL) printf(" fatal");
   printf("\n");
   printf("bucket number: %llu\n", (unsigned long long)tchdbbnum(hdb));
+  if(hdb->lhbase > 0)
+    printf("maximum bucket number: %llu\n", (unsigned long long)hdb->lhmax);
   if(hdb->cnt_writerec >= 0)
     printf("used bucket number: %lld\n", (long long)tchdbbnumused(hdb));
   printf("alignment: %u\n", tchdbalign(hdb));
@@ -570,7 +597,10 @@ static int procinform(const char *path, int omode){
   if(opts & HDBTDEFLATE) printf(" deflate");
   if(opts & HDBTBZIP) printf(" bzip");
   if(opts & HDBTTCBS) printf(" tcbs");
+  if(opts & HDBTFAST) printf(" fast");
   if(opts & HDBTEXCODEC) printf(" excodec");
+  if(opts & HDBTXHASH) printf(" xhash");
+  if(opts & HDBTTTL) printf(" ttl");
   printf("\n");
   printf("record number: %llu\n", (unsigned long long)tchdbrnum(hdb));
   printf("file size: %llu\n", (unsigned long long)tchdbfsiz(hdb));
@@ -750,7 +780,7 @@ static int proclist(const char *path, int omode, int max, bool pv, bool px, cons
 
 /* perform optimize command */
 static int procoptimize(const char *path, int bnum, int apow, int fpow, int opts, int omode,
-                        bool df){
+                        bool df, int tnum, int64_t dsiz){
   TCHDB *hdb = tchdbnew();
   if(g_dbgfd >= 0) tchdbsetdbgfd(hdb, g_dbgfd);
   if(!tchdbsetcodecfunc(hdb, _tc_recencode, NULL, _tc_recdecode, NULL)) printerr(hdb);
@@ -760,11 +790,21 @@ static int procoptimize(const char *path, int bnum, int apow, int fpow, int opts
     return 1;
   }
   bool err = false;
-  if(df){
+  if(dsiz > 0){
+    if(!tchdbdefrag2(hdb, dsiz)){
+      printerr(hdb);
+      err = true;
+    }
+  } else if(df){
     if(!tchdbdefrag(hdb, INT64_MAX)){
       printerr(hdb);
       err = true;
     }
+  } else if(tnum > 0){
+    if(!tchdboptimize2(hdb, bnum, apow, fpow, opts, tnum)){
+      printerr(hdb);
+      err = true;
+    }
   } else {
     if(!tchdboptimize(hdb, bnum, apow, fpow, opts)){
       printerr(hdb);
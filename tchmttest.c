@@ -23,6 +23,7 @@
 typedef struct {                         // type of structure for write thread
   TCHDB *hdb;
   int rnum;
+  int vsiz;
   bool as;
   bool rnd;
   int id;
@@ -90,15 +91,16 @@ static int runwicked(int argc, char **argv);
 static int runtypical(int argc, char **argv);
 static int runrace(int argc, char **argv);
 static int procwrite(const char *path, int tnum, int rnum, int bnum, int apow, int fpow,
-                     int opts, int rcnum, int xmsiz, int dfunit, int omode, bool as, bool rnd);
+                     int opts, int rcnum, int xmsiz, int xmmax, int dfunit, int rlnum,
+                     int vsiz, int omode, bool as, bool rnd);
 static int procread(const char *path, int tnum, int rcnum, int xmsiz, int dfunit, int omode,
                     bool wb, bool rnd);
 static int procremove(const char *path, int tnum, int rcnum, int xmsiz, int dfunit, int omode,
                       bool rnd);
 static int procwicked(const char *path, int tnum, int rnum, int opts, int omode, bool nc);
 static int proctypical(const char *path, int tnum, int rnum, int bnum, int apow, int fpow,
-                       int opts, int rcnum, int xmsiz, int dfunit, int omode,
-                       bool nc, int rratio);
+                       int opts, int rcnum, int xmsiz, int dfunit, int dwmsec, int rlnum,
+                       int omode, bool nc, int rratio);
 static int procrace(const char *path, int tnum, int rnum, int bnum, int apow, int fpow,
                     int opts, int xmsiz, int dfunit, int omode);
 static void *threadwrite(void *targ);
@@ -150,17 +152,19 @@ static void usage(void){
   fprintf(stderr, "%s: test cases of the hash database API of Tokyo Cabinet\n", g_progname);
   fprintf(stderr, "\n");
   fprintf(stderr, "usage:\n");
-  fprintf(stderr, "  %s write [-tl] [-td|-tb|-tt|-tx] [-rc num] [-xm num] [-df num]"
-          " [-nl|-nb] [-as] [-rnd] path tnum rnum [bnum [apow [fpow]]]\n", g_progname);
+  fprintf(stderr, "  %s write [-tl] [-th] [-td|-tb|-tt|-tf|-tx] [-rc num] [-xm num] [-xx num]"
+          " [-df num] [-rl num] [-vs num] [-nl|-nb] [-as] [-rnd] path tnum rnum"
+          " [bnum [apow [fpow]]]\n", g_progname);
   fprintf(stderr, "  %s read [-rc num] [-xm num] [-df num] [-nl|-nb] [-wb] [-rnd] path tnum\n",
           g_progname);
   fprintf(stderr, "  %s remove [-rc num] [-xm num] [-df num] [-nl|-nb] [-rnd] path tnum\n",
           g_progname);
-  fprintf(stderr, "  %s wicked [-tl] [-td|-tb|-tt|-tx] [-nl|-nb] [-nc]"
+  fprintf(stderr, "  %s wicked [-tl] [-th] [-td|-tb|-tt|-tf|-tx] [-nl|-nb] [-nc] [-ts]"
           " path tnum rnum\n", g_progname);
-  fprintf(stderr, "  %s typical [-tl] [-td|-tb|-tt|-tx] [-rc num] [-xm num] [-df num]"
-          " [-nl|-nb] [-nc] [-rr num] path tnum rnum [bnum [apow [fpow]]]\n", g_progname);
-  fprintf(stderr, "  %s race [-tl] [-td|-tb|-tt|-tx] [-xm num] [-df num] [-nl|-nb]"
+  fprintf(stderr, "  %s typical [-tl] [-th] [-td|-tb|-tt|-tf|-tx] [-rc num] [-xm num] [-df num]"
+          " [-dw num] [-rl num] [-nl|-nb] [-nc] [-rr num] path tnum rnum [bnum [apow [fpow]]]\n",
+          g_progname);
+  fprintf(stderr, "  %s race [-tl] [-th] [-td|-tb|-tt|-tf|-tx] [-xm num] [-df num] [-nl|-nb]"
           " path tnum rnum [bnum [apow [fpow]]]\n", g_progname);
   fprintf(stderr, "\n");
   exit(1);
@@ -273,7 +277,10 @@ static int runwrite(int argc, char **argv){
   int opts = 0;
   int rcnum = 0;
   int xmsiz = -1;
+  int xmmax = 0;
   int dfunit = 0;
+  int rlnum = 0;
+  int vsiz = 0;
   int omode = 0;
   bool as = false;
   bool rnd = false;
@@ -287,17 +294,30 @@ static int runwrite(int argc, char **argv){
         opts |= HDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= HDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= HDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        opts |= HDBTXHASH;
       } else if(!strcmp(argv[i], "-rc")){
         if(++i >= argc) usage();
         rcnum = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-xm")){
         if(++i >= argc) usage();
         xmsiz = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-xx")){
+        if(++i >= argc) usage();
+        xmmax = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-df")){
         if(++i >= argc) usage();
         dfunit = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-rl")){
+        if(++i >= argc) usage();
+        rlnum = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-vs")){
+        if(++i >= argc) usage();
+        vsiz = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-nl")){
         omode |= HDBONOLCK;
       } else if(!strcmp(argv[i], "-nb")){
@@ -332,8 +352,8 @@ static int runwrite(int argc, char **argv){
   int bnum = bstr ? tcatoix(bstr) : -1;
   int apow = astr ? tcatoix(astr) : -1;
   int fpow = fstr ? tcatoix(fstr) : -1;
-  int rv = procwrite(path, tnum, rnum, bnum, apow, fpow, opts, rcnum, xmsiz, dfunit, omode,
-                     as, rnd);
+  int rv = procwrite(path, tnum, rnum, bnum, apow, fpow, opts, rcnum, xmsiz, xmmax, dfunit,
+                     rlnum, vsiz, omode, as, rnd);
   return rv;
 }
 
@@ -449,14 +469,20 @@ static int runwicked(int argc, char **argv){
         opts |= HDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= HDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= HDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        opts |= HDBTXHASH;
       } else if(!strcmp(argv[i], "-nl")){
         omode |= HDBONOLCK;
       } else if(!strcmp(argv[i], "-nb")){
         omode |= HDBOLCKNB;
       } else if(!strcmp(argv[i], "-nc")){
         nc = true;
+      } else if(!strcmp(argv[i], "-ts")){
+        omode |= HDBOTSYNC;
       } else {
         usage();
       }
@@ -491,6 +517,8 @@ static int runtypical(int argc, char **argv){
   int rcnum = 0;
   int xmsiz = -1;
   int dfunit = 0;
+  int dwmsec = 0;
+  int rlnum = 0;
   int omode = 0;
   int rratio = -1;
   bool nc = false;
@@ -504,8 +532,12 @@ static int runtypical(int argc, char **argv){
         opts |= HDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= HDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= HDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        opts |= HDBTXHASH;
       } else if(!strcmp(argv[i], "-rc")){
         if(++i >= argc) usage();
         rcnum = tcatoix(argv[i]);
@@ -515,6 +547,12 @@ static int runtypical(int argc, char **argv){
       } else if(!strcmp(argv[i], "-df")){
         if(++i >= argc) usage();
         dfunit = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-dw")){
+        if(++i >= argc) usage();
+        dwmsec = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-rl")){
+        if(++i >= argc) usage();
+        rlnum = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-nl")){
         omode |= HDBONOLCK;
       } else if(!strcmp(argv[i], "-nb")){
@@ -550,8 +588,8 @@ static int runtypical(int argc, char **argv){
   int bnum = bstr ? tcatoix(bstr) : -1;
   int apow = astr ? tcatoix(astr) : -1;
   int fpow = fstr ? tcatoix(fstr) : -1;
-  int rv = proctypical(path, tnum, rnum, bnum, apow, fpow, opts, rcnum, xmsiz, dfunit, omode,
-                       nc, rratio);
+  int rv = proctypical(path, tnum, rnum, bnum, apow, fpow, opts, rcnum, xmsiz, dfunit, dwmsec,
+                       rlnum, omode, nc, rratio);
   return rv;
 }
 
@@ -578,8 +616,12 @@ static int runrace(int argc, char **argv){
         opts |= HDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= HDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= HDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        opts |= HDBTXHASH;
       } else if(!strcmp(argv[i], "-xm")){
         if(++i >= argc) usage();
         xmsiz = tcatoix(argv[i]);
@@ -623,17 +665,18 @@ static int runrace(int argc, char **argv){
 
 /* perform write command */
 static int procwrite(const char *path, int tnum, int rnum, int bnum, int apow, int fpow,
-                     int opts, int rcnum, int xmsiz, int dfunit, int omode, bool as, bool rnd){
+                     int opts, int rcnum, int xmsiz, int xmmax, int dfunit, int rlnum,
+                     int vsiz, int omode, bool as, bool rnd){
   iprintf("<Writing Test>\n  seed=%u  path=%s  tnum=%d  rnum=%d  bnum=%d  apow=%d  fpow=%d"
-          "  opts=%d  rcnum=%d  xmsiz=%d  dfunit=%d  omode=%d  as=%d  rnd=%d\n\n",
-          g_randseed, path, tnum, rnum, bnum, apow, fpow, opts, rcnum, xmsiz, dfunit, omode,
-          as, rnd);
+          "  opts=%d  rcnum=%d  xmsiz=%d  xmmax=%d  dfunit=%d  rlnum=%d  vsiz=%d  omode=%d"
+          "  as=%d  rnd=%d\n\n", g_randseed, path, tnum, rnum, bnum, apow, fpow, opts, rcnum,
+          xmsiz, xmmax, dfunit, rlnum, vsiz, omode, as, rnd);
   bool err = false;
   double stime = tctime();
   TCHDB *hdb = tchdbnew();
   if(g_dbgfd >= 0) tchdbsetdbgfd(hdb, g_dbgfd);
-  if(!tchdbsetmutex(hdb)){
-    eprint(hdb, __LINE__, "tchdbsetmutex");
+  if(!tchdbsetmutex2(hdb, rlnum)){
+    eprint(hdb, __LINE__, "tchdbsetmutex2");
     err = true;
   }
   if(!tchdbsetcodecfunc(hdb, _tc_recencode, NULL, _tc_recdecode, NULL)){
@@ -652,6 +695,10 @@ static int procwrite(const char *path, int tnum, int rnum, int bnum, int apow, i
     eprint(hdb, __LINE__, "tchdbsetxmsiz");
     err = true;
   }
+  if(xmmax > 0 && !tchdbsetxmmax(hdb, xmmax)){
+    eprint(hdb, __LINE__, "tchdbsetxmmax");
+    err = true;
+  }
   if(dfunit >= 0 && !tchdbsetdfunit(hdb, dfunit)){
     eprint(hdb, __LINE__, "tchdbsetdfunit");
     err = true;
@@ -665,6 +712,7 @@ static int procwrite(const char *path, int tnum, int rnum, int bnum, int apow, i
   if(tnum == 1){
     targs[0].hdb = hdb;
     targs[0].rnum = rnum;
+    targs[0].vsiz = vsiz;
     targs[0].as = as;
     targs[0].rnd = rnd;
     targs[0].id = 0;
@@ -673,6 +721,7 @@ static int procwrite(const char *path, int tnum, int rnum, int bnum, int apow, i
     for(int i = 0; i < tnum; i++){
       targs[i].hdb = hdb;
       targs[i].rnum = rnum;
+      targs[i].vsiz = vsiz;
       targs[i].as = as;
       targs[i].rnd = rnd;
       targs[i].id = i;
@@ -1000,18 +1049,19 @@ static int procwicked(const char *path, int tnum, int rnum, int opts, int omode,
 
 /* perform typical command */
 static int proctypical(const char *path, int tnum, int rnum, int bnum, int apow, int fpow,
-                       int opts, int rcnum, int xmsiz, int dfunit, int omode,
-                       bool nc, int rratio){
+                       int opts, int rcnum, int xmsiz, int dfunit, int dwmsec, int rlnum,
+                       int omode, bool nc, int rratio){
   iprintf("<Typical Access Test>\n  seed=%u  path=%s  tnum=%d  rnum=%d  bnum=%d  apow=%d"
-          "  fpow=%d  opts=%d  rcnum=%d  xmsiz=%d  dfunit=%d  omode=%d  nc=%d  rratio=%d\n\n",
-          g_randseed, path, tnum, rnum, bnum, apow, fpow, opts, rcnum, xmsiz, dfunit, omode,
-          nc, rratio);
+          "  fpow=%d  opts=%d  rcnum=%d  xmsiz=%d  dfunit=%d  dwmsec=%d  rlnum=%d  omode=%d"
+          "  nc=%d  rratio=%d\n\n",
+          g_randseed, path, tnum, rnum, bnum, apow, fpow, opts, rcnum, xmsiz, dfunit, dwmsec,
+          rlnum, omode, nc, rratio);
   bool err = false;
   double stime = tctime();
   TCHDB *hdb = tchdbnew();
   if(g_dbgfd >= 0) tchdbsetdbgfd(hdb, g_dbgfd);
-  if(!tchdbsetmutex(hdb)){
-    eprint(hdb, __LINE__, "tchdbsetmutex");
+  if(!tchdbsetmutex2(hdb, rlnum)){
+    eprint(hdb, __LINE__, "tchdbsetmutex2");
     err = true;
   }
   if(!tchdbsetcodecfunc(hdb, _tc_recencode, NULL, _tc_recdecode, NULL)){
@@ -1034,6 +1084,10 @@ static int proctypical(const char *path, int tnum, int rnum, int bnum, int apow,
     eprint(hdb, __LINE__, "tchdbsetdfunit");
     err = true;
   }
+  if(dwmsec > 0 && !tchdbsetdfthread(hdb, 0, dwmsec)){
+    eprint(hdb, __LINE__, "tchdbsetdfthread");
+    err = true;
+  }
   if(!tchdbopen(hdb, path, HDBOWRITER | HDBOCREAT | HDBOTRUNC | omode)){
     eprint(hdb, __LINE__, "tchdbopen");
     err = true;
@@ -1071,6 +1125,13 @@ static int proctypical(const char *path, int tnum, int rnum, int bnum, int apow,
       }
     }
   }
+  if(dwmsec > 0){
+    uint64_t dwrnum, dwsnum, dwusec;
+    tchdbdfstat(hdb, &dwrnum, &dwsnum, &dwusec);
+    iprintf("background defragmentation: rounds=%llu  steps=%llu  usec=%llu\n",
+            (unsigned long long)dwrnum, (unsigned long long)dwsnum,
+            (unsigned long long)dwusec);
+  }
   iprintf("record number: %llu\n", (unsigned long long)tchdbrnum(hdb));
   iprintf("size: %llu\n", (unsigned long long)tchdbfsiz(hdb));
   mprint(hdb);
@@ -1168,22 +1229,37 @@ static int procrace(const char *path, int tnum, int rnum, int bnum, int apow, in
 static void *threadwrite(void *targ){
   TCHDB *hdb = ((TARGWRITE *)targ)->hdb;
   int rnum = ((TARGWRITE *)targ)->rnum;
+  int vsiz = ((TARGWRITE *)targ)->vsiz;
   bool as = ((TARGWRITE *)targ)->as;
   bool rnd = ((TARGWRITE *)targ)->rnd;
   int id = ((TARGWRITE *)targ)->id;
   bool err = false;
   int base = id * rnum;
+  char *vbuf = NULL;
+  if(vsiz > 0){
+    vbuf = tcmalloc(vsiz);
+    for(int i = 0; i < vsiz; i++){
+      vbuf[i] = 'a' + i % 26;
+    }
+  }
   for(int i = 1; i <= rnum; i++){
     char buf[RECBUFSIZ];
     int len = sprintf(buf, "%08d", base + (rnd ? myrand(i) : i));
+    const char *vp = buf;
+    int vl = len;
+    if(vbuf){
+      memcpy(vbuf, buf, tclmin(len, vsiz));
+      vp = vbuf;
+      vl = vsiz;
+    }
     if(as){
-      if(!tchdbputasync(hdb, buf, len, buf, len)){
+      if(!tchdbputasync(hdb, buf, len, vp, vl)){
         eprint(hdb, __LINE__, "tchdbputasync");
         err = true;
         break;
       }
     } else {
-      if(!tchdbput(hdb, buf, len, buf, len)){
+      if(!tchdbput(hdb, buf, len, vp, vl)){
         eprint(hdb, __LINE__, "tchdbput");
         err = true;
         break;
@@ -1194,6 +1270,7 @@ static void *threadwrite(void *targ){
       if(i == rnum || i % (rnum / 10) == 0) iprintf(" (%08d)\n", i);
     }
   }
+  tcfree(vbuf);
   return err ? "error" : NULL;
 }
 
@@ -1277,6 +1354,36 @@ static void *threadwicked(void *targ){
     vbuf[vsiz] = '\0';
     char *rbuf;
     if(!nc) tcglobalmutexlock();
+    if(id == 0 && i == rnum / 2){
+      char *npath = tcsprintf("%s-snap", tchdbpath(hdb));
+      if(!tchdbsnapshot(hdb, npath)){
+        eprint(hdb, __LINE__, "tchdbsnapshot");
+        err = true;
+      }
+      TCHDB *nhdb = tchdbnew();
+      if(!tchdbopen(nhdb, npath, HDBOREADER | HDBONOLCK)){
+        eprint(nhdb, __LINE__, "tchdbopen");
+        err = true;
+      }
+      uint64_t inum = 0;
+      if(!tchdbiterinit(nhdb)){
+        eprint(nhdb, __LINE__, "tchdbiterinit");
+        err = true;
+      }
+      char *ikbuf;
+      int iksiz;
+      while((ikbuf = tchdbiternext(nhdb, &iksiz)) != NULL){
+        inum++;
+        tcfree(ikbuf);
+      }
+      if(inum != tchdbrnum(nhdb)){
+        eprint(nhdb, __LINE__, "(validation)");
+        err = true;
+      }
+      tchdbdel(nhdb);
+      unlink(npath);
+      tcfree(npath);
+    }
     switch(myrand(16)){
     case 0:
       if(id == 0) iputchar('0');
@@ -38,6 +38,8 @@ static void sysprint(void);
 static int myrand(int range);
 static void *pdprocfunc(const void *vbuf, int vsiz, int *sp, void *op);
 static bool iterfunc(const void *kbuf, int ksiz, const void *vbuf, int vsiz, void *op);
+static void rcvfunc(uint64_t done, uint64_t total, void *op);
+static bool cntfunc(const void *kbuf, int ksiz, const void *vbuf, int vsiz, void *op);
 static int runwrite(int argc, char **argv);
 static int runread(int argc, char **argv);
 static int runremove(int argc, char **argv);
@@ -45,16 +47,17 @@ static int runrcat(int argc, char **argv);
 static int runmisc(int argc, char **argv);
 static int runwicked(int argc, char **argv);
 static int procwrite(const char *path, int rnum, int bnum, int apow, int fpow,
-                     bool mt, int opts, int rcnum, int xmsiz, int dfunit, int omode,
-                     bool as, bool rnd);
-static int procread(const char *path, bool mt, int rcnum, int xmsiz, int dfunit, int omode,
-                    bool wb, bool rnd);
+                     bool mt, int opts, int rcnum, int xmsiz, int xmmax, int dfunit, int bmax,
+                     int bfnum, int omode, bool as, int pbnum, bool rnd);
+static int procread(const char *path, bool mt, int rcnum, int xmsiz, int xmmax, int dfunit,
+                    int bfnum, int mopts, int omode, bool wb, bool rnd);
 static int procremove(const char *path, bool mt, int rcnum, int xmsiz, int dfunit, int omode,
                       bool rnd);
 static int procrcat(const char *path, int rnum, int bnum, int apow, int fpow,
                     bool mt, int opts, int rcnum, int xmsiz, int dfunit, int omode, int pnum,
                     bool dai, bool dad, bool rl, bool ru);
-static int procmisc(const char *path, int rnum, bool mt, int opts, int omode);
+static int procmisc(const char *path, int rnum, bool mt, int opts, int bfnum, int iodepth,
+                    int omode);
 static int procwicked(const char *path, int rnum, bool mt, int opts, int omode);
 
 
@@ -99,17 +102,21 @@ static void usage(void){
   fprintf(stderr, "%s: test cases of the hash database API of Tokyo Cabinet\n", g_progname);
   fprintf(stderr, "\n");
   fprintf(stderr, "usage:\n");
-  fprintf(stderr, "  %s write [-mt] [-tl] [-td|-tb|-tt|-tx] [-rc num] [-xm num] [-df num]"
-          " [-nl|-nb] [-as] [-rnd] path rnum [bnum [apow [fpow]]]\n", g_progname);
-  fprintf(stderr, "  %s read [-mt] [-rc num] [-xm num] [-df num] [-nl|-nb] [-wb] [-rnd] path\n",
+  fprintf(stderr, "  %s write [-mt] [-tl] [-th] [-td|-tb|-tt|-tf|-tx] [-rc num] [-xm num] [-xx num]"
+          " [-df num] [-bm num] [-bf num] [-nl|-nb] [-as|-pb num] [-rnd]"
+          " path rnum [bnum [apow [fpow]]]\n", g_progname);
+  fprintf(stderr, "  %s read [-mt] [-rc num] [-xm num] [-xx num] [-df num] [-bf num] [-mo num]"
+          " [-nl|-nb] [-wb] [-rnd] path\n",
           g_progname);
   fprintf(stderr, "  %s remove [-mt] [-rc num] [-xm num] [-df num] [-nl|-nb] [-rnd] path\n",
           g_progname);
-  fprintf(stderr, "  %s rcat [-mt] [-tl] [-td|-tb|-tt|-tx] [-rc num] [-xm num] [-df num]"
+  fprintf(stderr, "  %s rcat [-mt] [-tl] [-th] [-td|-tb|-tt|-tf|-tx] [-rc num] [-xm num] [-df num]"
           " [-nl|-nb] [-pn num] [-dai|-dad|-rl|-ru] path rnum [bnum [apow [fpow]]]\n",
           g_progname);
-  fprintf(stderr, "  %s misc [-mt] [-tl] [-td|-tb|-tt|-tx] [-nl|-nb] path rnum\n", g_progname);
-  fprintf(stderr, "  %s wicked [-mt] [-tl] [-td|-tb|-tt|-tx] [-nl|-nb] path rnum\n", g_progname);
+  fprintf(stderr, "  %s misc [-mt] [-tl] [-th] [-te] [-td|-tb|-tt|-tf|-tx] [-bf num] [-io num]"
+          " [-nl|-nb] path rnum\n", g_progname);
+  fprintf(stderr, "  %s wicked [-mt] [-tl] [-th] [-td|-tb|-tt|-tf|-tx] [-nl|-nb] path rnum\n",
+          g_progname);
   fprintf(stderr, "\n");
   exit(1);
 }
@@ -231,6 +238,22 @@ static bool iterfunc(const void *kbuf, int ksiz, const void *vbuf, int vsiz, voi
 }
 
 
+/* progress function for recovery */
+static void rcvfunc(uint64_t done, uint64_t total, void *op){
+  uint64_t *prog = op;
+  if(done < prog[0] || done > total) prog[1]++;
+  prog[0] = done;
+  prog[2] = total;
+}
+
+
+/* counting function for ranges */
+static bool cntfunc(const void *kbuf, int ksiz, const void *vbuf, int vsiz, void *op){
+  __sync_fetch_and_add((uint64_t *)op, 1);
+  return true;
+}
+
+
 /* parse arguments of write command */
 static int runwrite(int argc, char **argv){
   char *path = NULL;
@@ -242,9 +265,13 @@ static int runwrite(int argc, char **argv){
   int opts = 0;
   int rcnum = 0;
   int xmsiz = -1;
+  int xmmax = 0;
   int dfunit = 0;
+  int bmax = 0;
+  int bfnum = 0;
   int omode = 0;
   bool as = false;
+  int pbnum = 0;
   bool rnd = false;
   for(int i = 2; i < argc; i++){
     if(!path && argv[i][0] == '-'){
@@ -258,23 +285,39 @@ static int runwrite(int argc, char **argv){
         opts |= HDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= HDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= HDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        opts |= HDBTXHASH;
       } else if(!strcmp(argv[i], "-rc")){
         if(++i >= argc) usage();
         rcnum = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-xm")){
         if(++i >= argc) usage();
         xmsiz = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-xx")){
+        if(++i >= argc) usage();
+        xmmax = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-df")){
         if(++i >= argc) usage();
         dfunit = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-bm")){
+        if(++i >= argc) usage();
+        bmax = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-bf")){
+        if(++i >= argc) usage();
+        bfnum = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-nl")){
         omode |= HDBONOLCK;
       } else if(!strcmp(argv[i], "-nb")){
         omode |= HDBOLCKNB;
       } else if(!strcmp(argv[i], "-as")){
         as = true;
+      } else if(!strcmp(argv[i], "-pb")){
+        if(++i >= argc) usage();
+        pbnum = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-rnd")){
         rnd = true;
       } else {
@@ -301,7 +344,7 @@ static int runwrite(int argc, char **argv){
   int apow = astr ? tcatoix(astr) : -1;
   int fpow = fstr ? tcatoix(fstr) : -1;
   int rv = procwrite(path, rnum, bnum, apow, fpow,
-                     mt, opts, rcnum, xmsiz, dfunit, omode, as, rnd);
+                     mt, opts, rcnum, xmsiz, xmmax, dfunit, bmax, bfnum, omode, as, pbnum, rnd);
   return rv;
 }
 
@@ -312,7 +355,10 @@ static int runread(int argc, char **argv){
   bool mt = false;
   int rcnum = 0;
   int xmsiz = -1;
+  int xmmax = 0;
   int dfunit = 0;
+  int bfnum = 0;
+  int mopts = 0;
   int omode = 0;
   bool wb = false;
   bool rnd = false;
@@ -326,9 +372,18 @@ static int runread(int argc, char **argv){
       } else if(!strcmp(argv[i], "-xm")){
         if(++i >= argc) usage();
         xmsiz = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-xx")){
+        if(++i >= argc) usage();
+        xmmax = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-df")){
         if(++i >= argc) usage();
         dfunit = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-bf")){
+        if(++i >= argc) usage();
+        bfnum = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-mo")){
+        if(++i >= argc) usage();
+        mopts = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-nl")){
         omode |= HDBONOLCK;
       } else if(!strcmp(argv[i], "-nb")){
@@ -347,7 +402,7 @@ static int runread(int argc, char **argv){
     }
   }
   if(!path) usage();
-  int rv = procread(path, mt, rcnum, xmsiz, dfunit, omode, wb, rnd);
+  int rv = procread(path, mt, rcnum, xmsiz, xmmax, dfunit, bfnum, mopts, omode, wb, rnd);
   return rv;
 }
 
@@ -425,8 +480,12 @@ static int runrcat(int argc, char **argv){
         opts |= HDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= HDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= HDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        opts |= HDBTXHASH;
       } else if(!strcmp(argv[i], "-rc")){
         if(++i >= argc) usage();
         rcnum = tcatoix(argv[i]);
@@ -486,6 +545,8 @@ static int runmisc(int argc, char **argv){
   char *rstr = NULL;
   bool mt = false;
   int opts = 0;
+  int bfnum = 0;
+  int iodepth = 0;
   int omode = 0;
   for(int i = 2; i < argc; i++){
     if(!path && argv[i][0] == '-'){
@@ -499,8 +560,20 @@ static int runmisc(int argc, char **argv){
         opts |= HDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= HDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= HDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        opts |= HDBTXHASH;
+      } else if(!strcmp(argv[i], "-te")){
+        opts |= HDBTTTL;
+      } else if(!strcmp(argv[i], "-bf")){
+        if(++i >= argc) usage();
+        bfnum = tcatoix(argv[i]);
+      } else if(!strcmp(argv[i], "-io")){
+        if(++i >= argc) usage();
+        iodepth = tcatoix(argv[i]);
       } else if(!strcmp(argv[i], "-nl")){
         omode |= HDBONOLCK;
       } else if(!strcmp(argv[i], "-nb")){
@@ -519,7 +592,7 @@ static int runmisc(int argc, char **argv){
   if(!path || !rstr) usage();
   int rnum = tcatoix(rstr);
   if(rnum < 1) usage();
-  int rv = procmisc(path, rnum, mt, opts, omode);
+  int rv = procmisc(path, rnum, mt, opts, bfnum, iodepth, omode);
   return rv;
 }
 
@@ -543,8 +616,12 @@ static int runwicked(int argc, char **argv){
         opts |= HDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= HDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= HDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= HDBTEXCODEC;
+      } else if(!strcmp(argv[i], "-th")){
+        opts |= HDBTXHASH;
       } else if(!strcmp(argv[i], "-nl")){
         omode |= HDBONOLCK;
       } else if(!strcmp(argv[i], "-nb")){
@@ -570,12 +647,13 @@ static int runwicked(int argc, char **argv){
 
 /* perform write command */
 static int procwrite(const char *path, int rnum, int bnum, int apow, int fpow,
-                     bool mt, int opts, int rcnum, int xmsiz, int dfunit, int omode,
-                     bool as, bool rnd){
+                     bool mt, int opts, int rcnum, int xmsiz, int xmmax, int dfunit, int bmax,
+                     int bfnum, int omode, bool as, int pbnum, bool rnd){
   iprintf("<Writing Test>\n  seed=%u  path=%s  rnum=%d  bnum=%d  apow=%d  fpow=%d  mt=%d"
-          "  opts=%d  rcnum=%d  xmsiz=%d  dfunit=%d  omode=%d  as=%d  rnd=%d\n\n",
-          g_randseed, path, rnum, bnum, apow, fpow, mt, opts, rcnum, xmsiz, dfunit,
-          omode, as, rnd);
+          "  opts=%d  rcnum=%d  xmsiz=%d  xmmax=%d  dfunit=%d  bmax=%d  bfnum=%d  omode=%d"
+          "  as=%d  pbnum=%d  rnd=%d\n\n",
+          g_randseed, path, rnum, bnum, apow, fpow, mt, opts, rcnum, xmsiz, xmmax, dfunit, bmax,
+          bfnum, omode, as, pbnum, rnd);
   bool err = false;
   double stime = tctime();
   TCHDB *hdb = tchdbnew();
@@ -600,19 +678,43 @@ static int procwrite(const char *path, int rnum, int bnum, int apow, int fpow,
     eprint(hdb, __LINE__, "tchdbsetxmsiz");
     err = true;
   }
+  if(xmmax > 0 && !tchdbsetxmmax(hdb, xmmax)){
+    eprint(hdb, __LINE__, "tchdbsetxmmax");
+    err = true;
+  }
   if(dfunit >= 0 && !tchdbsetdfunit(hdb, dfunit)){
     eprint(hdb, __LINE__, "tchdbsetdfunit");
     err = true;
   }
+  if(bmax > 0 && !tchdbsetbmax(hdb, bmax)){
+    eprint(hdb, __LINE__, "tchdbsetbmax");
+    err = true;
+  }
+  if(bfnum > 0 && !tchdbsetbloom(hdb, bfnum)){
+    eprint(hdb, __LINE__, "tchdbsetbloom");
+    err = true;
+  }
   if(!rnd) omode |= HDBOTRUNC;
   if(!tchdbopen(hdb, path, HDBOWRITER | HDBOCREAT | omode)){
     eprint(hdb, __LINE__, "tchdbopen");
     err = true;
   }
+  TCLIST *recs = tclistnew();
   for(int i = 1; i <= rnum; i++){
     char buf[RECBUFSIZ];
     int len = sprintf(buf, "%08d", rnd ? myrand(rnum) + 1 : i);
-    if(as){
+    if(pbnum > 0){
+      tclistpush(recs, buf, len);
+      tclistpush(recs, buf, len);
+      if(tclistnum(recs) >= pbnum * 2 || i == rnum){
+        if(!tchdbputbatch(hdb, recs)){
+          eprint(hdb, __LINE__, "tchdbputbatch");
+          err = true;
+          break;
+        }
+        tclistclear(recs);
+      }
+    } else if(as){
       if(!tchdbputasync(hdb, buf, len, buf, len)){
         eprint(hdb, __LINE__, "tchdbput");
         err = true;
@@ -630,6 +732,7 @@ static int procwrite(const char *path, int rnum, int bnum, int apow, int fpow,
       if(i == rnum || i % (rnum / 10) == 0) iprintf(" (%08d)\n", i);
     }
   }
+  tclistdel(recs);
   iprintf("record number: %llu\n", (unsigned long long)tchdbrnum(hdb));
   iprintf("size: %llu\n", (unsigned long long)tchdbfsiz(hdb));
   mprint(hdb);
@@ -646,10 +749,11 @@ static int procwrite(const char *path, int rnum, int bnum, int apow, int fpow,
 
 
 /* perform read command */
-static int procread(const char *path, bool mt, int rcnum, int xmsiz, int dfunit, int omode,
-                    bool wb, bool rnd){
-  iprintf("<Reading Test>\n  seed=%u  path=%s  mt=%d  rcnum=%d  xmsiz=%d  dfunit=%d  omode=%d"
-          "  wb=%d  rnd=%d\n\n", g_randseed, path, mt, rcnum, xmsiz, dfunit, omode, wb, rnd);
+static int procread(const char *path, bool mt, int rcnum, int xmsiz, int xmmax, int dfunit,
+                    int bfnum, int mopts, int omode, bool wb, bool rnd){
+  iprintf("<Reading Test>\n  seed=%u  path=%s  mt=%d  rcnum=%d  xmsiz=%d  xmmax=%d  dfunit=%d"
+          "  bfnum=%d  mopts=%d  omode=%d  wb=%d  rnd=%d\n\n", g_randseed, path, mt, rcnum,
+          xmsiz, xmmax, dfunit, bfnum, mopts, omode, wb, rnd);
   bool err = false;
   double stime = tctime();
   TCHDB *hdb = tchdbnew();
@@ -670,10 +774,22 @@ static int procread(const char *path, bool mt, int rcnum, int xmsiz, int dfunit,
     eprint(hdb, __LINE__, "tchdbsetxmsiz");
     err = true;
   }
+  if(xmmax > 0 && !tchdbsetxmmax(hdb, xmmax)){
+    eprint(hdb, __LINE__, "tchdbsetxmmax");
+    err = true;
+  }
   if(dfunit >= 0 && !tchdbsetdfunit(hdb, dfunit)){
     eprint(hdb, __LINE__, "tchdbsetdfunit");
     err = true;
   }
+  if(bfnum > 0 && !tchdbsetbloom(hdb, bfnum)){
+    eprint(hdb, __LINE__, "tchdbsetbloom");
+    err = true;
+  }
+  if(mopts > 0 && !tchdbsetmemopts(hdb, mopts)){
+    eprint(hdb, __LINE__, "tchdbsetmemopts");
+    err = true;
+  }
   if(!tchdbopen(hdb, path, HDBOREADER | omode)){
     eprint(hdb, __LINE__, "tchdbopen");
     err = true;
@@ -939,9 +1055,10 @@ static int procrcat(const char *path, int rnum, int bnum, int apow, int fpow,
 
 
 /* perform misc command */
-static int procmisc(const char *path, int rnum, bool mt, int opts, int omode){
-  iprintf("<Miscellaneous Test>\n  seed=%u  path=%s  rnum=%d  mt=%d  opts=%d  omode=%d\n\n",
-          g_randseed, path, rnum, mt, opts, omode);
+static int procmisc(const char *path, int rnum, bool mt, int opts, int bfnum, int iodepth,
+                    int omode){
+  iprintf("<Miscellaneous Test>\n  seed=%u  path=%s  rnum=%d  mt=%d  opts=%d  bfnum=%d"
+          "  iodepth=%d  omode=%d\n\n", g_randseed, path, rnum, mt, opts, bfnum, iodepth, omode);
   bool err = false;
   double stime = tctime();
   TCHDB *hdb = tchdbnew();
@@ -954,6 +1071,11 @@ static int procmisc(const char *path, int rnum, bool mt, int opts, int omode){
     eprint(hdb, __LINE__, "tchdbsetcodecfunc");
     err = true;
   }
+  uint64_t prog[3] = { 0, 0, 0 };
+  if(!tchdbsetrcvfunc(hdb, rcvfunc, prog)){
+    eprint(hdb, __LINE__, "tchdbsetrcvfunc");
+    err = true;
+  }
   if(!tchdbtune(hdb, rnum / 50, 2, -1, opts)){
     eprint(hdb, __LINE__, "tchdbtune");
     err = true;
@@ -970,6 +1092,14 @@ static int procmisc(const char *path, int rnum, bool mt, int opts, int omode){
     eprint(hdb, __LINE__, "tchdbsetdfunit");
     err = true;
   }
+  if(bfnum > 0 && !tchdbsetbloom(hdb, bfnum)){
+    eprint(hdb, __LINE__, "tchdbsetbloom");
+    err = true;
+  }
+  if(iodepth > 0 && !tchdbsetiodepth(hdb, iodepth)){
+    eprint(hdb, __LINE__, "tchdbsetiodepth");
+    err = true;
+  }
   if(!tchdbopen(hdb, path, HDBOWRITER | HDBOCREAT | HDBOTRUNC | omode)){
     eprint(hdb, __LINE__, "tchdbopen");
     err = true;
@@ -1283,6 +1413,41 @@ static int procmisc(const char *path, int rnum, bool mt, int opts, int omode){
       if(i == rnum || i % (rnum / 10) == 0) iprintf(" (%08d)\n", i);
     }
   }
+  iprintf("multiple reading:\n");
+  for(int i = 1; !err && i <= rnum; i += 100){
+    TCLIST *keys = tclistnew();
+    for(int j = i + 99; j >= i; j--){
+      char kbuf[RECBUFSIZ];
+      int ksiz = sprintf(kbuf, "%08d", j);
+      tclistpush(keys, kbuf, ksiz);
+    }
+    tclistpush2(keys, "[missing]");
+    TCMAP *recs = tcmapnew();
+    if(!tchdbgetmulti(hdb, keys, recs)){
+      eprint(hdb, __LINE__, "tchdbgetmulti");
+      err = true;
+    } else if(tcmaprnum(recs) != tclmin(100, rnum - i + 1)){
+      eprint(hdb, __LINE__, "(validation)");
+      err = true;
+    } else {
+      tcmapiterinit(recs);
+      const char *kbuf;
+      int ksiz;
+      while((kbuf = tcmapiternext(recs, &ksiz)) != NULL){
+        int vsiz;
+        const char *vbuf = tcmapiterval(kbuf, &vsiz);
+        if(vsiz != ksiz || memcmp(vbuf, kbuf, vsiz)){
+          eprint(hdb, __LINE__, "(validation)");
+          err = true;
+          break;
+        }
+      }
+    }
+    tcmapdel(recs);
+    tclistdel(keys);
+    if(rnum > 250) iputchar('.');
+  }
+  if(rnum > 250) iprintf(" (%08d)\n", rnum);
   iprintf("checking words:\n");
   for(int i = 0; words[i] != NULL; i += 2){
     const char *kbuf = words[i];
@@ -1582,6 +1747,10 @@ static int procmisc(const char *path, int rnum, bool mt, int opts, int omode){
     eprint(hdb, __LINE__, "(validation)");
     err = true;
   }
+  if(prog[1] > 0 || prog[2] < 1 || prog[0] != prog[2]){
+    eprint(hdb, __LINE__, "(validation)");
+    err = true;
+  }
   inum = 0;
   tcmapiterinit(map);
   const char *tkbuf;
@@ -1629,6 +1798,50 @@ static int procmisc(const char *path, int rnum, bool mt, int opts, int omode){
     }
   }
   if(rnum > 250) iprintf(" (%08d)\n", inum);
+  if(opts & HDBTTTL){
+    iprintf("checking expiration:\n");
+    uint64_t xrnum = tchdbrnum(hdb);
+    int xnum = rnum / 10 + 1;
+    for(int i = 1; i <= xnum; i++){
+      char xkbuf[RECBUFSIZ];
+      int xksiz = sprintf(xkbuf, "ttl:%08d", i);
+      if(!tchdbputttl(hdb, xkbuf, xksiz, xkbuf, xksiz, 2)){
+        eprint(hdb, __LINE__, "tchdbputttl");
+        err = true;
+        break;
+      }
+    }
+    if(!tchdbputttl(hdb, "ttl:keep", 8, "keep", 4, INT_MAX)){
+      eprint(hdb, __LINE__, "tchdbputttl");
+      err = true;
+    }
+    if(tchdbrnum(hdb) != xrnum + xnum + 1 || tchdbvsiz2(hdb, "ttl:00000001") != 12){
+      eprint(hdb, __LINE__, "(validation)");
+      err = true;
+    }
+    sleep(3);
+    for(int i = 1; i <= xnum; i++){
+      char xkbuf[RECBUFSIZ];
+      int xksiz = sprintf(xkbuf, "ttl:%08d", i);
+      if(tchdbvsiz(hdb, xkbuf, xksiz) >= 0 || tchdbecode(hdb) != TCENOREC){
+        eprint(hdb, __LINE__, "(validation)");
+        err = true;
+        break;
+      }
+    }
+    if(!tchdbdefrag(hdb, 0)){
+      eprint(hdb, __LINE__, "tchdbdefrag");
+      err = true;
+    }
+    if(tchdbrnum(hdb) != xrnum + 1 || tchdbvsiz2(hdb, "ttl:keep") != 4){
+      eprint(hdb, __LINE__, "(validation)");
+      err = true;
+    }
+    if(!tchdbout2(hdb, "ttl:keep")){
+      eprint(hdb, __LINE__, "tchdbout2");
+      err = true;
+    }
+  }
   tcmapdel(map);
   if(!tchdbvanish(hdb)){
     eprint(hdb, __LINE__, "tchdbvanish");
@@ -1676,6 +1889,32 @@ static int procmisc(const char *path, int rnum, bool mt, int opts, int omode){
     eprint(hdb, __LINE__, "tchdbforeach");
     err = true;
   }
+  uint64_t bounds[5];
+  if(tchdbforeachsplit(hdb, bounds, 4)){
+    uint64_t cnt = 0;
+    for(int i = 0; i < 4; i++){
+      if(bounds[i] > bounds[i+1]){
+        eprint(hdb, __LINE__, "tchdbforeachsplit");
+        err = true;
+      }
+      if(!tchdbforeachrange(hdb, bounds[i], bounds[i+1], cntfunc, &cnt)){
+        eprint(hdb, __LINE__, "tchdbforeachrange");
+        err = true;
+      }
+    }
+    if(cnt != tchdbrnum(hdb)){
+      eprint(hdb, __LINE__, "tchdbforeachrange");
+      err = true;
+    }
+  } else {
+    eprint(hdb, __LINE__, "tchdbforeachsplit");
+    err = true;
+  }
+  uint64_t fecnt = 0;
+  if(!tchdbforeach2(hdb, cntfunc, &fecnt, 4) || fecnt != tchdbrnum(hdb)){
+    eprint(hdb, __LINE__, "tchdbforeach2");
+    err = true;
+  }
   iprintf("record number: %llu\n", (unsigned long long)tchdbrnum(hdb));
   iprintf("size: %llu\n", (unsigned long long)tchdbfsiz(hdb));
   mprint(hdb);
@@ -1957,6 +2196,26 @@ static int procwicked(const char *path, int rnum, bool mt, int opts, int omode){
         eprint(nhdb, __LINE__, "tchdbopen");
         err = true;
       }
+      uint64_t nrnum = tchdbrnum(nhdb);
+      tchdbdel(nhdb);
+      unlink(npath);
+      if(!tchdbsnapshot(hdb, npath)){
+        eprint(hdb, __LINE__, "tchdbsnapshot");
+        err = true;
+      }
+      nhdb = tchdbnew();
+      if(!tchdbsetcodecfunc(nhdb, _tc_recencode, NULL, _tc_recdecode, NULL)){
+        eprint(nhdb, __LINE__, "tchdbsetcodecfunc");
+        err = true;
+      }
+      if(!tchdbopen(nhdb, npath, HDBOREADER | omode)){
+        eprint(nhdb, __LINE__, "tchdbopen");
+        err = true;
+      }
+      if(tchdbrnum(nhdb) != nrnum){
+        eprint(nhdb, __LINE__, "(validation)");
+        err = true;
+      }
       tchdbdel(nhdb);
       unlink(npath);
       tcfree(npath);
@@ -0,0 +1,543 @@
+/*************************************************************************************************
+ * The test cases of the static sorted database API
+ *                                                      Copyright (C) 2006-2009 Mikio Hirabayashi
+ * This file is part of Tokyo Cabinet.
+ * Tokyo Cabinet is free software; you can redistribute it and/or modify it under the terms of
+ * the GNU Lesser General Public License as published by the Free Software Foundation; either
+ * version 2.1 of the License or any later version.  Tokyo Cabinet is distributed in the hope
+ * that it will be useful, but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public
+ * License for more details.
+ * You should have received a copy of the GNU Lesser General Public License along with Tokyo
+ * Cabinet; if not, write to the Free Software Foundation, Inc., 59 Temple Place, Suite 330,
+ * Boston, MA 02111-1307 USA.
+ *************************************************************************************************/
+
+
+#include <tcutil.h>
+#include <tcsdb.h>
+#include "myconf.h"
+
+#define RECBUFSIZ      48                // buffer for records
+
+
+/* global variables */
+const char *g_progname;                  // program name
+unsigned int g_randseed;                 // random seed
+int g_dbgfd;                             // debugging output
+
+
+/* function prototypes */
+int main(int argc, char **argv);
+static void usage(void);
+static void iprintf(const char *format, ...);
+static void iputchar(int c);
+static void eprint(TCSDB *sdb, int line, const char *func);
+static void sysprint(void);
+static int myrand(int range);
+static bool iterfunc(const void *kbuf, int ksiz, const void *vbuf, int vsiz, void *op);
+static int runwrite(int argc, char **argv);
+static int runread(int argc, char **argv);
+static int runmisc(int argc, char **argv);
+static int procwrite(const char *path, int rnum, int bpow, bool mt, int omode);
+static int procread(const char *path, bool mt, int omode, bool rnd);
+static int procmisc(const char *path, int rnum, int bpow, bool mt, int omode);
+
+
+/* main routine */
+int main(int argc, char **argv){
+  g_progname = argv[0];
+  const char *ebuf = getenv("TCRNDSEED");
+  g_randseed = ebuf ? tcatoix(ebuf) : tctime() * 1000;
+  srand(g_randseed);
+  ebuf = getenv("TCDBGFD");
+  g_dbgfd = ebuf ? tcatoix(ebuf) : UINT16_MAX;
+  if(argc < 2) usage();
+  int rv = 0;
+  if(!strcmp(argv[1], "write")){
+    rv = runwrite(argc, argv);
+  } else if(!strcmp(argv[1], "read")){
+    rv = runread(argc, argv);
+  } else if(!strcmp(argv[1], "misc")){
+    rv = runmisc(argc, argv);
+  } else {
+    usage();
+  }
+  if(rv != 0){
+    printf("FAILED: TCRNDSEED=%u PID=%d", g_randseed, (int)getpid());
+    for(int i = 0; i < argc; i++){
+      printf(" %s", argv[i]);
+    }
+    printf("\n\n");
+  }
+  return rv;
+}
+
+
+/* print the usage and exit */
+static void usage(void){
+  fprintf(stderr, "%s: test cases of the static sorted database API of Tokyo Cabinet\n",
+          g_progname);
+  fprintf(stderr, "\n");
+  fprintf(stderr, "usage:\n");
+  fprintf(stderr, "  %s write [-mt] [-nl|-nb] path rnum [bpow]\n", g_progname);
+  fprintf(stderr, "  %s read [-mt] [-nl|-nb] [-rnd] path\n", g_progname);
+  fprintf(stderr, "  %s misc [-mt] [-nl|-nb] path rnum [bpow]\n", g_progname);
+  fprintf(stderr, "\n");
+  exit(1);
+}
+
+
+/* print formatted information string and flush the buffer */
+static void iprintf(const char *format, ...){
+  va_list ap;
+  va_start(ap, format);
+  vprintf(format, ap);
+  fflush(stdout);
+  va_end(ap);
+}
+
+
+/* print a character and flush the buffer */
+static void iputchar(int c){
+  putchar(c);
+  fflush(stdout);
+}
+
+
+/* print error message of static sorted database */
+static void eprint(TCSDB *sdb, int line, const char *func){
+  const char *path = tcsdbpath(sdb);
+  int ecode = tcsdbecode(sdb);
+  fprintf(stderr, "%s: %s: %d: %s: error: %d: %s\n",
+          g_progname, path ? path : "-", line, func, ecode, tcsdberrmsg(ecode));
+}
+
+
+/* print system information */
+static void sysprint(void){
+  TCMAP *info = tcsysinfo();
+  if(info){
+    tcmapiterinit(info);
+    const char *kbuf;
+    while((kbuf = tcmapiternext2(info)) != NULL){
+      iprintf("sys_%s: %s\n", kbuf, tcmapiterval2(kbuf));
+    }
+    tcmapdel(info);
+  }
+}
+
+
+/* get a random number */
+static int myrand(int range){
+  if(range < 2) return 0;
+  int high = (unsigned int)rand() >> 4;
+  int low = range * (rand() / (RAND_MAX + 1.0));
+  low &= (unsigned int)INT_MAX >> 4;
+  return (high + low) % range;
+}
+
+
+/* iterator function */
+static bool iterfunc(const void *kbuf, int ksiz, const void *vbuf, int vsiz, void *op){
+  unsigned int sum = 0;
+  while(--ksiz >= 0){
+    sum += ((char *)kbuf)[ksiz];
+  }
+  while(--vsiz >= 0){
+    sum += ((char *)vbuf)[vsiz];
+  }
+  (*(int *)op)++;
+  return myrand(100 + (sum & 0xff)) > 0;
+}
+
+
+/* parse arguments of write command */
+static int runwrite(int argc, char **argv){
+  char *path = NULL;
+  char *rstr = NULL;
+  char *bstr = NULL;
+  bool mt = false;
+  int omode = 0;
+  for(int i = 2; i < argc; i++){
+    if(!path && argv[i][0] == '-'){
+      if(!strcmp(argv[i], "-mt")){
+        mt = true;
+      } else if(!strcmp(argv[i], "-nl")){
+        omode |= SDBONOLCK;
+      } else if(!strcmp(argv[i], "-nb")){
+        omode |= SDBOLCKNB;
+      } else {
+        usage();
+      }
+    } else if(!path){
+      path = argv[i];
+    } else if(!rstr){
+      rstr = argv[i];
+    } else if(!bstr){
+      bstr = argv[i];
+    } else {
+      usage();
+    }
+  }
+  if(!path || !rstr) usage();
+  int rnum = tcatoix(rstr);
+  if(rnum < 1) usage();
+  int bpow = bstr ? tcatoix(bstr) : -1;
+  int rv = procwrite(path, rnum, bpow, mt, omode);
+  return rv;
+}
+
+
+/* parse arguments of read command */
+static int runread(int argc, char **argv){
+  char *path = NULL;
+  bool mt = false;
+  int omode = 0;
+  bool rnd = false;
+  for(int i = 2; i < argc; i++){
+    if(!path && argv[i][0] == '-'){
+      if(!strcmp(argv[i], "-mt")){
+        mt = true;
+      } else if(!strcmp(argv[i], "-nl")){
+        omode |= SDBONOLCK;
+      } else if(!strcmp(argv[i], "-nb")){
+        omode |= SDBOLCKNB;
+      } else if(!strcmp(argv[i], "-rnd")){
+        rnd = true;
+      } else {
+        usage();
+      }
+    } else if(!path){
+      path = argv[i];
+    } else {
+      usage();
+    }
+  }
+  if(!path) usage();
+  int rv = procread(path, mt, omode, rnd);
+  return rv;
+}
+
+
+/* parse arguments of misc command */
+static int runmisc(int argc, char **argv){
+  char *path = NULL;
+  char *rstr = NULL;
+  char *bstr = NULL;
+  bool mt = false;
+  int omode = 0;
+  for(int i = 2; i < argc; i++){
+    if(!path && argv[i][0] == '-'){
+      if(!strcmp(argv[i], "-mt")){
+        mt = true;
+      } else if(!strcmp(argv[i], "-nl")){
+        omode |= SDBONOLCK;
+      } else if(!strcmp(argv[i], "-nb")){
+        omode |= SDBOLCKNB;
+      } else {
+        usage();
+      }
+    } else if(!path){
+      path = argv[i];
+    } else if(!rstr){
+      rstr = argv[i];
+    } else if(!bstr){
+      bstr = argv[i];
+    } else {
+      usage();
+    }
+  }
+  if(!path || !rstr) usage();
+  int rnum = tcatoix(rstr);
+  if(rnum < 1) usage();
+  int bpow = bstr ? tcatoix(bstr) : -1;
+  int rv = procmisc(path, rnum, bpow, mt, omode);
+  return rv;
+}
+
+
+/* perform write command */
+static int procwrite(const char *path, int rnum, int bpow, bool mt, int omode){
+  iprintf("<Writing Test>\n  seed=%u  path=%s  rnum=%d  bpow=%d  mt=%d  omode=%d\n\n",
+          g_randseed, path, rnum, bpow, mt, omode);
+  bool err = false;
+  double stime = tctime();
+  TCSDB *sdb = tcsdbnew();
+  if(g_dbgfd >= 0) tcsdbsetdbgfd(sdb, g_dbgfd);
+  if(mt && !tcsdbsetmutex(sdb)){
+    eprint(sdb, __LINE__, "tcsdbsetmutex");
+    err = true;
+  }
+  if(!tcsdbtune(sdb, bpow)){
+    eprint(sdb, __LINE__, "tcsdbtune");
+    err = true;
+  }
+  if(!tcsdbopen(sdb, path, SDBOWRITER | SDBOCREAT | SDBOTRUNC | omode)){
+    eprint(sdb, __LINE__, "tcsdbopen");
+    err = true;
+  }
+  for(int i = 1; i <= rnum; i++){
+    char buf[RECBUFSIZ];
+    int len = sprintf(buf, "%08d", i);
+    if(!tcsdbput(sdb, buf, len, buf, len)){
+      eprint(sdb, __LINE__, "tcsdbput");
+      err = true;
+      break;
+    }
+    if(rnum > 250 && i % (rnum / 250) == 0){
+      iputchar('.');
+      if(i == rnum || i % (rnum / 10) == 0) iprintf(" (%08d)\n", i);
+    }
+  }
+  iprintf("record number: %llu\n", (unsigned long long)tcsdbrnum(sdb));
+  sysprint();
+  if(!tcsdbclose(sdb)){
+    eprint(sdb, __LINE__, "tcsdbclose");
+    err = true;
+  }
+  tcsdbdel(sdb);
+  iprintf("time: %.3f\n", tctime() - stime);
+  iprintf("%s\n\n", err ? "error" : "ok");
+  return err ? 1 : 0;
+}
+
+
+/* perform read command */
+static int procread(const char *path, bool mt, int omode, bool rnd){
+  iprintf("<Reading Test>\n  seed=%u  path=%s  mt=%d  omode=%d  rnd=%d\n\n",
+          g_randseed, path, mt, omode, rnd);
+  bool err = false;
+  double stime = tctime();
+  TCSDB *sdb = tcsdbnew();
+  if(g_dbgfd >= 0) tcsdbsetdbgfd(sdb, g_dbgfd);
+  if(mt && !tcsdbsetmutex(sdb)){
+    eprint(sdb, __LINE__, "tcsdbsetmutex");
+    err = true;
+  }
+  if(!tcsdbopen(sdb, path, SDBOREADER | omode)){
+    eprint(sdb, __LINE__, "tcsdbopen");
+    err = true;
+  }
+  int rnum = tcsdbrnum(sdb);
+  for(int i = 1; i <= rnum; i++){
+    char kbuf[RECBUFSIZ];
+    int ksiz = sprintf(kbuf, "%08d", rnd ? myrand(rnum) + 1 : i);
+    int vsiz;
+    char *vbuf = tcsdbget(sdb, kbuf, ksiz, &vsiz);
+    if(!vbuf){
+      eprint(sdb, __LINE__, "tcsdbget");
+      err = true;
+      break;
+    } else if(vsiz != ksiz || memcmp(vbuf, kbuf, ksiz)){
+      eprint(sdb, __LINE__, "(validation)");
+      err = true;
+      tcfree(vbuf);
+      break;
+    }
+    tcfree(vbuf);
+    if(rnum > 250 && i % (rnum / 250) == 0){
+      iputchar('.');
+      if(i == rnum || i % (rnum / 10) == 0) iprintf(" (%08d)\n", i);
+    }
+  }
+  iprintf("record number: %llu\n", (unsigned long long)tcsdbrnum(sdb));
+  iprintf("block number: %llu\n", (unsigned long long)tcsdbbnum(sdb));
+  iprintf("size: %llu\n", (unsigned long long)tcsdbfsiz(sdb));
+  sysprint();
+  if(!tcsdbclose(sdb)){
+    eprint(sdb, __LINE__, "tcsdbclose");
+    err = true;
+  }
+  tcsdbdel(sdb);
+  iprintf("time: %.3f\n", tctime() - stime);
+  iprintf("%s\n\n", err ? "error" : "ok");
+  return err ? 1 : 0;
+}
+
+
+/* perform misc command */
+static int procmisc(const char *path, int rnum, int bpow, bool mt, int omode){
+  iprintf("<Miscellaneous Test>\n  seed=%u  path=%s  rnum=%d  bpow=%d  mt=%d  omode=%d\n\n",
+          g_randseed, path, rnum, bpow, mt, omode);
+  bool err = false;
+  double stime = tctime();
+  TCSDB *sdb = tcsdbnew();
+  if(g_dbgfd >= 0) tcsdbsetdbgfd(sdb, g_dbgfd);
+  if(mt && !tcsdbsetmutex(sdb)){
+    eprint(sdb, __LINE__, "tcsdbsetmutex");
+    err = true;
+  }
+  if(!tcsdbtune(sdb, bpow)){
+    eprint(sdb, __LINE__, "tcsdbtune");
+    err = true;
+  }
+  if(!tcsdbopen(sdb, path, SDBOWRITER | SDBOCREAT | SDBOTRUNC | omode)){
+    eprint(sdb, __LINE__, "tcsdbopen");
+    err = true;
+  }
+  iprintf("writing:\n");
+  TCMAP *map = tcmapnew2(rnum / 2 + 1);
+  for(int i = 1; i <= rnum; i++){
+    char kbuf[RECBUFSIZ];
+    int ksiz = sprintf(kbuf, "%08d", i * 2);
+    int vsiz = myrand(100) == 0 ? myrand(tcsdbbsiz(sdb) * 3) : myrand(RECBUFSIZ);
+    char *vbuf = tcmalloc(vsiz + 1);
+    for(int j = 0; j < vsiz; j++){
+      vbuf[j] = 'a' + (i + j) % 26;
+    }
+    if(!tcsdbput(sdb, kbuf, ksiz, vbuf, vsiz)){
+      eprint(sdb, __LINE__, "tcsdbput");
+      err = true;
+      tcfree(vbuf);
+      break;
+    }
+    tcmapput(map, kbuf, ksiz, vbuf, vsiz);
+    tcfree(vbuf);
+    if(i == rnum / 2 && !err){
+      if(tcsdbput2(sdb, kbuf, "dup") || tcsdbecode(sdb) != TCEKEEP){
+        eprint(sdb, __LINE__, "tcsdbput2");
+        err = true;
+      }
+      if(tcsdbput2(sdb, "00000000", "back") || tcsdbecode(sdb) != TCEINVALID){
+        eprint(sdb, __LINE__, "tcsdbput2");
+        err = true;
+      }
+    }
+    if(rnum > 250 && i % (rnum / 250) == 0){
+      iputchar('.');
+      if(i == rnum || i % (rnum / 10) == 0) iprintf(" (%08d)\n", i);
+    }
+  }
+  if(!tcsdbclose(sdb)){
+    eprint(sdb, __LINE__, "tcsdbclose");
+    err = true;
+  }
+  if(!tcsdbopen(sdb, path, SDBOREADER | omode)){
+    eprint(sdb, __LINE__, "tcsdbopen");
+    err = true;
+  }
+  if(tcsdbrnum(sdb) != rnum){
+    eprint(sdb, __LINE__, "tcsdbrnum");
+    err = true;
+  }
+  iprintf("checking records:\n");
+  for(int i = 1; i <= rnum; i++){
+    char kbuf[RECBUFSIZ];
+    int ksiz = sprintf(kbuf, "%08d", myrand(rnum * 2 + 2));
+    int vsiz;
+    char *vbuf = tcsdbget(sdb, kbuf, ksiz, &vsiz);
+    int esiz;
+    const char *ebuf = tcmapget(map, kbuf, ksiz, &esiz);
+    if(ebuf){
+      if(!vbuf || vsiz != esiz || memcmp(vbuf, ebuf, esiz)){
+        eprint(sdb, __LINE__, "tcsdbget");
+        err = true;
+      }
+      if(tcsdbvsiz(sdb, kbuf, ksiz) != esiz){
+        eprint(sdb, __LINE__, "tcsdbvsiz");
+        err = true;
+      }
+    } else if(vbuf || tcsdbecode(sdb) != TCENOREC){
+      eprint(sdb, __LINE__, "tcsdbget");
+      err = true;
+    }
+    tcfree(vbuf);
+    if(err) break;
+    if(rnum > 250 && i % (rnum / 250) == 0){
+      iputchar('.');
+      if(i == rnum || i % (rnum / 10) == 0) iprintf(" (%08d)\n", i);
+    }
+  }
+  iprintf("checking iterator:\n");
+  if(!tcsdbiterinit(sdb)){
+    eprint(sdb, __LINE__, "tcsdbiterinit");
+    err = true;
+  }
+  TCXSTR *kxstr = tcxstrnew();
+  TCXSTR *vxstr = tcxstrnew();
+  int inum = 0;
+  while(tcsdbiternext3(sdb, kxstr, vxstr)){
+    inum++;
+    char kbuf[RECBUFSIZ];
+    int ksiz = sprintf(kbuf, "%08d", inum * 2);
+    int esiz;
+    const char *ebuf = tcmapget(map, kbuf, ksiz, &esiz);
+    if(tcxstrsize(kxstr) != ksiz || memcmp(tcxstrptr(kxstr), kbuf, ksiz) ||
+       !ebuf || tcxstrsize(vxstr) != esiz || memcmp(tcxstrptr(vxstr), ebuf, esiz)){
+      eprint(sdb, __LINE__, "tcsdbiternext3");
+      err = true;
+      break;
+    }
+  }
+  if(inum != rnum){
+    eprint(sdb, __LINE__, "tcsdbiternext3");
+    err = true;
+  }
+  tcxstrdel(vxstr);
+  tcxstrdel(kxstr);
+  iprintf("checking jump:\n");
+  for(int i = 1; i <= rnum / 10 + 1 && !err; i++){
+    int id = myrand(rnum * 2) + 1;
+    char kbuf[RECBUFSIZ];
+    int ksiz = sprintf(kbuf, "%08d", id);
+    if(!tcsdbiterinit2(sdb, kbuf, ksiz)){
+      if(id <= rnum * 2){
+        eprint(sdb, __LINE__, "tcsdbiterinit2");
+        err = true;
+      }
+      continue;
+    }
+    char *nkey = tcsdbiternext2(sdb);
+    int nid = (id + 1) / 2 * 2;
+    if(!nkey || tcatoi(nkey) != nid){
+      eprint(sdb, __LINE__, "tcsdbiternext2");
+      err = true;
+    }
+    tcfree(nkey);
+  }
+  iprintf("checking range:\n");
+  TCLIST *keys = tcsdbrange(sdb, "00000002", 8, false, "00000010", 8, true, -1);
+  if(tclistnum(keys) != tclmin(4, rnum - 1)){
+    eprint(sdb, __LINE__, "tcsdbrange");
+    err = true;
+  }
+  tclistdel(keys);
+  keys = tcsdbrange(sdb, NULL, 0, true, NULL, 0, true, 5);
+  if(tclistnum(keys) != tclmin(5, rnum)){
+    eprint(sdb, __LINE__, "tcsdbrange");
+    err = true;
+  }
+  tclistdel(keys);
+  iprintf("checking traversal:\n");
+  inum = 0;
+  if(!tcsdbforeach(sdb, iterfunc, &inum)){
+    eprint(sdb, __LINE__, "tcsdbforeach");
+    err = true;
+  }
+  if(inum < 1 || inum > rnum){
+    eprint(sdb, __LINE__, "tcsdbforeach");
+    err = true;
+  }
+  if(tcsdbput2(sdb, "99999999", "reader") || tcsdbecode(sdb) != TCEINVALID){
+    eprint(sdb, __LINE__, "tcsdbput2");
+    err = true;
+  }
+  iprintf("record number: %llu\n", (unsigned long long)tcsdbrnum(sdb));
+  iprintf("block number: %llu\n", (unsigned long long)tcsdbbnum(sdb));
+  iprintf("size: %llu\n", (unsigned long long)tcsdbfsiz(sdb));
+  sysprint();
+  tcmapdel(map);
+  if(!tcsdbclose(sdb)){
+    eprint(sdb, __LINE__, "tcsdbclose");
+    err = true;
+  }
+  tcsdbdel(sdb);
+  iprintf("time: %.3f\n", tctime() - stime);
+  iprintf("%s\n\n", err ? "error" : "ok");
+  return err ? 1 : 0;
+}
+
+
+
+// END OF FILE
@@ -240,6 +240,7 @@ bool tctdbtune(TCTDB *tdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts)
   if(opts & TDBTDEFLATE) hopts |= HDBTDEFLATE;
   if(opts & TDBTBZIP) hopts |= HDBTBZIP;
   if(opts & TDBTTCBS) hopts |= HDBTTCBS;
+  if(opts & TDBTFAST) hopts |= HDBTFAST;
   if(opts & TDBTEXCODEC) hopts |= HDBTEXCODEC;
   bnum = (bnum > 0) ? bnum : TDBDEFBNUM;
   apow = (apow >= 0) ? apow : TDBDEFAPOW;
@@ -283,6 +284,17 @@ bool tctdbsetdfunit(TCTDB *tdb, int32_t dfunit){
 }
 
 
+/* Set the Bloom filter of a table database object. */
+bool tctdbsetbloom(TCTDB *tdb, int64_t bfnum){
+  assert(tdb);
+  if(tdb->open){
+    tctdbsetecode(tdb, TCEINVALID, __FILE__, __LINE__, __func__);
+    return false;
+  }
+  return tchdbsetbloom(tdb->hdb, bfnum);
+}
+
+
 /* Open a database file and connect a table database object. */
 bool tctdbopen(TCTDB *tdb, const char *path, int omode){
   assert(tdb && path);
@@ -1984,6 +1996,7 @@ static bool tctdbopenimpl(TCTDB *tdb, const char *path, int omode){
   if(hopts & HDBTDEFLATE) opts |= TDBTDEFLATE;
   if(hopts & HDBTBZIP) opts |= TDBTBZIP;
   if(hopts & HDBTTCBS) opts |= TDBTTCBS;
+  if(hopts & HDBTFAST) opts |= TDBTFAST;
   if(hopts & HDBTEXCODEC) opts |= TDBTEXCODEC;
   tdb->opts = opts;
   tdb->tran = false;
@@ -2254,6 +2267,7 @@ static bool tctdboptimizeimpl(TCTDB *tdb, int64_t bnum, int8_t apow, int8_t fpow
   if(opts & TDBTDEFLATE) hopts |= HDBTDEFLATE;
   if(opts & TDBTBZIP) hopts |= HDBTBZIP;
   if(opts & TDBTTCBS) hopts |= HDBTTCBS;
+  if(opts & TDBTFAST) hopts |= HDBTFAST;
   if(opts & TDBTEXCODEC) hopts |= HDBTEXCODEC;
   tchdbtune(thdb, bnum, apow, fpow, hopts);
   if(tchdbopen(thdb, tpath, HDBOWRITER | HDBOCREAT | HDBOTRUNC)){
@@ -2625,6 +2639,7 @@ static bool tctdbsetindeximpl(TCTDB *tdb, const char *name, int type){
   if(opts & TDBTDEFLATE) bopts |= BDBTDEFLATE;
   if(opts & TDBTBZIP) bopts |= BDBTBZIP;
   if(opts & TDBTTCBS) bopts |= BDBTTCBS;
+  if(opts & TDBTFAST) bopts |= BDBTFAST;
   if(opts & TDBTEXCODEC) bopts |= BDBTEXCODEC;
   switch(type){
   case TDBITLEXICAL:
@@ -70,7 +70,8 @@ enum {                                   /* enumeration for tuning options */
   TDBTDEFLATE = 1 << 1,                  /* compress each page with Deflate */
   TDBTBZIP = 1 << 2,                     /* compress each record with BZIP2 */
   TDBTTCBS = 1 << 3,                     /* compress each page with TCBS */
-  TDBTEXCODEC = 1 << 4                   /* compress each record with outer functions */
+  TDBTEXCODEC = 1 << 4,                  /* compress each record with outer functions */
+  TDBTFAST = 1 << 5                      /* compress each page with LZ */
 };
 
 enum {                                   /* enumeration for open modes */
@@ -225,7 +226,8 @@ bool tctdbsetmutex(TCTDB *tdb);
    `opts' specifies options by bitwise-or: `TDBTLARGE' specifies that the size of the database
    can be larger than 2GB by using 64-bit bucket array, `TDBTDEFLATE' specifies that each record
    is compressed with Deflate encoding, `TDBTBZIP' specifies that each record is compressed with
-   BZIP2 encoding, `TDBTTCBS' specifies that each record is compressed with TCBS encoding.
+   BZIP2 encoding, `TDBTTCBS' specifies that each record is compressed with TCBS encoding,
+   `TDBTFAST' specifies that each record is compressed with LZ encoding.
    If successful, the return value is true, else, it is false.
    Note that the tuning parameters should be set before the database is opened. */
 bool tctdbtune(TCTDB *tdb, int64_t bnum, int8_t apow, int8_t fpow, uint8_t opts);
@@ -263,6 +265,16 @@ bool tctdbsetxmsiz(TCTDB *tdb, int64_t xmsiz);
 bool tctdbsetdfunit(TCTDB *tdb, int32_t dfunit);
 
 
+/* Set the Bloom filter of a table database object.
+   `tdb' specifies the table database object which is not opened.
+   `bfnum' specifies the expected number of records.  If it is not more than 0, the Bloom filter
+   is disabled.  It is disabled by default.
+   If successful, the return value is true, else, it is false.
+   The filter answers lookups of missing primary keys without reading the database file.  See
+   `tchdbsetbloom' of the hash database API for details. */
+bool tctdbsetbloom(TCTDB *tdb, int64_t bfnum);
+
+
 /* Open a database file and connect a table database object.
    `tdb' specifies the table database object which is not opened.
    `path' specifies the path of the database file.
@@ -568,8 +580,9 @@ bool tctdbsync(TCTDB *tdb);
    `opts' specifies options by bitwise-or: `BDBTLARGE' specifies that the size of the database
    can be larger than 2GB by using 64-bit bucket array, `BDBTDEFLATE' specifies that each record
    is compressed with Deflate encoding, `BDBTBZIP' specifies that each record is compressed with
-   BZIP2 encoding, `BDBTTCBS' specifies that each record is compressed with TCBS encoding.  If it
-   is `UINT8_MAX', the current setting is not changed.
+   BZIP2 encoding, `BDBTTCBS' specifies that each record is compressed with TCBS encoding,
+   `TDBTFAST' specifies that each record is compressed with LZ encoding.  If it is `UINT8_MAX',
+   the current setting is not changed.
    If successful, the return value is true, else, it is false.
    This function is useful to reduce the size of the database file with data fragmentation by
    successive updating. */
@@ -100,7 +100,8 @@ static void usage(void){
   fprintf(stderr, "%s: the command line utility of the table database API\n", g_progname);
   fprintf(stderr, "\n");
   fprintf(stderr, "usage:\n");
-  fprintf(stderr, "  %s create [-tl] [-td|-tb|-tt|-tx] path [bnum [apow [fpow]]]\n", g_progname);
+  fprintf(stderr, "  %s create [-tl] [-td|-tb|-tt|-tf|-tx] path [bnum [apow [fpow]]]\n",
+          g_progname);
   fprintf(stderr, "  %s inform [-nl|-nb] path\n", g_progname);
   fprintf(stderr, "  %s put [-nl|-nb] [-sx] [-dk|-dc|-dai|-dad] path pkey [cols...]\n",
           g_progname);
@@ -109,7 +110,7 @@ static void usage(void){
   fprintf(stderr, "  %s list [-nl|-nb] [-m num] [-pv] [-px] [-fm str] path\n", g_progname);
   fprintf(stderr, "  %s search [-nl|-nb] [-ord name type] [-m num] [-sk num] [-kw] [-pv] [-px]"
           " [-ph] [-bt num] [-rm] [-ms type] path [name op expr ...]\n", g_progname);
-  fprintf(stderr, "  %s optimize [-tl] [-td|-tb|-tt|-tx] [-tz] [-nl|-nb] [-df]"
+  fprintf(stderr, "  %s optimize [-tl] [-td|-tb|-tt|-tf|-tx] [-tz] [-nl|-nb] [-df]"
           " path [bnum [apow [fpow]]]\n", g_progname);
   fprintf(stderr, "  %s setindex [-nl|-nb] [-it type] path name\n", g_progname);
   fprintf(stderr, "  %s importtsv [-nl|-nb] [-sc] path [file]\n", g_progname);
@@ -192,6 +193,8 @@ static int runcreate(int argc, char **argv){
         opts |= TDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= TDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= TDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= TDBTEXCODEC;
       } else {
@@ -715,6 +718,7 @@ static int procinform(const char *path, int omode){
   if(opts & TDBTDEFLATE) printf(" deflate");
   if(opts & TDBTBZIP) printf(" bzip");
   if(opts & TDBTTCBS) printf(" tcbs");
+  if(opts & TDBTFAST) printf(" fast");
   if(opts & TDBTEXCODEC) printf(" excodec");
   printf("\n");
   printf("record number: %llu\n", (unsigned long long)tctdbrnum(tdb));
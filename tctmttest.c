@@ -132,15 +132,15 @@ static void usage(void){
   fprintf(stderr, "%s: test cases of the table database API of Tokyo Cabinet\n", g_progname);
   fprintf(stderr, "\n");
   fprintf(stderr, "usage:\n");
-  fprintf(stderr, "  %s write [-tl] [-td|-tb|-tt|-tx] [-rc num] [-lc num] [-nc num]"
+  fprintf(stderr, "  %s write [-tl] [-td|-tb|-tt|-tf|-tx] [-rc num] [-lc num] [-nc num]"
           " [-xm num] [-df num] [-ip] [-is] [-in] [-it] [-if] [-ix] [-nl|-nb] [-rnd]"
           " path tnum rnum [bnum [apow [fpow]]]\n", g_progname);
   fprintf(stderr, "  %s read [-rc num] [-lc num] [-nc num] [-xm num] [-df num] [-nl|-nb] [-rnd]"
           " path tnum\n", g_progname);
   fprintf(stderr, "  %s remove [-rc num] [-lc num] [-nc num] [-xm num] [-df num]"
           " [-nl|-nb] [-rnd] path tnum\n", g_progname);
-  fprintf(stderr, "  %s wicked [-tl] [-td|-tb|-tt|-tx] [-nl|-nb] path tnum rnum\n", g_progname);
-  fprintf(stderr, "  %s typical [-tl] [-td|-tb|-tt|-tx] [-rc num] [-lc num] [-nc num]"
+  fprintf(stderr, "  %s wicked [-tl] [-td|-tb|-tt|-tf|-tx] [-nl|-nb] path tnum rnum\n", g_progname);
+  fprintf(stderr, "  %s typical [-tl] [-td|-tb|-tt|-tf|-tx] [-rc num] [-lc num] [-nc num]"
           " [-xm num] [-df num] [-nl|-nb] [-rr num] path tnum rnum [bnum [apow [fpow]]]\n",
           g_progname);
   fprintf(stderr, "\n");
@@ -232,6 +232,8 @@ static int runwrite(int argc, char **argv){
         opts |= TDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= TDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= TDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= TDBTEXCODEC;
       } else if(!strcmp(argv[i], "-rc")){
@@ -422,6 +424,8 @@ static int runwicked(int argc, char **argv){
         opts |= TDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= TDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= TDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= TDBTEXCODEC;
       } else if(!strcmp(argv[i], "-nl")){
@@ -476,6 +480,8 @@ static int runtypical(int argc, char **argv){
         opts |= TDBTBZIP;
       } else if(!strcmp(argv[i], "-tt")){
         opts |= TDBTTCBS;
+      } else if(!strcmp(argv[i], "-tf")){
+        opts |= TDBTFAST;
       } else if(!strcmp(argv[i], "-tx")){
         opts |= TDBTEXCODEC;
       } else if(!strcmp(argv[i], "-rc")){
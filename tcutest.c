@@ -1119,6 +1119,11 @@ static int procmisc(int rnum){
     if(dsiz != slen || strcmp(dec, str)) err = true;
     tcfree(dec);
     tcfree(buf);
+    buf = tclzencode(str, slen, &bsiz);
+    dec = tclzdecode(buf, bsiz, &dsiz);
+    if(!dec || dsiz != slen || strcmp(dec, str)) err = true;
+    tcfree(dec);
+    tcfree(buf);
     int idx;
     buf = tcbwtencode(str, slen, &idx);
     if(memcmp(buf, "4\"o 5a23s-%+=> 1b/\"<&YNe", slen) || idx != 13) err = true;
@@ -9456,6 +9456,12 @@ void tcptrlistclear(TCPTRLIST *ptrlist){
 #define TCBWTCNTMIN    64               // minimum element number of counting sort
 #define TCBWTCNTLV     4                // maximum recursion level of counting sort
 #define TCBWTBUFNUM    16384            // number of elements of BWT buffer
+#define TCLZHASHBITS   14               // bit width of the hash table of LZ encoding
+#define TCLZMINMATCH   4                // minimum length of a match of LZ encoding
+#define TCLZMAXDIST    65535            // maximum distance of a match of LZ encoding
+#define TCLZLASTLIT    5                // number of trailing bytes kept as literals
+#define TCLZSKIPTRIG   6                // bit shift of skipping incompressible data
+#define TCLZWILDSIZ    8                // unit size of copying a match of LZ decoding
 
 typedef struct {                         // type of structure for a BWT character
   int fchr;                              // character code of the first character
@@ -9891,6 +9897,196 @@ char *tcbsdecode(const char *ptr, int size, int *sp){
   return result;
 }
 
+/* Compress a serial object with LZ encoding. */
+char *tclzencode(const char *ptr, int size, int *sp){
+  assert(ptr && size >= 0 && sp);
+  char *result;
+  TCMALLOC(result, size + size / 255 + 16);
+  unsigned char *wp = (unsigned char *)result;
+  int step;
+  TCSETVNUMBUF(step, wp, size);
+  wp += step;
+  const unsigned char *base = (unsigned char *)ptr;
+  const unsigned char *end = base + size;
+  const unsigned char *rp = base;
+  const unsigned char *lit = base;
+  if(size > TCLZLASTLIT + TCLZMINMATCH){
+    const unsigned char *limit = end - TCLZLASTLIT - TCLZMINMATCH;
+    const unsigned char *mlimit = end - TCLZLASTLIT;
+    uint32_t table[1<<TCLZHASHBITS];
+    memset(table, 0, sizeof(table));
+    rp++;
+    while(rp < limit){
+      uint32_t seq;
+      memcpy(&seq, rp, sizeof(seq));
+      uint32_t hash = (seq * 2654435761U) >> (32 - TCLZHASHBITS);
+      const unsigned char *cp = base + table[hash];
+      table[hash] = rp - base;
+      uint32_t cseq;
+      memcpy(&cseq, cp, sizeof(cseq));
+      if(cp >= rp || rp - cp > TCLZMAXDIST || cseq != seq){
+        rp += 1 + ((rp - lit) >> TCLZSKIPTRIG);
+        continue;
+      }
+      while(rp > lit && cp > base && rp[-1] == cp[-1]){
+        rp--;
+        cp--;
+      }
+      const unsigned char *mp = rp + TCLZMINMATCH;
+      const unsigned char *cq = cp + TCLZMINMATCH;
+      while(mp + sizeof(uint64_t) <= mlimit){
+        uint64_t mw, cw;
+        memcpy(&mw, mp, sizeof(mw));
+        memcpy(&cw, cq, sizeof(cw));
+        if(mw != cw) break;
+        mp += sizeof(mw);
+        cq += sizeof(cw);
+      }
+      while(mp < mlimit && *mp == *cq){
+        mp++;
+        cq++;
+      }
+      int llen = rp - lit;
+      int mlen = mp - rp - TCLZMINMATCH;
+      unsigned char *tp = wp++;
+      *tp = ((llen < 15 ? llen : 15) << 4) | (mlen < 15 ? mlen : 15);
+      if(llen >= 15){
+        int num = llen - 15;
+        while(num >= 255){
+          *(wp++) = 255;
+          num -= 255;
+        }
+        *(wp++) = num;
+      }
+      memcpy(wp, lit, llen);
+      wp += llen;
+      int dist = rp - cp;
+      *(wp++) = dist & 0xff;
+      *(wp++) = dist >> 8;
+      if(mlen >= 15){
+        int num = mlen - 15;
+        while(num >= 255){
+          *(wp++) = 255;
+          num -= 255;
+        }
+        *(wp++) = num;
+      }
+      if(mp - 2 > rp){
+        memcpy(&seq, mp - 2, sizeof(seq));
+        table[(seq*2654435761U)>>(32-TCLZHASHBITS)] = mp - 2 - base;
+      }
+      rp = mp;
+      lit = rp;
+    }
+  }
+  int llen = end - lit;
+  *(wp++) = (llen < 15 ? llen : 15) << 4;
+  if(llen >= 15){
+    int num = llen - 15;
+    while(num >= 255){
+      *(wp++) = 255;
+      num -= 255;
+    }
+    *(wp++) = num;
+  }
+  memcpy(wp, lit, llen);
+  wp += llen;
+  *sp = wp - (unsigned char *)result;
+  return result;
+}
+
+
+/* Decompress a serial object compressed with LZ encoding. */
+char *tclzdecode(const char *ptr, int size, int *sp){
+  assert(ptr && size >= 0 && sp);
+  const unsigned char *rp = (unsigned char *)ptr;
+  const unsigned char *end = rp + size;
+  int vlen = 0;
+  while(vlen < size && vlen < (int)sizeof(int) && ((signed char *)rp)[vlen] < 0){
+    vlen++;
+  }
+  if(vlen >= size || ((signed char *)rp)[vlen] < 0) return NULL;
+  int osiz, step;
+  TCREADVNUMBUF(rp, osiz, step);
+  if(osiz < 0 || osiz > (int64_t)size * 256) return NULL;
+  rp += step;
+  char *result;
+  TCMALLOC(result, osiz + TCLZWILDSIZ + 1);
+  unsigned char *wp = (unsigned char *)result;
+  unsigned char *wend = wp + osiz;
+  bool err = false;
+  while(rp < end){
+    int token = *(rp++);
+    int llen = token >> 4;
+    if(llen == 15){
+      int c;
+      do {
+        if(rp >= end || llen > osiz){
+          err = true;
+          break;
+        }
+        c = *(rp++);
+        llen += c;
+      } while(c == 255);
+      if(err) break;
+    }
+    if(llen > end - rp || llen > wend - wp){
+      err = true;
+      break;
+    }
+    memcpy(wp, rp, llen);
+    wp += llen;
+    rp += llen;
+    if(rp >= end) break;
+    if(end - rp < 2){
+      err = true;
+      break;
+    }
+    int dist = rp[0] | (rp[1] << 8);
+    rp += 2;
+    int mlen = token & 0xf;
+    if(mlen == 15){
+      int c;
+      do {
+        if(rp >= end || mlen > osiz){
+          err = true;
+          break;
+        }
+        c = *(rp++);
+        mlen += c;
+      } while(c == 255);
+      if(err) break;
+    }
+    mlen += TCLZMINMATCH;
+    if(dist < 1 || dist > wp - (unsigned char *)result || mlen > wend - wp){
+      err = true;
+      break;
+    }
+    const unsigned char *cp = wp - dist;
+    if(dist >= TCLZWILDSIZ){
+      unsigned char *mend = wp + mlen;
+      do {
+        memcpy(wp, cp, TCLZWILDSIZ);
+        wp += TCLZWILDSIZ;
+        cp += TCLZWILDSIZ;
+      } while(wp < mend);
+      wp = mend;
+    } else {
+      while(mlen-- > 0){
+        *(wp++) = *(cp++);
+      }
+    }
+  }
+  if(err || wp != wend){
+    TCFREE(result);
+    return NULL;
+  }
+  *wp = '\0';
+  *sp = osiz;
+  return result;
+}
+
+
 
 /* Encode a serial object with BWT encoding. */
 char *tcbwtencode(const char *ptr, int size, int *idxp){
@@ -3136,6 +3136,31 @@ char *tcbsencode(const char *ptr, int size, int *sp);
 char *tcbsdecode(const char *ptr, int size, int *sp);
 
 
+/* Compress a serial object with LZ encoding.
+   `ptr' specifies the pointer to the region.
+   `size' specifies the size of the region.
+   `sp' specifies the pointer to the variable into which the size of the region of the return
+   value is assigned.
+   If successful, the return value is the pointer to the result object, else, it is `NULL'.
+   LZ encoding trades the compression ratio for speed, which is suitable for data frequently
+   accessed.  Because the region of the return value is allocated with the `malloc' call, it
+   should be released with the `free' call when it is no longer in use. */
+char *tclzencode(const char *ptr, int size, int *sp);
+
+
+/* Decompress a serial object compressed with LZ encoding.
+   `ptr' specifies the pointer to the region.
+   `size' specifies the size of the region.
+   `sp' specifies the pointer to a variable into which the size of the region of the return
+   value is assigned.
+   If successful, the return value is the pointer to the result object, else, it is `NULL'.
+   Because an additional zero code is appended at the end of the region of the return value,
+   the return value can be treated as a character string.  Because the region of the return
+   value is allocated with the `malloc' call, it should be released with the `free' call when it
+   is no longer in use. */
+char *tclzdecode(const char *ptr, int size, int *sp);
+
+
 /* Compress a serial object with Deflate encoding.
    `ptr' specifies the pointer to the region.
    `size' specifies the size of the region.
@@ -3713,7 +3738,8 @@ enum {                                   /* enumeration for database type */
   TCDBTBTREE,                            /* B+ tree */
   TCDBTDSAT,							 /* Dynamic spatial approximation tree */
   TCDBTFIXED,                            /* fixed-length */
-  TCDBTTABLE                             /* table */
+  TCDBTTABLE,                            /* table */
+  TCDBTSTATIC                            /* static sorted */
 };
 
 